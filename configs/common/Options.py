@@ -194,6 +194,27 @@ def addCommonOptions(parser):
     parser.add_option("-F", "--fast-forward", action="store", type="string",
         default=None,
         help="Number of instructions to fast forward before switching")
+    # Sampled simulation
+    parser.add_option("--sample-length", type="int", default=None,
+        help="""Sample the workload, switching between the atomic CPU
+                and --cpu-type to measure <N> instructions per sample""")
+    parser.add_option("--sample-interval", type="int", default=1000000,
+        help="Instructions of functional warming between samples")
+    parser.add_option("--sample-warmup", type="int", default=2000,
+        help="Instructions of detailed warmup before every sample")
+    parser.add_option("--sample-max", type="int", default=0,
+        help="Number of samples to take (0 = until the workload ends)")
+    parser.add_option("--sample-error", type="float", default=0.0,
+        help="""Stop sampling once the IPC is known within this relative
+                error at 95% confidence""")
+    parser.add_option("--sample-kvm", action="store_true", default=False,
+        help="""Fast-forward between samples with the KVM CPU instead of
+                warming the caches with the atomic CPU""")
+    parser.add_option("--sample-warm-caches", action="store_true",
+        default=False,
+        help="""Bypass the caches between samples (with KVM or the
+                atomic CPU in fastmem mode) and warm them from a trace
+                of the accesses before every sample""")
     parser.add_option("-S", "--simpoint", action="store_true", default=False,
         help="""Use workload simpoints as an instruction offset for
                 --checkpoint-restore or --take-checkpoint.""")
@@ -78,10 +78,13 @@ def setCPUClass(options):
         if options.restore_with_cpu != options.cpu_type:
             CPUClass = TmpClass
             TmpClass, test_mem_mode = getCPUClass(options.restore_with_cpu)
-    elif options.fast_forward:
+    elif options.fast_forward or options.sample_length:
         CPUClass = TmpClass
-        TmpClass = AtomicSimpleCPU
-        test_mem_mode = 'atomic'
+        if options.sample_kvm:
+            TmpClass, test_mem_mode = getCPUClass('kvm')
+        else:
+            TmpClass = AtomicSimpleCPU
+            test_mem_mode = 'atomic'
 
     return (TmpClass, test_mem_mode, CPUClass)
 
@@ -257,6 +260,17 @@ def repeatSwitch(testsys, repeat_switch_cpu_list, maxtick, switch_freq):
             exit_event = m5.simulate(maxtick - m5.curTick())
             return exit_event
 
+def sampleWorkload(testsys, options, maxtick):
+    if options.fast_forward:
+        print "Fast forwarding %s instructions" % options.fast_forward
+        exit_event = m5.simulate(maxtick - m5.curTick())
+        if exit_event.getCause() != \
+                "a thread reached the max instruction count":
+            return exit_event
+
+    print "starting sampling"
+    return m5.sampling.run(testsys.sampler, maxtick)
+
 def run(options, root, testsys, cpu_class):
     if options.checkpoint_dir:
         cptdir = options.checkpoint_dir
@@ -277,6 +291,14 @@ def run(options, root, testsys, cpu_class):
     if options.repeat_switch and options.take_checkpoints:
         fatal("Can't specify both --repeat-switch and --take-checkpoints")
 
+    if options.sample_length:
+        if not options.caches:
+            fatal("Must specify --caches when using --sample-length")
+        if options.standard_switch or options.repeat_switch or \
+                options.take_checkpoints:
+            fatal("Can't specify --sample-length with --standard-switch, "
+                  "--repeat-switch or --take-checkpoints")
+
     np = options.num_cpus
     switch_cpus = None
 
@@ -389,6 +411,32 @@ def run(options, root, testsys, cpu_class):
         switch_cpu_list = [(testsys.cpu[i], switch_cpus[i]) for i in xrange(np)]
         switch_cpu_list1 = [(switch_cpus[i], switch_cpus_1[i]) for i in xrange(np)]
 
+    if options.sample_length:
+        if not switch_cpus:
+            fatal("--sample-length needs a --cpu-type other than the "
+                  "--restore-with-cpu")
+        testsys.sampler = SamplingController(
+            functional_cpus = testsys.cpu, detailed_cpus = switch_cpus,
+            functional_insts = options.sample_interval,
+            warmup_insts = options.sample_warmup,
+            measure_insts = options.sample_length,
+            max_samples = options.sample_max,
+            target_error = options.sample_error)
+
+        if options.sample_warm_caches:
+            warmer = CacheWarmer(cpus = testsys.cpu,
+                icaches = [cpu.icache for cpu in testsys.cpu],
+                dcaches = [cpu.dcache for cpu in testsys.cpu])
+            if options.l2cache:
+                warmer.shared_caches = [testsys.l2]
+            if options.sample_kvm:
+                testsys.vm.warmer = warmer
+            else:
+                for cpu in testsys.cpu:
+                    cpu.fastmem = True
+            testsys.cache_warmer = warmer
+            testsys.sampler.warmer = warmer
+
     # set the checkpoint in the cpu before m5.instantiate is called
     if options.take_checkpoints != None and \
            (options.simpoint or options.at_instruction):
@@ -449,7 +497,7 @@ def run(options, root, testsys, cpu_class):
         fatal("Bad maxtick (%d) specified: " \
               "Checkpoint starts starts from tick: %d", maxtick, cpt_starttick)
 
-    if options.standard_switch or cpu_class:
+    if (options.standard_switch or cpu_class) and not options.sample_length:
         if options.standard_switch:
             print "Switch at instruction count:%s" % \
                     str(testsys.cpu[0].max_insts_any_thread)
@@ -505,12 +553,18 @@ def run(options, root, testsys, cpu_class):
         if options.repeat_switch and maxtick > options.repeat_switch:
             exit_event = repeatSwitch(testsys, repeat_switch_cpu_list,
                                       maxtick, options.repeat_switch)
+        elif options.sample_length:
+            exit_event = sampleWorkload(testsys, options, maxtick)
         else:
             exit_event = benchCheckpoints(options, maxtick, cptdir)
 
-    print 'Exiting @ tick %i because %s' % (m5.curTick(), exit_event.getCause())
+    if exit_event:
+        exit_cause = exit_event.getCause()
+    else:
+        exit_cause = "sampling is done"
+    print 'Exiting @ tick %i because %s' % (m5.curTick(), exit_cause)
     if options.checkpoint_at_end:
         m5.checkpoint(joinpath(cptdir, "cpt.%d"))
 
     if not m5.options.interactive:
-        sys.exit(exit_event.getCode())
+        sys.exit(exit_event.getCode() if exit_event else 0)
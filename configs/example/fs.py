@@ -129,6 +129,14 @@ def build_test_system(np):
     if is_kvm_cpu(TestCPUClass) or is_kvm_cpu(FutureClass):
         test_sys.vm = KvmVM()
 
+    if options.simpoint_profile:
+        if not is_kvm_cpu(TestCPUClass):
+            fatal("SimPoint generation in full system needs a KVM CPU")
+        if np > 1:
+            fatal("SimPoint generation not supported with more than one CPUs")
+        test_sys.cpu[0].simpoint_profile = True
+        test_sys.cpu[0].simpoint_interval = options.simpoint_interval
+
     if options.ruby:
         # Check for timing mode because ruby does not support atomic accesses
         if not (options.cpu_type == "detailed" or options.cpu_type == "timing"):
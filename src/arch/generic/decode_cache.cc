@@ -41,6 +41,9 @@ StaticInstPtr
 BasicDecodeCache::decode(TheISA::Decoder *decoder,
         TheISA::ExtMachInst mach_inst, Addr addr)
 {
+    if (DecodeCache::shared)
+        return sharedInsts.decode(decoder, mach_inst);
+
     StaticInstPtr &si = decodePages.lookup(addr);
     if (si && (si->machInst == mach_inst))
         return si;
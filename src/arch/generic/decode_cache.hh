@@ -50,6 +50,9 @@ class BasicDecodeCache
     DecodeCache::InstMap instMap;
     DecodeCache::AddrMap<StaticInstPtr> decodePages;
 
+    /// Used instead of the above when DecodeCache::shared is set.
+    DecodeCache::SharedInstMap sharedInsts;
+
   public:
     /// Decode a machine instruction.
     /// @param mach_inst The binary instruction to decode.
@@ -460,10 +460,15 @@ Decoder::doImmediateState()
 
 Decoder::InstBytes Decoder::dummy;
 Decoder::InstCacheMap Decoder::instCacheMap;
+Decoder::SharedInstCacheMap Decoder::sharedInstCacheMap;
+std::mutex Decoder::sharedInstCacheLock;
 
 StaticInstPtr
 Decoder::decode(ExtMachInst mach_inst, Addr addr)
 {
+    if (sharedInstMap)
+        return sharedInstMap->decode(this, mach_inst);
+
     DecodeCache::InstMap::iterator iter = instMap->find(mach_inst);
     if (iter != instMap->end())
         return iter->second;
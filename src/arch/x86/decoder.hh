@@ -32,6 +32,7 @@
 #define __ARCH_X86_DECODER_HH__
 
 #include <cassert>
+#include <mutex>
 #include <vector>
 
 #include "arch/x86/regs/misc.hh"
@@ -201,6 +202,14 @@ class Decoder
     typedef m5::hash_map<CacheKey, DecodeCache::InstMap *> InstCacheMap;
     static InstCacheMap instCacheMap;
 
+    /// Thread-safe counterparts of instMap and instCacheMap, used
+    /// instead when DecodeCache::shared is set.
+    DecodeCache::SharedInstMap *sharedInstMap;
+    typedef DecodeCache::SharedMap<CacheKey, DecodeCache::SharedInstMap *>
+        SharedInstCacheMap;
+    static SharedInstCacheMap sharedInstCacheMap;
+    static std::mutex sharedInstCacheLock;
+
   public:
     Decoder() : basePC(0), origPC(0), offset(0),
         outOfBytes(true), instDone(false),
@@ -219,6 +228,7 @@ class Decoder
         instBytes = &dummy;
         decodePages = NULL;
         instMap = NULL;
+        sharedInstMap = NULL;
     }
 
     void setM5Reg(HandyM5Reg m5Reg)
@@ -241,6 +251,19 @@ class Decoder
             addrCacheMap[m5Reg] = decodePages;
         }
 
+        if (DecodeCache::shared) {
+            sharedInstMap = sharedInstCacheMap.find(m5Reg);
+            if (!sharedInstMap) {
+                std::lock_guard<std::mutex> guard(sharedInstCacheLock);
+                sharedInstMap = sharedInstCacheMap.find(m5Reg);
+                if (!sharedInstMap) {
+                    sharedInstMap = new DecodeCache::SharedInstMap;
+                    sharedInstCacheMap.insert(m5Reg, sharedInstMap);
+                }
+            }
+            return;
+        }
+
         InstCacheMap::iterator imIter = instCacheMap.find(m5Reg);
         if (imIter != instCacheMap.end()) {
             instMap = imIter->second;
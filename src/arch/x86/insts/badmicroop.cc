@@ -47,9 +47,21 @@ namespace X86ISA
 // This microop needs to be allocated on the heap even though it could
 // theoretically be statically allocated. The reference counted pointer would
 // try to delete the static memory when it was destructed.
-const StaticInstPtr badMicroop =
-    new X86ISAInst::MicroPanic(NoopMachInst, "BAD",
-        StaticInst::IsMicroop | StaticInst::IsLastMicroop,
-        "Invalid microop!", 0);
+static StaticInstPtr
+makeBadMicroop()
+{
+    StaticInstPtr microop =
+        new X86ISAInst::MicroPanic(NoopMachInst, "BAD",
+            StaticInst::IsMicroop | StaticInst::IsLastMicroop,
+            "Invalid microop!", 0);
+
+    // Every decoder hands out this one microop, including decoders in
+    // different threads when DecodeCache::shared is set. It lives as
+    // long as the simulator anyway, so it is always pinned.
+    microop->pin();
+    return microop;
+}
+
+const StaticInstPtr badMicroop = makeBadMicroop();
 
 } // namespace X86ISA
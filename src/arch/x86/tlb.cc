@@ -456,7 +456,7 @@ TLB::serialize(std::ostream &os)
 
     for (uint32_t x = 0; x < size; x++) {
         if (tlb[x].trieHandle != NULL) {
-            os << "\n[" << csprintf("%s.Entry%d", name(), _count) << "]\n";
+            nameOut(os, csprintf("%s.Entry%d", name(), _count));
             tlb[x].serialize(os);
             _count++;
         }
@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "base/chunked_image.hh"
+#include "base/intmath.hh"
+#include "base/misc.hh"
+
+using namespace std;
+
+namespace ChunkedImage
+{
+
+namespace
+{
+
+const char magic[8] = { 'g', 'e', 'm', '5', 'z', 'c', 'h', 'k' };
+const uint32_t version = 1;
+
+struct Header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t chunkSize;
+    uint64_t size;
+    uint64_t numChunks;
+    uint64_t indexOffset;
+};
+
+struct IndexEntry
+{
+    uint64_t offset;
+    uint64_t size;
+};
+
+/** A compressed chunk, empty if the chunk is all zero. */
+typedef vector<uint8_t> Chunk;
+
+unsigned
+numThreads(unsigned threads)
+{
+    if (threads == 0)
+        threads = thread::hardware_concurrency();
+    return threads ? threads : 1;
+}
+
+bool
+isZero(const uint8_t *p, size_t len)
+{
+    const uint64_t *words = (const uint64_t *)p;
+    size_t num_words = len / sizeof(uint64_t);
+    for (size_t i = 0; i < num_words; ++i)
+        if (words[i])
+            return false;
+    for (size_t i = num_words * sizeof(uint64_t); i < len; ++i)
+        if (p[i])
+            return false;
+    return true;
+}
+
+void
+writeAll(int fd, const void *buf, size_t len, uint64_t offset,
+         const string &filename)
+{
+    const uint8_t *p = (const uint8_t *)buf;
+    while (len) {
+        ssize_t ret = pwrite(fd, p, len, offset);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret < 0)
+            fatal("Write failed on '%s': %s\n", filename, strerror(errno));
+        p += ret;
+        len -= ret;
+        offset += ret;
+    }
+}
+
+void
+readAll(int fd, void *buf, size_t len, uint64_t offset,
+        const string &filename)
+{
+    uint8_t *p = (uint8_t *)buf;
+    while (len) {
+        ssize_t ret = pread(fd, p, len, offset);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0)
+            fatal("Read failed on '%s'\n", filename);
+        p += ret;
+        len -= ret;
+        offset += ret;
+    }
+}
+
+/**
+ * Compress every num_threads'th chunk of a batch, starting at first.
+ */
+void
+compressChunks(const uint8_t *data, uint64_t size, uint32_t chunk_size,
+               int level, uint64_t batch_start, vector<Chunk> &batch,
+               size_t first, size_t stride)
+{
+    for (size_t i = first; i < batch.size(); i += stride) {
+        uint64_t offset = (batch_start + i) * chunk_size;
+        uLong len = min<uint64_t>(chunk_size, size - offset);
+        Chunk &chunk = batch[i];
+
+        if (isZero(data + offset, len)) {
+            chunk.clear();
+            continue;
+        }
+
+        uLongf out_len = compressBound(len);
+        chunk.resize(out_len);
+        if (compress2(&chunk[0], &out_len, data + offset, len, level) != Z_OK)
+            panic("Failed to compress a chunk of %d bytes\n", len);
+        chunk.resize(out_len);
+    }
+}
+
+/** What the threads decompressing an image share. */
+struct ReadState
+{
+    ReadState(const string &_filename, int _fd,
+              const vector<IndexEntry> &_index, uint8_t *_data,
+              uint64_t _size, uint64_t _chunkSize)
+        : filename(_filename), fd(_fd), index(_index), data(_data),
+          size(_size), chunkSize(_chunkSize), next(0), failed(false)
+    { }
+
+    const string &filename;
+    const int fd;
+    const vector<IndexEntry> &index;
+    uint8_t *const data;
+    const uint64_t size;
+    const uint64_t chunkSize;
+
+    /** Next chunk to be taken by a thread. */
+    atomic<uint64_t> next;
+    atomic<bool> failed;
+};
+
+/**
+ * Decompress the chunks left, taking one at a time, until all are
+ * done.
+ */
+void
+inflateChunks(ReadState &state)
+{
+    Chunk chunk;
+    uint64_t i;
+    while ((i = state.next.fetch_add(1)) < state.index.size()) {
+        const IndexEntry &entry = state.index[i];
+        if (entry.size == 0)
+            continue;
+
+        chunk.resize(entry.size);
+        readAll(state.fd, &chunk[0], chunk.size(), entry.offset,
+                state.filename);
+
+        uint64_t offset = i * state.chunkSize;
+        uLongf expected = min<uint64_t>(state.chunkSize, state.size - offset);
+        uLongf len = expected;
+        if (uncompress(state.data + offset, &len, &chunk[0],
+                       chunk.size()) != Z_OK || len != expected)
+            state.failed = true;
+    }
+}
+
+}
+
+void
+write(const string &filename, const uint8_t *data, uint64_t size,
+      unsigned threads, int level)
+{
+    const uint32_t chunk_size = defaultChunkSize;
+    const uint64_t num_chunks = divCeil(size, chunk_size);
+    threads = numThreads(threads);
+
+    int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0664);
+    if (fd < 0)
+        fatal("Can't open '%s' for writing: %s\n", filename, strerror(errno));
+
+    vector<IndexEntry> index(num_chunks);
+    uint64_t offset = sizeof(Header);
+
+    // Chunks are compressed a batch at a time, while the previous
+    // batch is written out, which bounds the memory used to a few
+    // chunks per thread
+    const size_t batch_chunks = 4 * threads;
+    vector<Chunk> batch(batch_chunks), done;
+    uint64_t done_start = 0;
+
+    for (uint64_t start = 0; start < num_chunks || !done.empty();
+         start += batch_chunks) {
+        vector<thread *> workers;
+        if (start < num_chunks) {
+            batch.resize(min<uint64_t>(batch_chunks, num_chunks - start));
+            for (unsigned t = 0; t < threads && t < batch.size(); ++t) {
+                workers.push_back(new thread(compressChunks, data, size,
+                                             chunk_size, level, start,
+                                             ref(batch), t, threads));
+            }
+        }
+
+        for (size_t i = 0; i < done.size(); ++i) {
+            IndexEntry &entry = index[done_start + i];
+            entry.offset = offset;
+            entry.size = done[i].size();
+            if (!done[i].empty())
+                writeAll(fd, &done[i][0], done[i].size(), offset, filename);
+            offset += entry.size;
+        }
+
+        for (size_t t = 0; t < workers.size(); ++t) {
+            workers[t]->join();
+            delete workers[t];
+        }
+
+        if (start < num_chunks) {
+            done.swap(batch);
+            done_start = start;
+        } else {
+            done.clear();
+        }
+    }
+
+    if (num_chunks)
+        writeAll(fd, &index[0], num_chunks * sizeof(IndexEntry), offset,
+                 filename);
+
+    Header header;
+    memcpy(header.magic, magic, sizeof(header.magic));
+    header.version = version;
+    header.chunkSize = chunk_size;
+    header.size = size;
+    header.numChunks = num_chunks;
+    header.indexOffset = offset;
+    writeAll(fd, &header, sizeof(header), 0, filename);
+
+    if (close(fd) != 0)
+        fatal("Close failed on '%s': %s\n", filename, strerror(errno));
+}
+
+void
+read(const string &filename, uint8_t *data, uint64_t size, unsigned threads)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        fatal("Can't open '%s' for reading: %s\n", filename, strerror(errno));
+
+    Header header;
+    readAll(fd, &header, sizeof(header), 0, filename);
+    if (memcmp(header.magic, magic, sizeof(header.magic)) != 0)
+        fatal("'%s' is not a chunked image\n", filename);
+    if (header.version != version)
+        fatal("Chunked image '%s' has version %d, expected %d\n", filename,
+              header.version, version);
+    if (header.size != size)
+        fatal("Chunked image '%s' holds %d bytes, expected %d\n", filename,
+              header.size, size);
+    if (header.chunkSize == 0 ||
+        header.numChunks != divCeil(size, header.chunkSize))
+        fatal("Chunked image '%s' has a corrupt header\n", filename);
+
+    vector<IndexEntry> index(header.numChunks);
+    if (!index.empty())
+        readAll(fd, &index[0], index.size() * sizeof(IndexEntry),
+                header.indexOffset, filename);
+
+    ReadState state(filename, fd, index, data, size, header.chunkSize);
+    vector<thread *> workers;
+    for (unsigned t = 1; t < numThreads(threads); ++t)
+        workers.push_back(new thread(inflateChunks, ref(state)));
+    inflateChunks(state);
+    for (size_t t = 0; t < workers.size(); ++t) {
+        workers[t]->join();
+        delete workers[t];
+    }
+
+    close(fd);
+
+    if (state.failed)
+        fatal("Chunked image '%s' has a corrupt chunk\n", filename);
+}
+
+} // namespace ChunkedImage
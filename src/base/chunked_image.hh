@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Files of independently compressed chunks, written and read in parallel
+ */
+
+#ifndef __BASE_CHUNKED_IMAGE_HH__
+#define __BASE_CHUNKED_IMAGE_HH__
+
+#include <string>
+
+#include "base/types.hh"
+
+/**
+ * A chunked image holds a block of data, split into chunks of a fixed
+ * size that are each compressed with zlib on their own. Chunks can
+ * thus be compressed and decompressed by many threads at once, which
+ * makes checkpointing large memories scale with the number of host
+ * cores. Chunks that are all zero are not stored at all.
+ *
+ * The file starts with the eight characters "gem5zchk", a uint32
+ * version, the uint32 size of a chunk, the uint64 size of the data,
+ * the uint64 number of chunks and the uint64 offset of the index.
+ * The compressed chunks follow in order, and the index holds the
+ * uint64 offset and uint64 compressed size of every chunk, the size
+ * being zero for chunks that are all zero. All integers are in host
+ * byte order.
+ */
+namespace ChunkedImage
+{
+
+/** Size of the chunks written, before compression. */
+const uint32_t defaultChunkSize = 4 << 20;
+
+/**
+ * Write a block of data to a chunked image.
+ * @param filename File to write.
+ * @param data The data.
+ * @param size Number of bytes of data.
+ * @param threads Number of threads compressing, 0 to use one per
+ * host core.
+ * @param level zlib compression level.
+ */
+void write(const std::string &filename, const uint8_t *data, uint64_t size,
+           unsigned threads = 0, int level = 1);
+
+/**
+ * Read a chunked image into a block of data. Only the chunks that are
+ * not all zero are written to the data.
+ * @param filename File to read.
+ * @param data Where to put the data.
+ * @param size Expected number of bytes of data.
+ * @param threads Number of threads decompressing, 0 to use one per
+ * host core.
+ */
+void read(const std::string &filename, uint8_t *data, uint64_t size,
+          unsigned threads = 0);
+
+} // namespace ChunkedImage
+
+#endif // __BASE_CHUNKED_IMAGE_HH__
@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * List backed by a circular buffer
+ */
+
+#ifndef __BASE_CIRCULAR_LIST_HH__
+#define __BASE_CIRCULAR_LIST_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include "base/types.hh"
+
+/**
+ * A list with the interface of (a subset of) std::list, stored in a
+ * circular buffer, for the queues of in-flight instructions of a CPU
+ * that are bounded by the size of the machine. Elements are appended
+ * at the back and are mostly removed from either end. Elements can
+ * also be erased from the middle, which leaves a hole that is skipped
+ * by iterators until the ends of the list catch up with it.
+ *
+ * Every element gets a position that only ever increases, and an
+ * iterator is a position in a list. Iterators therefore stay valid
+ * until their element is erased, whatever happens to the rest of the
+ * list, as with std::list. end() is not a position, so it never
+ * refers to an element added later, and as with std::list,
+ * decrementing begin() gives end() and incrementing end() gives
+ * begin().
+ *
+ * The buffer is allocated up front with the given capacity, and is
+ * only reallocated (to twice the size) if the span from the first to
+ * the last element doesn't fit, e.g., because of holes.
+ */
+template <class T>
+class CircularList
+{
+  private:
+    /** Elements, indexed by position modulo the number of slots. */
+    std::vector<T> slots;
+
+    /** Whether the slot holds an element, as opposed to a hole. */
+    std::vector<uint8_t> live;
+
+    /** Number of slots minus one, the number of slots being 2^n. */
+    uint64_t mask;
+
+    /** Position of the first element. */
+    uint64_t headPos;
+
+    /** Position after the last element. */
+    uint64_t tailPos;
+
+    /** Number of elements, not counting holes. */
+    size_t _size;
+
+    /** Position of end(). */
+    static const uint64_t endPos = ~0ULL;
+
+    bool isLive(uint64_t pos) const { return live[pos & mask]; }
+
+    uint64_t
+    next(uint64_t pos) const
+    {
+        if (pos == endPos)
+            return headPos != tailPos ? headPos : endPos;
+
+        do {
+            ++pos;
+        } while (pos < tailPos && !isLive(pos));
+
+        return pos < tailPos ? pos : endPos;
+    }
+
+    uint64_t
+    prev(uint64_t pos) const
+    {
+        if (pos == endPos)
+            return headPos != tailPos ? tailPos - 1 : endPos;
+
+        while (pos != headPos) {
+            --pos;
+            if (isLive(pos))
+                return pos;
+        }
+
+        return endPos;
+    }
+
+    /** Move the elements to a buffer with at least n slots. */
+    void
+    resize(size_t n)
+    {
+        size_t num_slots = slots.empty() ? 1 : slots.size();
+        while (num_slots < n)
+            num_slots *= 2;
+
+        std::vector<T> new_slots(num_slots);
+        std::vector<uint8_t> new_live(num_slots, 0);
+        const uint64_t new_mask = num_slots - 1;
+
+        for (uint64_t pos = headPos; pos != tailPos; ++pos) {
+            if (isLive(pos)) {
+                new_slots[pos & new_mask] = slots[pos & mask];
+                new_live[pos & new_mask] = 1;
+            }
+        }
+
+        slots.swap(new_slots);
+        live.swap(new_live);
+        mask = new_mask;
+    }
+
+  public:
+    template <class V, class L>
+    class iter : public std::iterator<std::bidirectional_iterator_tag, V>
+    {
+      private:
+        friend class CircularList;
+        L *list;
+        uint64_t pos;
+
+      public:
+        iter() : list(NULL), pos(endPos) { }
+        iter(L *_list, uint64_t _pos) : list(_list), pos(_pos) { }
+        template <class V2, class L2>
+        iter(const iter<V2, L2> &i) : list(i.list), pos(i.pos) { }
+
+        V &
+        operator*() const
+        {
+            assert(pos != endPos && list->isLive(pos));
+            return list->slots[pos & list->mask];
+        }
+
+        V *operator->() const { return &**this; }
+        iter &operator++() { pos = list->next(pos); return *this; }
+        iter &operator--() { pos = list->prev(pos); return *this; }
+        iter operator++(int) { iter i = *this; ++*this; return i; }
+        iter operator--(int) { iter i = *this; --*this; return i; }
+
+        bool
+        operator==(const iter &i) const
+        {
+            return list == i.list && pos == i.pos;
+        }
+
+        bool operator!=(const iter &i) const { return !(*this == i); }
+
+        template <class V2, class L2> friend class iter;
+    };
+
+    typedef T value_type;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef size_t size_type;
+    typedef iter<T, CircularList> iterator;
+    typedef iter<const T, const CircularList> const_iterator;
+
+    /** @param capacity Number of elements to allocate room for. */
+    explicit CircularList(size_t capacity = 0)
+        : mask(0), headPos(0), tailPos(0), _size(0)
+    {
+        resize(capacity);
+    }
+
+    /** Make room for at least n elements without holes. */
+    void
+    reserve(size_t n)
+    {
+        if (n > slots.size())
+            resize(n);
+    }
+
+    size_t capacity() const { return slots.size(); }
+
+    iterator begin() { return iterator(this, next(endPos)); }
+    iterator end() { return iterator(this, endPos); }
+    const_iterator begin() const { return const_iterator(this, next(endPos)); }
+    const_iterator end() const { return const_iterator(this, endPos); }
+
+    bool empty() const { return _size == 0; }
+    size_t size() const { return _size; }
+
+    T &front() { assert(!empty()); return slots[headPos & mask]; }
+    T &back() { assert(!empty()); return slots[(tailPos - 1) & mask]; }
+    const T &front() const { assert(!empty()); return slots[headPos & mask]; }
+    const T &
+    back() const
+    {
+        assert(!empty());
+        return slots[(tailPos - 1) & mask];
+    }
+
+    void
+    push_back(const T &v)
+    {
+        if (tailPos - headPos == slots.size())
+            resize(slots.size() * 2);
+
+        slots[tailPos & mask] = v;
+        live[tailPos & mask] = 1;
+        ++tailPos;
+        ++_size;
+    }
+
+    /** Remove the element at pos, returning the one after it. */
+    iterator
+    erase(iterator pos)
+    {
+        assert(pos.list == this && pos.pos != endPos && isLive(pos.pos));
+
+        iterator next_it(this, next(pos.pos));
+
+        slots[pos.pos & mask] = T();
+        live[pos.pos & mask] = 0;
+        --_size;
+
+        // Keep the first and last slots occupied
+        while (headPos != tailPos && !isLive(headPos))
+            ++headPos;
+        while (tailPos != headPos && !isLive(tailPos - 1))
+            --tailPos;
+
+        return next_it;
+    }
+
+    void pop_front() { erase(begin()); }
+    void pop_back() { erase(iterator(this, tailPos - 1)); }
+
+    void
+    clear()
+    {
+        for (uint64_t pos = headPos; pos != tailPos; ++pos) {
+            slots[pos & mask] = T();
+            live[pos & mask] = 0;
+        }
+        headPos = tailPos;
+        _size = 0;
+    }
+};
+
+#endif // __BASE_CIRCULAR_LIST_HH__
@@ -84,6 +84,7 @@ OutputDirectory::openFile(const string &filename,
             fatal("Cannot open file %s", filename);
         assert(files.find(filename) == files.end());
         files[filename] = file;
+        modes[filename] = mode;
         return file;
     } else {
         ofstream *file = new ofstream(filename.c_str(), mode);
@@ -91,6 +92,7 @@ OutputDirectory::openFile(const string &filename,
             fatal("Cannot open file %s", filename);
         assert(files.find(filename) == files.end());
         files[filename] = file;
+        modes[filename] = mode;
         return file;
     }
 }
@@ -120,6 +122,7 @@ OutputDirectory::close(ostream *openStream) {
     if (i == files.end())
         fatal("Attempted to close an unregistred file stream");
 
+    modes.erase(i->first);
     files.erase(i);
 }
 
@@ -136,6 +139,89 @@ OutputDirectory::setDirectory(const string &d)
         dir += PATH_SEPARATOR;
 }
 
+void
+OutputDirectory::relocate(const string &d)
+{
+    const string old_dir = directory();
+    dir.clear();
+    setDirectory(d);
+
+    map_t old_files;
+    old_files.swap(files);
+    std::map<std::string, std::ios_base::openmode> old_modes;
+    old_modes.swap(modes);
+    for (map_t::iterator i = old_files.begin(); i != old_files.end(); ++i) {
+        if (i->first.compare(0, old_dir.size(), old_dir) != 0)
+            panic("Can't relocate file %s outside of %s\n",
+                  i->first, old_dir);
+        const string name = dir + i->first.substr(old_dir.size());
+
+        ofstream *fs = dynamic_cast<ofstream *>(i->second);
+        if (!fs)
+            panic("Can't relocate compressed file %s\n", i->first);
+
+        // create the subdirectories the file is in
+        for (size_t sep = name.find(PATH_SEPARATOR, dir.size());
+             sep != string::npos;
+             sep = name.find(PATH_SEPARATOR, sep + 1)) {
+            const string sub_dir = name.substr(0, sep);
+            if (mkdir(sub_dir.c_str(), 0755) != 0 && errno != EEXIST)
+                fatal("Failed to create output subdirectory '%s'\n",
+                      sub_dir);
+        }
+
+        // start the file over; ios::app can't be combined with
+        // ios::trunc, but the file is new in any case
+        ios_base::openmode mode = old_modes[i->first];
+        if (!(mode & ios::app))
+            mode |= ios::trunc;
+
+        fs->close();
+        fs->clear();
+        fs->open(name.c_str(), mode);
+        if (!fs->is_open())
+            fatal("Cannot open file %s", name);
+        files[name] = fs;
+        modes[name] = mode;
+    }
+
+    relocateCallbacks.process();
+}
+
+void
+OutputDirectory::registerRelocateCallback(Callback *callback)
+{
+    relocateCallbacks.add(callback);
+}
+
+void
+OutputDirectory::flush()
+{
+    for (map_t::iterator i = files.begin(); i != files.end(); ++i)
+        i->second->flush();
+}
+
+bool
+OutputDirectory::compressedFiles() const
+{
+    for (map_t::const_iterator i = files.begin(); i != files.end(); ++i) {
+        if (!dynamic_cast<ofstream *>(i->second))
+            return true;
+    }
+    return false;
+}
+
+bool
+OutputDirectory::filesOutsideDirectory() const
+{
+    const string &d = directory();
+    for (map_t::const_iterator i = files.begin(); i != files.end(); ++i) {
+        if (i->first.compare(0, d.size(), d) != 0)
+            return true;
+    }
+    return false;
+}
+
 const string &
 OutputDirectory::directory() const
 {
@@ -226,6 +312,7 @@ OutputDirectory::remove(const string &name, bool recursive)
         if (itr != files.end()) {
             delete itr->second;
             files.erase(itr);
+            modes.erase(fname);
         }
 
         if (::remove(fname.c_str()) != 0)
@@ -36,6 +36,8 @@
 #include <map>
 #include <string>
 
+#include "base/callback.hh"
+
 /** Interface for creating files in a gem5 output directory. */
 class OutputDirectory
 {
@@ -46,9 +48,15 @@ class OutputDirectory
     /** Open file streams within this directory */
     map_t files;
 
+    /** Modes the files were opened with, to reopen them in relocate() */
+    std::map<std::string, std::ios_base::openmode> modes;
+
     /** Name of this directory */
     std::string dir;
 
+    /** Callbacks to call after the directory was relocated */
+    CallbackQueue relocateCallbacks;
+
     /** System-specific path separator character */
     static const char PATH_SEPARATOR = '/';
 
@@ -97,6 +105,47 @@ class OutputDirectory
      */
     void setDirectory(const std::string &dir);
 
+    /**
+     * Moves this directory to a new location, for the output of a
+     * forked child. Files open in the old directory are reopened,
+     * empty, under the same name and with the same mode in the new
+     * one, using the same stream objects, and any subdirectory they
+     * are in is created. Anything written to a file before is not in
+     * the new file, so the relocate callbacks are called afterwards
+     * to let writers start their files over. The old files are closed
+     * without writing to them, provided flush() was called before
+     * forking. No file may be open outside of the old directory, see
+     * filesOutsideDirectory().
+     *
+     * @param dir name of the new directory
+     */
+    void relocate(const std::string &dir);
+
+    /**
+     * Registers a callback to be called after the directory was
+     * relocated, for writers that need to write the header of their
+     * file again, or that must forget what they already wrote.
+     *
+     * @param callback callback to call
+     */
+    void registerRelocateCallback(Callback *callback);
+
+    /** Flushes all open files. */
+    void flush();
+
+    /**
+     * Returns true if a compressed file is open. Those can't be
+     * relocated, as closing them writes to the file.
+     */
+    bool compressedFiles() const;
+
+    /**
+     * Returns true if a file is open outside of this directory. Those
+     * can't be relocated, as the copy of a forked child would have
+     * the same name as that of the parent.
+     */
+    bool filesOutsideDirectory() const;
+
     /**
      * Gets name of this directory.
      * @return name of this directory
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstring>
+
+#include "base/misc.hh"
+#include "base/pool_alloc.hh"
+#include "base/types.hh"
+
+namespace PoolAlloc
+{
+
+__thread void *freeLists[numClasses];
+
+/** Size of the chunks that blocks are carved out of. */
+static const size_t chunkSize = 64 * 1024;
+
+void *
+refill(int size_class)
+{
+    const size_t size = (size_class + 1) * granularity;
+    char *chunk = (char *)::operator new(chunkSize);
+
+    // Keep the first block for the caller and put the rest on the
+    // free list, lowest address first.
+    const size_t num_blocks = chunkSize / size;
+    void *head = freeLists[size_class];
+    for (size_t i = num_blocks - 1; i > 0; --i) {
+        void *p = chunk + i * size;
+#if POOL_ALLOC_DEBUG
+        poison(p, size);
+#endif
+        *(void **)p = head;
+        head = p;
+    }
+    freeLists[size_class] = head;
+
+    return chunk;
+}
+
+#if POOL_ALLOC_DEBUG
+
+static const uint8_t poisonByte = 0xa5;
+
+void
+poison(void *p, size_t size)
+{
+    std::memset((char *)p + sizeof(void *), poisonByte,
+                size - sizeof(void *));
+}
+
+void
+checkPoison(void *p, size_t size)
+{
+    const uint8_t *b = (const uint8_t *)p;
+    for (size_t i = sizeof(void *); i < size; ++i) {
+        if (b[i] != poisonByte) {
+            panic("Pooled block %#x of %d bytes written at offset %d "
+                  "after being freed\n", (uintptr_t)p, size, i);
+        }
+    }
+}
+
+#endif // POOL_ALLOC_DEBUG
+
+} // namespace PoolAlloc
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Thread-local pooled allocation of small, frequently recycled objects
+ */
+
+#ifndef __BASE_POOL_ALLOC_HH__
+#define __BASE_POOL_ALLOC_HH__
+
+#include <cstddef>
+
+#include "config/pool_alloc_debug.hh"
+
+/**
+ * Allocator for small objects that are allocated and freed at a high
+ * rate, such as packets, requests and their data buffers. Blocks are
+ * grouped in size classes and carved out of large chunks; freed
+ * blocks go onto a free list per size class and thread, and are
+ * handed out again by the next allocation of the same class. The
+ * memory is never returned to the system. Blocks may be freed by a
+ * different thread than the one that allocated them, in which case
+ * they simply move to the free list of the freeing thread.
+ *
+ * When compiled with POOL_ALLOC_DEBUG, freed blocks are filled with a
+ * poison pattern that is checked when the block is handed out again,
+ * so that writes through dangling pointers are caught, and reads
+ * through them return obviously bogus values.
+ */
+namespace PoolAlloc
+{
+
+/** Size classes are multiples of this many bytes. */
+const size_t granularity = 16;
+
+/** Largest size that is pooled, larger blocks use the heap. */
+const size_t maxSize = 256;
+
+const int numClasses = maxSize / granularity;
+
+/** Free lists of the running thread, linked through the first word. */
+extern __thread void *freeLists[numClasses];
+
+inline int
+sizeClass(size_t size)
+{
+    return size ? (size - 1) / granularity : 0;
+}
+
+/** Refill the free list of a size class and take a block from it. */
+void *refill(int size_class);
+
+#if POOL_ALLOC_DEBUG
+void poison(void *p, size_t size);
+void checkPoison(void *p, size_t size);
+#endif
+
+/** Allocate a block of at least the given size. */
+inline void *
+allocate(size_t size)
+{
+    if (size > maxSize)
+        return ::operator new(size);
+
+    int size_class = sizeClass(size);
+    void *p = freeLists[size_class];
+    if (!p)
+        return refill(size_class);
+
+    freeLists[size_class] = *(void **)p;
+#if POOL_ALLOC_DEBUG
+    checkPoison(p, (size_class + 1) * granularity);
+#endif
+    return p;
+}
+
+/**
+ * Free a block obtained from allocate(). The size must be the one it
+ * was allocated with.
+ */
+inline void
+release(void *p, size_t size)
+{
+    if (size > maxSize) {
+        ::operator delete(p);
+        return;
+    }
+
+    int size_class = sizeClass(size);
+#if POOL_ALLOC_DEBUG
+    poison(p, (size_class + 1) * granularity);
+#endif
+    *(void **)p = freeLists[size_class];
+    freeLists[size_class] = p;
+}
+
+} // namespace PoolAlloc
+
+/**
+ * Derive from PoolAllocated to have the objects of a class allocated
+ * through PoolAlloc. Classes derived from it must either have a
+ * virtual destructor or never be deleted through a base pointer, so
+ * that operator delete is given the right size.
+ */
+class PoolAllocated
+{
+  public:
+    static void *
+    operator new(size_t size)
+    {
+        return PoolAlloc::allocate(size);
+    }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        PoolAlloc::release(p, size);
+    }
+};
+
+#endif // __BASE_POOL_ALLOC_HH__
@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Doubly-linked list that recycles its nodes
+ */
+
+#ifndef __BASE_POOLED_LIST_HH__
+#define __BASE_POOLED_LIST_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <new>
+
+/**
+ * A doubly-linked list with the interface of (a subset of) std::list,
+ * for lists that see a steady stream of insertions and removals such
+ * as the queues of packets in the memory system. Removed nodes are
+ * kept on a free list owned by the list and reused by later
+ * insertions, so once a list has reached its working size, inserting
+ * and removing elements does not allocate. Unlike std::list in
+ * pre-C++11 libraries, size() is constant time.
+ *
+ * Nodes moved to another list by splice() become part of that list,
+ * and are recycled by it.
+ */
+template <class T>
+class PooledList
+{
+  private:
+    struct Link
+    {
+        Link *prev;
+        Link *next;
+    };
+
+    struct Node : public Link
+    {
+        T value;
+        Node(const T &v) : value(v) { }
+    };
+
+    /** Sentinel, the first and last node link to it. */
+    Link head;
+
+    /** Number of elements in the list. */
+    size_t _size;
+
+    /** Unused nodes, singly linked through next. */
+    Link *freeNodes;
+
+    static T &valueOf(Link *l) { return static_cast<Node *>(l)->value; }
+
+    Link *
+    newNode(const T &v)
+    {
+        void *mem;
+        if (freeNodes) {
+            mem = freeNodes;
+            freeNodes = freeNodes->next;
+        } else {
+            mem = ::operator new(sizeof(Node));
+        }
+        return new (mem) Node(v);
+    }
+
+    void
+    freeNode(Link *l)
+    {
+        static_cast<Node *>(l)->~Node();
+        l->next = freeNodes;
+        freeNodes = l;
+    }
+
+    static void
+    link(Link *pos, Link *l)
+    {
+        l->next = pos;
+        l->prev = pos->prev;
+        pos->prev->next = l;
+        pos->prev = l;
+    }
+
+    static void
+    unlink(Link *l)
+    {
+        l->prev->next = l->next;
+        l->next->prev = l->prev;
+    }
+
+  public:
+    template <class V, class L>
+    class iter : public std::iterator<std::bidirectional_iterator_tag, V>
+    {
+      private:
+        friend class PooledList;
+        L *l;
+
+      public:
+        iter() : l(NULL) { }
+        explicit iter(L *_l) : l(_l) { }
+        template <class V2, class L2>
+        iter(const iter<V2, L2> &i) : l(i.l) { }
+
+        V &operator*() const { return valueOf(const_cast<Link *>(l)); }
+        V *operator->() const { return &**this; }
+        iter &operator++() { l = l->next; return *this; }
+        iter &operator--() { l = l->prev; return *this; }
+        iter operator++(int) { iter i = *this; l = l->next; return i; }
+        iter operator--(int) { iter i = *this; l = l->prev; return i; }
+        bool operator==(const iter &i) const { return l == i.l; }
+        bool operator!=(const iter &i) const { return l != i.l; }
+
+        template <class V2, class L2> friend class iter;
+    };
+
+    typedef T value_type;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef size_t size_type;
+    typedef iter<T, Link> iterator;
+    typedef iter<const T, const Link> const_iterator;
+
+    PooledList() : _size(0), freeNodes(NULL)
+    {
+        head.prev = head.next = &head;
+    }
+
+    PooledList(const PooledList &other) : _size(0), freeNodes(NULL)
+    {
+        head.prev = head.next = &head;
+        for (const_iterator i = other.begin(); i != other.end(); ++i)
+            push_back(*i);
+    }
+
+    PooledList &
+    operator=(const PooledList &other)
+    {
+        if (this != &other) {
+            clear();
+            for (const_iterator i = other.begin(); i != other.end(); ++i)
+                push_back(*i);
+        }
+        return *this;
+    }
+
+    ~PooledList()
+    {
+        clear();
+        while (freeNodes) {
+            Link *l = freeNodes;
+            freeNodes = l->next;
+            ::operator delete(l);
+        }
+    }
+
+    iterator begin() { return iterator(head.next); }
+    iterator end() { return iterator(&head); }
+    const_iterator begin() const { return const_iterator(head.next); }
+    const_iterator end() const { return const_iterator(&head); }
+
+    bool empty() const { return _size == 0; }
+    size_t size() const { return _size; }
+
+    T &front() { assert(!empty()); return valueOf(head.next); }
+    T &back() { assert(!empty()); return valueOf(head.prev); }
+    const T &front() const { return valueOf(head.next); }
+    const T &back() const { return valueOf(head.prev); }
+
+    /** Insert a copy of v before pos. */
+    iterator
+    insert(iterator pos, const T &v)
+    {
+        Link *l = newNode(v);
+        link(pos.l, l);
+        ++_size;
+        return iterator(l);
+    }
+
+    /** Remove the element at pos, returning the one after it. */
+    iterator
+    erase(iterator pos)
+    {
+        assert(pos.l != &head);
+        Link *next = pos.l->next;
+        unlink(pos.l);
+        freeNode(pos.l);
+        --_size;
+        return iterator(next);
+    }
+
+    void push_front(const T &v) { insert(begin(), v); }
+    void push_back(const T &v) { insert(end(), v); }
+    void pop_front() { erase(begin()); }
+    void pop_back() { erase(iterator(head.prev)); }
+
+    void
+    clear()
+    {
+        while (!empty())
+            pop_front();
+    }
+
+    /** Remove all elements equal to v. */
+    void
+    remove(const T &v)
+    {
+        iterator i = begin();
+        while (i != end()) {
+            if (*i == v)
+                i = erase(i);
+            else
+                ++i;
+        }
+    }
+
+    /** Move all elements of other to before pos. */
+    void
+    splice(iterator pos, PooledList &other)
+    {
+        if (other.empty())
+            return;
+
+        Link *first = other.head.next;
+        Link *last = other.head.prev;
+        other.head.prev = other.head.next = &other.head;
+
+        first->prev = pos.l->prev;
+        last->next = pos.l;
+        pos.l->prev->next = first;
+        pos.l->prev = last;
+
+        _size += other._size;
+        other._size = 0;
+    }
+};
+
+#endif // __BASE_POOLED_LIST_HH__
@@ -456,6 +456,12 @@ Formula::zero() const
     return true;
 }
 
+bool
+Formula::changed() const
+{
+    return root ? root->changed() : false;
+}
+
 string
 Formula::str() const
 {
@@ -494,6 +500,26 @@ registerDumpCallback(Callback *cb)
     dumpQueue.add(cb);
 }
 
+void
+markDumped()
+{
+    list<Info *>::iterator i = statsList().begin();
+    list<Info *>::iterator end = statsList().end();
+    for (; i != end; ++i)
+        (*i)->dumped();
+}
+
+void
+resetChanged()
+{
+    list<Info *>::iterator i = statsList().begin();
+    list<Info *>::iterator end = statsList().end();
+    for (; i != end; ++i) {
+        if ((*i)->changedSinceReset())
+            (*i)->reset();
+    }
+}
+
 } // namespace Stats
 
 void
@@ -96,6 +96,9 @@ class InfoProxy : public Base
         visitor.visit(*static_cast<Base *>(this));
     }
     bool zero() const { return s.zero(); }
+    bool changed() const { return s.changed(); }
+    bool changedSinceReset() const { return s.changedSinceReset(); }
+    void dumped() { s.dumped(); }
 };
 
 template <class Stat>
@@ -168,7 +171,34 @@ struct StorageParams
 
 class InfoAccess
 {
+  private:
+    /** Bits of Changes telling what the stat changed since. */
+    uint8_t changes;
+
   protected:
+    enum Changes {
+        ChangedSinceDump = 0x1,
+        ChangedSinceReset = 0x2
+    };
+
+    /**
+     * Note that the value of the stat was updated. This is a single
+     * store, so that it costs next to nothing on every update.
+     */
+    void setChanged() { changes = ChangedSinceDump | ChangedSinceReset; }
+
+    /**
+     * Update the change bits after the stat was reset. If it was
+     * already in its reset state the reset did not change it,
+     * otherwise it now differs from what was last dumped.
+     */
+    void
+    resetChanges()
+    {
+        if (changes & ChangedSinceReset)
+            changes = ChangedSinceDump;
+    }
+
     /** Set up an info class for this statistic */
     void setInfo(Info *info);
     /** Save Storage class parameters if any */
@@ -182,6 +212,9 @@ class InfoAccess
     const Info *info() const;
 
   public:
+    /** A new stat is taken to have changed until it is dumped. */
+    InfoAccess() : changes(ChangedSinceDump | ChangedSinceReset) { }
+
     /**
      * Reset the stat to the default state.
      */
@@ -193,6 +226,21 @@ class InfoAccess
      */
     bool zero() const { return true; }
 
+    /**
+     * @return true if the stat may have changed since it was last
+     * dumped.
+     */
+    bool changed() const { return changes & ChangedSinceDump; }
+
+    /**
+     * @return true if the stat may have changed since it was last
+     * reset.
+     */
+    bool changedSinceReset() const { return changes & ChangedSinceReset; }
+
+    /** Note that the current value of the stat was dumped. */
+    void dumped() { changes &= ~ChangedSinceDump; }
+
     /**
      * Check that this stat has been set up properly and is ready for
      * use
@@ -407,6 +455,7 @@ class DataWrapVec : public DataWrap<Derived, InfoProxyType>
         size_t size = self.size();
         for (off_type i = 0; i < size; ++i)
             self.data(i)->reset(info);
+        this->resetChanges();
     }
 };
 
@@ -684,12 +733,12 @@ class ScalarBase : public DataWrap<Derived, ScalarInfoProxy>
      * Increment the stat by 1. This calls the associated storage object inc
      * function.
      */
-    void operator++() { data()->inc(1); }
+    void operator++() { data()->inc(1); this->setChanged(); }
     /**
      * Decrement the stat by 1. This calls the associated storage object dec
      * function.
      */
-    void operator--() { data()->dec(1); }
+    void operator--() { data()->dec(1); this->setChanged(); }
 
     /** Increment the stat by 1. */
     void operator++(int) { ++*this; }
@@ -702,7 +751,7 @@ class ScalarBase : public DataWrap<Derived, ScalarInfoProxy>
      * @param v The new value.
      */
     template <typename U>
-    void operator=(const U &v) { data()->set(v); }
+    void operator=(const U &v) { data()->set(v); this->setChanged(); }
 
     /**
      * Increment the stat by the given value. This calls the associated
@@ -710,7 +759,7 @@ class ScalarBase : public DataWrap<Derived, ScalarInfoProxy>
      * @param v The value to add.
      */
     template <typename U>
-    void operator+=(const U &v) { data()->inc(v); }
+    void operator+=(const U &v) { data()->inc(v); this->setChanged(); }
 
     /**
      * Decrement the stat by the given value. This calls the associated
@@ -718,7 +767,7 @@ class ScalarBase : public DataWrap<Derived, ScalarInfoProxy>
      * @param v The value to substract.
      */
     template <typename U>
-    void operator-=(const U &v) { data()->dec(v); }
+    void operator-=(const U &v) { data()->dec(v); this->setChanged(); }
 
     /**
      * Return the number of elements, always 1 for a scalar.
@@ -734,7 +783,7 @@ class ScalarBase : public DataWrap<Derived, ScalarInfoProxy>
 
     bool zero() { return result() == 0.0; }
 
-    void reset() { data()->reset(this->info()); }
+    void reset() { data()->reset(this->info()); this->resetChanges(); }
     void prepare() { data()->prepare(this->info()); }
 };
 
@@ -815,6 +864,10 @@ class ValueBase : public DataWrap<Derived, ScalarInfoProxy>
     bool check() const { return proxy != NULL; }
     void prepare() { }
     void reset() { }
+
+    /** The value is read from elsewhere, so it may always change. */
+    bool changed() const { return true; }
+    bool changedSinceReset() const { return true; }
 };
 
 //////////////////////////////////////////////////////////////////////
@@ -887,12 +940,23 @@ class ScalarProxy
      * Increment the stat by 1. This calls the associated storage object inc
      * function.
      */
-    void operator++() { stat.data(index)->inc(1); }
+    void
+    operator++()
+    {
+        stat.data(index)->inc(1);
+        stat.setChanged();
+    }
+
     /**
      * Decrement the stat by 1. This calls the associated storage object dec
      * function.
      */
-    void operator--() { stat.data(index)->dec(1); }
+    void
+    operator--()
+    {
+        stat.data(index)->dec(1);
+        stat.setChanged();
+    }
 
     /** Increment the stat by 1. */
     void operator++(int) { ++*this; }
@@ -909,6 +973,7 @@ class ScalarProxy
     operator=(const U &v)
     {
         stat.data(index)->set(v);
+        stat.setChanged();
     }
 
     /**
@@ -921,6 +986,7 @@ class ScalarProxy
     operator+=(const U &v)
     {
         stat.data(index)->inc(v);
+        stat.setChanged();
     }
 
     /**
@@ -933,6 +999,7 @@ class ScalarProxy
     operator-=(const U &v)
     {
         stat.data(index)->dec(v);
+        stat.setChanged();
     }
 
     /**
@@ -941,6 +1008,12 @@ class ScalarProxy
      */
     size_type size() const { return 1; }
 
+    /**
+     * @return true if the parent stat may have changed since it was
+     * last dumped.
+     */
+    bool changed() const { return stat.changed(); }
+
   public:
     std::string
     str() const
@@ -1287,6 +1360,7 @@ class Vector2dBase : public DataWrapVec2d<Derived, Vector2dInfoProxy>
         size_type size = this->size();
         for (off_type i = 0; i < size; ++i)
             data(i)->reset(info);
+        this->resetChanges();
     }
 
     bool
@@ -1813,7 +1887,12 @@ class DistBase : public DataWrap<Derived, DistInfoProxy>
      * @param n The number of times to add it, defaults to 1.
      */
     template <typename U>
-    void sample(const U &v, int n = 1) { data()->sample(v, n); }
+    void
+    sample(const U &v, int n = 1)
+    {
+        data()->sample(v, n);
+        this->setChanged();
+    }
 
     /**
      * Return the number of entries in this stat.
@@ -1840,12 +1919,18 @@ class DistBase : public DataWrap<Derived, DistInfoProxy>
     reset()
     {
         data()->reset(this->info());
+        this->resetChanges();
     }
 
     /**
      *  Add the argument distribution to the this distibution.
      */
-    void add(DistBase &d) { data()->add(d.data()); }
+    void
+    add(DistBase &d)
+    {
+        data()->add(d.data());
+        this->setChanged();
+    }
 
 };
 
@@ -1984,6 +2069,7 @@ class DistProxy
     sample(const U &v, int n = 1)
     {
         data()->sample(v, n);
+        stat.setChanged();
     }
 
     size_type
@@ -2033,6 +2119,12 @@ class Node : public RefCounted
      */
     virtual Result total() const = 0;
 
+    /**
+     * @return true if the result may have changed since the stats
+     * were last dumped.
+     */
+    virtual bool changed() const = 0;
+
     /**
      *
      */
@@ -2062,6 +2154,8 @@ class ScalarStatNode : public Node
 
     size_type size() const { return 1; }
 
+    bool changed() const { return data->changed(); }
+
     /**
      *
      */
@@ -2099,6 +2193,12 @@ class ScalarProxyNode : public Node
         return 1;
     }
 
+    bool
+    changed() const
+    {
+        return proxy.changed();
+    }
+
     /**
      *
      */
@@ -2121,6 +2221,8 @@ class VectorStatNode : public Node
 
     size_type size() const { return data->size(); }
 
+    bool changed() const { return data->changed(); }
+
     std::string str() const { return data->name; }
 };
 
@@ -2135,6 +2237,7 @@ class ConstNode : public Node
     const VResult &result() const { return vresult; }
     Result total() const { return vresult[0]; };
     size_type size() const { return 1; }
+    bool changed() const { return false; }
     std::string str() const { return to_string(vresult[0]); }
 };
 
@@ -2159,6 +2262,7 @@ class ConstVectorNode : public Node
     }
 
     size_type size() const { return vresult.size(); }
+    bool changed() const { return false; }
     std::string
     str() const
     {
@@ -2247,6 +2351,7 @@ class UnaryNode : public Node
     }
 
     size_type size() const { return l->size(); }
+    bool changed() const { return l->changed(); }
 
     std::string
     str() const
@@ -2345,6 +2450,8 @@ class BinaryNode : public Node
         }
     }
 
+    bool changed() const { return l->changed() || r->changed(); }
+
     std::string
     str() const
     {
@@ -2396,6 +2503,8 @@ class SumNode : public Node
 
     size_type size() const { return 1; }
 
+    bool changed() const { return l->changed(); }
+
     std::string
     str() const
     {
@@ -2433,6 +2542,10 @@ class Average : public ScalarBase<Average, AvgStor>
 {
   public:
     using ScalarBase<Average, AvgStor>::operator=;
+
+    /** The average moves with time, even without updates. */
+    bool changed() const { return true; }
+    bool changedSinceReset() const { return true; }
 };
 
 class Value : public ValueBase<Value>
@@ -2453,6 +2566,10 @@ class Vector : public VectorBase<Vector, StatStor>
  */
 class AverageVector : public VectorBase<AverageVector, AvgStor>
 {
+  public:
+    /** The averages move with time, even without updates. */
+    bool changed() const { return true; }
+    bool changedSinceReset() const { return true; }
 };
 
 /**
@@ -2548,6 +2665,9 @@ class AverageDeviation : public DistBase<AverageDeviation, AvgSampleStor>
         this->doInit();
         this->setParams(params);
     }
+
+    /** The samples are averaged per tick, so this moves with time. */
+    bool changed() const { return true; }
 };
 
 /**
@@ -2623,6 +2743,9 @@ class VectorAverageDeviation
         this->setParams(params);
         return this->self();
     }
+
+    /** The samples are averaged per tick, so these move with time. */
+    bool changed() const { return true; }
 };
 
 template <class Stat>
@@ -2710,7 +2833,12 @@ class SparseHistBase : public DataWrap<Derived, SparseHistInfoProxy>
      * @param n The number of times to add it, defaults to 1.
      */
     template <typename U>
-    void sample(const U &v, int n = 1) { data()->sample(v, n); }
+    void
+    sample(const U &v, int n = 1)
+    {
+        data()->sample(v, n);
+        this->setChanged();
+    }
 
     /**
      * Return the number of entries in this stat.
@@ -2737,6 +2865,7 @@ class SparseHistBase : public DataWrap<Derived, SparseHistInfoProxy>
     reset()
     {
         data()->reset(this->info());
+        this->resetChanges();
     }
 };
 
@@ -2918,6 +3047,12 @@ class Formula : public DataWrapVec<Formula, FormulaInfoProxy>
      */
     bool zero() const;
 
+    /**
+     * A formula changed if any of the stats it is computed from did.
+     */
+    bool changed() const;
+    bool changedSinceReset() const { return changed(); }
+
     std::string str() const;
 };
 
@@ -2931,6 +3066,7 @@ class FormulaNode : public Node
     FormulaNode(const Formula &f) : formula(f) {}
 
     size_type size() const { return formula.size(); }
+    bool changed() const { return formula.changed(); }
     const VResult &result() const { formula.result(vec); return vec; }
     Result total() const { return formula.total(); }
 
@@ -3172,6 +3308,18 @@ void reset();
 void enable();
 bool enabled();
 
+/**
+ * Note that the current values of all stats were dumped, so that
+ * Info::changed() only reports the stats updated after this call.
+ */
+void markDumped();
+
+/**
+ * Reset only the stats that changed since they were last reset. The
+ * others are still in their reset state.
+ */
+void resetChanged();
+
 /**
  * Register a callback that should be called whenever statistics are
  * reset
@@ -0,0 +1,455 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "base/stats/binary.hh"
+#include "base/stats/info.hh"
+#include "base/callback.hh"
+#include "base/misc.hh"
+#include "base/output.hh"
+#include "base/statistics.hh"
+#include "sim/core.hh"
+
+using namespace std;
+
+namespace Stats {
+
+namespace {
+
+bool
+hostIsLittleEndian()
+{
+    const uint16_t one = 1;
+    return *(const uint8_t *)&one == 1;
+}
+
+}
+
+Binary::Binary()
+    : mystream(false), stream(NULL)
+{
+}
+
+Binary::Binary(const std::string &file)
+    : mystream(false), stream(NULL)
+{
+    open(file);
+}
+
+Binary::~Binary()
+{
+    if (mystream) {
+        assert(stream);
+        delete stream;
+    }
+}
+
+void
+Binary::open(std::ostream &_stream)
+{
+    if (stream)
+        panic("stream already set!");
+
+    mystream = false;
+    stream = &_stream;
+    if (!valid())
+        fatal("Unable to open output stream for writing\n");
+
+    writeHeader();
+}
+
+void
+Binary::open(const std::string &file)
+{
+    if (stream)
+        panic("stream already set!");
+
+    ofstream *fs = new ofstream(file.c_str(), ios::trunc | ios::binary);
+    if (!fs->good())
+        fatal("Unable to open statistics file for writing\n");
+
+    open(*fs);
+    mystream = true;
+}
+
+void
+Binary::relocated()
+{
+    writeHeader();
+
+    schemaLayout.clear();
+    schemaIndex.clear();
+    schemaOffsets.clear();
+    lastValues.clear();
+}
+
+void
+Binary::writeHeader()
+{
+    stream->write("gem5stat", 8);
+    putInt(version, 4);
+    stream->write(record.data(), record.size());
+    record.clear();
+}
+
+bool
+Binary::valid() const
+{
+    return stream != NULL && stream->good();
+}
+
+void
+Binary::putInt(uint64_t val, int bytes)
+{
+    for (int i = 0; i < bytes; ++i)
+        record.push_back((char)(val >> (8 * i)));
+}
+
+void
+Binary::putString(const std::string &str)
+{
+    putInt(str.size(), 4);
+    record.append(str);
+}
+
+void
+Binary::putStrings(const std::vector<std::string> &strs, size_type n)
+{
+    for (size_type i = 0; i < n; ++i)
+        putString(i < strs.size() ? strs[i] : string());
+}
+
+void
+Binary::putValues()
+{
+    if (values.empty())
+        return;
+
+    if (hostIsLittleEndian()) {
+        stream->write((const char *)&values[0],
+                      values.size() * sizeof(Result));
+        return;
+    }
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        uint64_t bits;
+        memcpy(&bits, &values[i], sizeof(bits));
+        putInt(bits, 8);
+    }
+    stream->write(record.data(), record.size());
+    record.clear();
+}
+
+void
+Binary::writeRecord(char type, uint64_t trailing)
+{
+    char header[9];
+    uint64_t length = record.size() + trailing;
+    header[0] = type;
+    for (int i = 0; i < 8; ++i)
+        header[i + 1] = (char)(length >> (8 * i));
+
+    stream->write(header, sizeof(header));
+    stream->write(record.data(), record.size());
+    record.clear();
+}
+
+bool
+Binary::noOutput(const Info &info)
+{
+    // Unlike the text output, stats whose prerequisite is zero are
+    // kept, so that every dump has the same layout
+    return !info.flags.isSet(display);
+}
+
+void
+Binary::addStat(const Info &info, size_type old_size)
+{
+    layout.push_back(make_pair(&info, (uint32_t)(values.size() - old_size)));
+}
+
+void
+Binary::addDist(const DistData &data)
+{
+    const Result fields[distFields] = {
+        (Result)data.type, data.min, data.max, data.bucket_size,
+        data.min_val, data.max_val, data.underflow, data.overflow,
+        data.sum, data.squares, data.logs, data.samples
+    };
+    values.insert(values.end(), fields, fields + distFields);
+    values.insert(values.end(), data.cvec.begin(), data.cvec.end());
+}
+
+void
+Binary::begin()
+{
+    layout.clear();
+    values.clear();
+}
+
+void
+Binary::end()
+{
+    if (layout != schemaLayout)
+        addUnchanged();
+
+    if (layout != schemaLayout) {
+        writeSchema();
+        schemaLayout = layout;
+
+        schemaIndex.clear();
+        schemaOffsets.clear();
+        size_t offset = 0;
+        for (size_t i = 0; i < layout.size(); ++i) {
+            schemaIndex[layout[i].first] = i;
+            schemaOffsets.push_back(offset);
+            offset += layout[i].second;
+        }
+    }
+
+    putInt(curTick(), 8);
+    putInt(values.size(), 4);
+    writeRecord('D', values.size() * sizeof(Result));
+    putValues();
+
+    stream->flush();
+    lastValues.swap(values);
+}
+
+void
+Binary::addUnchanged()
+{
+    vector<pair<const Info *, uint32_t> > all_layout;
+    vector<Result> all_values;
+    all_layout.reserve(schemaLayout.size());
+    all_values.reserve(lastValues.size());
+
+    // Both layouts follow the order the stats are visited in, so the
+    // stats missing from the current dump are the schema entries
+    // skipped between two visited stats.
+    size_t next = 0;
+    size_t offset = 0;
+    for (size_t i = 0; i < layout.size(); ++i) {
+        m5::hash_map<const Info *, size_t>::const_iterator entry =
+            schemaIndex.find(layout[i].first);
+        if (entry != schemaIndex.end() && entry->second >= next) {
+            for (; next < entry->second; ++next) {
+                vector<Result>::const_iterator first =
+                    lastValues.begin() + schemaOffsets[next];
+                all_layout.push_back(schemaLayout[next]);
+                all_values.insert(all_values.end(), first,
+                                  first + schemaLayout[next].second);
+            }
+            ++next;
+        }
+
+        all_layout.push_back(layout[i]);
+        all_values.insert(all_values.end(), values.begin() + offset,
+                          values.begin() + offset + layout[i].second);
+        offset += layout[i].second;
+    }
+
+    for (; next < schemaLayout.size(); ++next) {
+        vector<Result>::const_iterator first =
+            lastValues.begin() + schemaOffsets[next];
+        all_layout.push_back(schemaLayout[next]);
+        all_values.insert(all_values.end(), first,
+                          first + schemaLayout[next].second);
+    }
+
+    layout.swap(all_layout);
+    values.swap(all_values);
+}
+
+void
+Binary::writeSchema()
+{
+    putInt(layout.size(), 4);
+    for (size_t i = 0; i < layout.size(); ++i) {
+        const Info *info = layout[i].first;
+        uint32_t num_values = layout[i].second;
+
+        const FormulaInfo *formula = dynamic_cast<const FormulaInfo *>(info);
+        const VectorInfo *vector = dynamic_cast<const VectorInfo *>(info);
+        const VectorDistInfo *vdist =
+            dynamic_cast<const VectorDistInfo *>(info);
+        const Vector2dInfo *vector2d =
+            dynamic_cast<const Vector2dInfo *>(info);
+
+        Kind kind;
+        if (dynamic_cast<const ScalarInfo *>(info))
+            kind = ScalarKind;
+        else if (formula)
+            kind = FormulaKind;
+        else if (vector)
+            kind = VectorKind;
+        else if (dynamic_cast<const DistInfo *>(info))
+            kind = DistKind;
+        else if (vdist)
+            kind = VectorDistKind;
+        else if (vector2d)
+            kind = Vector2dKind;
+        else if (dynamic_cast<const SparseHistInfo *>(info))
+            kind = SparseHistKind;
+        else
+            panic("Unknown kind of stat %s\n", info->name);
+
+        putInt(kind, 1);
+        putInt(info->flags, 2);
+        putInt((uint32_t)info->precision, 4);
+        putString(info->name);
+        putString(info->desc);
+        putInt(num_values, 4);
+
+        switch (kind) {
+          case VectorKind:
+          case FormulaKind:
+            putStrings(vector->subnames, num_values);
+            break;
+          case VectorDistKind:
+            putInt(vdist->size(), 4);
+            putStrings(vdist->subnames, vdist->size());
+            break;
+          case Vector2dKind:
+            putInt(vector2d->x, 4);
+            putInt(vector2d->y, 4);
+            putStrings(vector2d->subnames, vector2d->x);
+            putStrings(vector2d->y_subnames, vector2d->y);
+            break;
+          default:
+            break;
+        }
+    }
+
+    writeRecord('S');
+}
+
+void
+Binary::visit(const ScalarInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    size_type old_size = values.size();
+    values.push_back(info.result());
+    addStat(info, old_size);
+}
+
+void
+Binary::visit(const VectorInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    size_type old_size = values.size();
+    const VResult &vec = info.result();
+    values.insert(values.end(), vec.begin(), vec.end());
+    addStat(info, old_size);
+}
+
+void
+Binary::visit(const FormulaInfo &info)
+{
+    visit((const VectorInfo &)info);
+}
+
+void
+Binary::visit(const DistInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    size_type old_size = values.size();
+    addDist(info.data);
+    addStat(info, old_size);
+}
+
+void
+Binary::visit(const VectorDistInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    size_type old_size = values.size();
+    for (size_type i = 0; i < info.size(); ++i)
+        addDist(info.data[i]);
+    addStat(info, old_size);
+}
+
+void
+Binary::visit(const Vector2dInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    size_type old_size = values.size();
+    values.insert(values.end(), info.cvec.begin(), info.cvec.end());
+    addStat(info, old_size);
+}
+
+void
+Binary::visit(const SparseHistInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    size_type old_size = values.size();
+    values.push_back(info.data.samples);
+    MCounter::const_iterator it;
+    for (it = info.data.cmap.begin(); it != info.data.cmap.end(); ++it) {
+        values.push_back(it->first);
+        values.push_back(it->second);
+    }
+    addStat(info, old_size);
+}
+
+Output *
+initBinary(const string &filename)
+{
+    static Binary binary;
+    static bool connected = false;
+
+    if (!connected) {
+        ostream *os = simout.find(filename);
+        if (!os)
+            os = simout.create(filename, true);
+
+        binary.open(*os);
+        simout.registerRelocateCallback(
+            new MakeCallback<Binary, &Binary::relocated>(binary));
+        connected = true;
+    }
+
+    return &binary;
+}
+
+} // namespace Stats
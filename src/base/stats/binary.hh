@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_STATS_BINARY_HH__
+#define __BASE_STATS_BINARY_HH__
+
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/stats/output.hh"
+#include "base/stats/types.hh"
+#include "base/hashmap.hh"
+
+namespace Stats {
+
+class Info;
+struct DistData;
+
+/**
+ * Compact binary statistics output. The file starts with a header
+ * and is followed by records. A schema record describes every stat
+ * (its kind, name, description, subnames and the number of values it
+ * has), and a dump record holds the tick of the dump and the raw
+ * values of all stats in schema order, as doubles. The schema is
+ * only written before the first dump and whenever the number of
+ * values of a stat changes (which only happens for sparse
+ * histograms), so periodic dumps only cost a copy of the values.
+ * Stats left out of an incremental dump are written with the values
+ * they had in the previous dump, so the layout of the records does
+ * not change either.
+ *
+ * All integers and doubles are little endian. The header is the
+ * eight characters "gem5stat" followed by the uint32 version. Every
+ * record starts with a uint8 type ('S' or 'D') and the uint64 length
+ * of the rest of the record. See src/python/m5/stats/binary.py for a
+ * reader, which also documents the layout of the records.
+ */
+class Binary : public Output
+{
+  public:
+    /** The version of the format written. */
+    static const uint32_t version = 1;
+
+    /** Kinds of stats, as stored in the schema. */
+    enum Kind {
+        ScalarKind = 0,
+        VectorKind,
+        DistKind,
+        VectorDistKind,
+        Vector2dKind,
+        FormulaKind,
+        SparseHistKind
+    };
+
+    /** Number of values describing a distribution ahead of its buckets. */
+    static const uint32_t distFields = 12;
+
+  protected:
+    bool mystream;
+    std::ostream *stream;
+
+    /** Stats visited in the current dump and their number of values. */
+    std::vector<std::pair<const Info *, uint32_t> > layout;
+
+    /** The layout the last schema written was made for. */
+    std::vector<std::pair<const Info *, uint32_t> > schemaLayout;
+
+    /** Index of every stat in schemaLayout. */
+    m5::hash_map<const Info *, size_t> schemaIndex;
+
+    /** Offset of the values of every stat of schemaLayout. */
+    std::vector<size_t> schemaOffsets;
+
+    /** Values of all stats in the current dump. */
+    std::vector<Result> values;
+
+    /** Values of all stats in the previous dump, in schema order. */
+    std::vector<Result> lastValues;
+
+    /** Buffer a record is assembled in. */
+    std::string record;
+
+    bool noOutput(const Info &info);
+    void addStat(const Info &info, size_type old_size);
+    void addDist(const DistData &data);
+
+    void putInt(uint64_t val, int bytes);
+    void putString(const std::string &str);
+    void putStrings(const std::vector<std::string> &strs, size_type n);
+    void putValues();
+
+    /**
+     * Add the stats of the schema that were not visited in the
+     * current dump, with their values from the previous dump.
+     */
+    void addUnchanged();
+
+    /**
+     * Write out the record assembled in the buffer.
+     * @param type Type of the record.
+     * @param trailing Bytes the caller writes after the buffer.
+     */
+    void writeRecord(char type, uint64_t trailing = 0);
+    void writeHeader();
+    void writeSchema();
+
+  public:
+    Binary();
+    Binary(const std::string &file);
+    ~Binary();
+
+    void open(std::ostream &stream);
+    void open(const std::string &file);
+
+    /**
+     * Start over in a stream that was emptied, as when the output
+     * directory was relocated: write the header again, and forget the
+     * schema, so that the next dump writes it again.
+     */
+    void relocated();
+
+    // Implement Visit
+    virtual void visit(const ScalarInfo &info);
+    virtual void visit(const VectorInfo &info);
+    virtual void visit(const DistInfo &info);
+    virtual void visit(const VectorDistInfo &info);
+    virtual void visit(const Vector2dInfo &info);
+    virtual void visit(const FormulaInfo &info);
+    virtual void visit(const SparseHistInfo &info);
+
+    // Implement Output
+    virtual bool valid() const;
+    virtual void begin();
+    virtual void end();
+};
+
+Output *initBinary(const std::string &filename);
+
+} // namespace Stats
+
+#endif // __BASE_STATS_BINARY_HH__
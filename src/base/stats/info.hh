@@ -128,6 +128,23 @@ class Info
      */
     virtual bool zero() const = 0;
 
+    /**
+     * @return true if the stat may have changed since it was last
+     * dumped, in which case an incremental dump includes it.
+     */
+    virtual bool changed() const { return true; }
+
+    /**
+     * @return true if the stat may have changed since it was last
+     * reset, in which case an incremental reset resets it.
+     */
+    virtual bool changedSinceReset() const { return true; }
+
+    /**
+     * Note that the current value of the stat was dumped.
+     */
+    virtual void dumped() { }
+
     /**
      * Visitor entry for outputing statistics data
      */
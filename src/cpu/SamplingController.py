@@ -0,0 +1,74 @@
+# Copyright (c) 2014 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.SimObject import SimObject
+from m5.params import *
+from m5.proxy import *
+
+class SamplingController(SimObject):
+    type = 'SamplingController'
+    cxx_header = "cpu/sampling_controller.hh"
+
+    @classmethod
+    def export_methods(cls, code):
+        code('''
+    void startFunctional();
+    bool done();
+    unsigned samples();
+    Counter instructions();
+''')
+
+    system = Param.System(Parent.any, "system to sample")
+    functional_cpus = VectorParam.BaseCPU("atomic or KVM CPUs used for "
+                                          "functional warming")
+    detailed_cpus = VectorParam.BaseCPU("CPUs used for detailed warmup "
+                                        "and measurement")
+    warmer = Param.CacheWarmer(NULL, "warms the caches bypassed by the "
+                               "functional CPUs before every switch")
+
+    functional_insts = Param.Counter(1000000, "instructions of functional "
+                                     "warming between samples")
+    warmup_insts = Param.Counter(2000, "instructions of detailed warmup "
+                                 "before every measurement")
+    measure_insts = Param.Counter(1000, "instructions measured per sample")
+    max_samples = Param.Unsigned(0, "number of samples to take "
+                                 "(0 = until the workload ends)")
+
+    # SimPoint style sampling
+    start_insts = VectorParam.Counter([], "instruction counts at which "
+        "the samples start, instead of periodic sampling")
+    weights = VectorParam.Float([], "weights of the samples in start_insts")
+
+    # Used by m5.sampling to aggregate the samples
+    sample_stats = VectorParam.String([], "statistics collected per sample "
+        "(default: the ipc of the detailed CPUs)")
+    confidence = Param.Float(0.95, "confidence level of the intervals")
+    target_error = Param.Float(0.0, "stop once the confidence interval of "
+        "the first statistic is within this fraction of its mean (0 = off)")
+    min_samples = Param.Unsigned(30, "samples to take before checking "
+                                 "target_error")
+    dump_samples = Param.Bool(False, "dump the statistics of every sample")
+
@@ -121,6 +121,17 @@ ActivityRecorder::deactivateStage(const int idx)
     assert(activityCount >= 0);
 }
 
+bool
+ActivityRecorder::anyStageActive() const
+{
+    for (int i = 0; i < numStages; ++i) {
+        if (stageActive[i])
+            return true;
+    }
+
+    return false;
+}
+
 void
 ActivityRecorder::reset()
 {
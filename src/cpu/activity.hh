@@ -83,6 +83,15 @@ class ActivityRecorder
     /** Returns if the CPU should be active. */
     bool active() { return activityCount; }
 
+    /** Returns if any stage is marked as active. */
+    bool anyStageActive() const;
+
+    /** Returns if there was activity the given number of cycles ago,
+     *  where 0 is the cycle the buffer was last advanced to.
+     */
+    bool activityIn(int cycles_ago)
+    { return activityBuffer[-cycles_ago]; }
+
     /** Clears the time buffer and the activity count. */
     void reset();
 
@@ -52,6 +52,7 @@
 #include <queue>
 
 #include "arch/utility.hh"
+#include "base/circular_list.hh"
 #include "base/trace.hh"
 #include "config/the_isa.hh"
 #include "cpu/checker/cpu.hh"
@@ -92,7 +93,7 @@ class BaseDynInst : public RefCounted
     typedef RefCountingPtr<BaseDynInst<Impl> > BaseDynInstPtr;
 
     // The list of instructions iterator type.
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
+    typedef typename CircularList<DynInstPtr>::iterator ListIt;
 
     enum {
         MaxInstSrcRegs = TheISA::MaxInstSrcRegs,        /// Max source regs
@@ -238,6 +239,9 @@ class BaseDynInst : public RefCounted
     /** Store queue index. */
     int16_t sqIdx;
 
+    /** Instruction queue matrix scheduler entry. */
+    int16_t iqIdx;
+
 
     /////////////////////// TLB Miss //////////////////////
     /**
@@ -100,6 +100,7 @@ BaseDynInst<Impl>::initVars()
 
     lqIdx = -1;
     sqIdx = -1;
+    iqIdx = -1;
 
     // Eventually make this a parameter.
     threadNumber = 0;
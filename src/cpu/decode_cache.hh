@@ -31,9 +31,14 @@
 #ifndef __CPU_DECODE_CACHE_HH__
 #define __CPU_DECODE_CACHE_HH__
 
+#include <atomic>
+#include <mutex>
+#include <vector>
+
 #include "arch/isa_traits.hh"
 #include "arch/types.hh"
 #include "base/hashmap.hh"
+#include "base/types.hh"
 #include "config/the_isa.hh"
 #include "cpu/static_inst_fwd.hh"
 
@@ -48,6 +53,158 @@ namespace DecodeCache
 /// Hash for decoded instructions.
 typedef m5::hash_map<TheISA::ExtMachInst, StaticInstPtr> InstMap;
 
+/// Whether decoders share their instructions through a SharedInstMap,
+/// so that they can run in different threads.
+extern bool shared;
+
+/**
+ * A hash map that any number of threads can search without locking
+ * while another thread adds to it. Entries are never removed or
+ * changed, and are published with a release store, so a search either
+ * misses an entry being added or sees all of it. Threads adding
+ * entries must be serialized by the caller. When the table grows the
+ * old one is kept until the map is destroyed, as searches may still
+ * be probing it.
+ *
+ * Values are pointers, with NULL meaning that a key was not found.
+ */
+template<class Key, class Value>
+class SharedMap
+{
+  protected:
+    struct Entry
+    {
+        Entry(const Key &_key, Value _value) : key(_key), value(_value)
+        {}
+
+        const Key key;
+        const Value value;
+    };
+
+    // An open addressing table of entries, probed linearly.
+    struct Table
+    {
+        Table(unsigned size_bits)
+            : mask((1ULL << size_bits) - 1), shift(64 - size_bits),
+              slots(new std::atomic<Entry *>[mask + 1])
+        {
+            for (uint64_t i = 0; i <= mask; ++i)
+                slots[i].store(NULL, std::memory_order_relaxed);
+        }
+
+        ~Table() { delete [] slots; }
+
+        /// The slot to start probing at. The hash is spread with a
+        /// multiplicative hash, as keys like page addresses only
+        /// differ in their upper bits.
+        uint64_t
+        index(const Key &key) const
+        {
+            uint64_t hash = m5::hash<Key>()(key);
+            return (hash * ULL(0x9e3779b97f4a7c15)) >> shift;
+        }
+
+        const uint64_t mask;
+        const unsigned shift;
+        std::atomic<Entry *> *slots;
+    };
+
+    std::atomic<Table *> table;
+    // Tables that were replaced by a larger one.
+    std::vector<Table *> oldTables;
+    std::vector<Entry *> entries;
+
+    /// Store an entry in the first free slot of a table.
+    void
+    place(Table *t, Entry *entry)
+    {
+        uint64_t i = t->index(entry->key);
+        while (t->slots[i].load(std::memory_order_relaxed))
+            i = (i + 1) & t->mask;
+        t->slots[i].store(entry, std::memory_order_release);
+    }
+
+    SharedMap(const SharedMap &);
+    SharedMap &operator=(const SharedMap &);
+
+  public:
+    SharedMap() : table(new Table(6))
+    {}
+
+    ~SharedMap()
+    {
+        delete table.load();
+        for (size_t i = 0; i < oldTables.size(); ++i)
+            delete oldTables[i];
+        for (size_t i = 0; i < entries.size(); ++i)
+            delete entries[i];
+    }
+
+    /// Find the value of a key, NULL if it is not in the map. Safe
+    /// to call from any thread at any time.
+    Value
+    find(const Key &key) const
+    {
+        const Table *t = table.load(std::memory_order_acquire);
+        for (uint64_t i = t->index(key); ; i = (i + 1) & t->mask) {
+            const Entry *entry = t->slots[i].load(std::memory_order_acquire);
+            if (!entry)
+                return NULL;
+            if (entry->key == key)
+                return entry->value;
+        }
+    }
+
+    /// Add a key that is not in the map yet.
+    void
+    insert(const Key &key, Value value)
+    {
+        Table *t = table.load(std::memory_order_relaxed);
+
+        // Keep the table at most half full, so that probes stay short
+        // and always end at an empty slot.
+        if (2 * (entries.size() + 1) > t->mask + 1) {
+            Table *larger = new Table(64 - t->shift + 1);
+            for (size_t i = 0; i < entries.size(); ++i)
+                place(larger, entries[i]);
+            oldTables.push_back(t);
+            table.store(larger, std::memory_order_release);
+            t = larger;
+        }
+
+        Entry *entry = new Entry(key, value);
+        entries.push_back(entry);
+        place(t, entry);
+    }
+
+    /// Number of entries in the map.
+    size_t size() const { return entries.size(); }
+};
+
+/**
+ * Instructions decoded by any of the decoders using it, which may run
+ * in different threads. Instructions are pinned (see
+ * StaticInst::pin()) before they are added, so that they can be
+ * referenced from any thread.
+ */
+class SharedInstMap
+{
+  protected:
+    SharedMap<TheISA::ExtMachInst, StaticInst *> insts;
+
+    /// Serializes decoding the instructions that are not found.
+    std::mutex decodeLock;
+
+  public:
+    /// Look up a machine instruction, decoding it if no decoder using
+    /// this map has decoded it before.
+    /// @param decoder The decoder to decode it with.
+    /// @param mach_inst The binary instruction to decode.
+    /// @retval A pointer to the corresponding StaticInst object.
+    StaticInstPtr decode(TheISA::Decoder *decoder,
+                         const TheISA::ExtMachInst &mach_inst);
+};
+
 /// A sparse map from an Addr to a Value, stored in page chunks.
 template<class Value>
 class AddrMap
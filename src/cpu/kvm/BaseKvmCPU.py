@@ -54,6 +54,8 @@ class BaseKvmCPU(BaseCPU):
     def export_methods(cls, code):
         code('''
       void dump();
+      void schedulePerfStop(const char *event, Counter count,
+                            const char *cause);
 ''')
 
     @classmethod
@@ -74,3 +76,9 @@ class BaseKvmCPU(BaseCPU):
 
     hostFreq = Param.Clock("2GHz", "Host clock frequency")
     hostFactor = Param.Float(1.0, "Cycle scale factor")
+
+    simpoint_profile = Param.Bool(False, "Generate SimPoint BBVs")
+    simpoint_interval = Param.UInt64(100000000, "SimPoint Interval Size (insts)")
+    simpoint_sample_period = Param.UInt64(100000,
+        "Instructions between guest PC samples for SimPoint profiling")
+    simpoint_profile_file = Param.String("simpoint.bb.gz", "SimPoint BBV file")
@@ -47,3 +47,6 @@ class KvmVM(SimObject):
     system = Param.System(Parent.any, "system object")
 
     coalescedMMIO = VectorParam.AddrRange([], "memory ranges for coalesced MMIO")
+
+    warmer = Param.CacheWarmer(NULL, "record the pages written by the "
+                               "guest to warm the caches with")
@@ -42,12 +42,17 @@
 #include <sys/mman.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <csignal>
+#include <cstdlib>
+#include <cstring>
 #include <ostream>
+#include <vector>
 
 #include "arch/mmapped_ipr.hh"
 #include "arch/utility.hh"
+#include "base/output.hh"
 #include "cpu/kvm/base.hh"
 #include "debug/Checkpoint.hh"
 #include "debug/Drain.hh"
@@ -56,6 +61,7 @@
 #include "debug/KvmRun.hh"
 #include "params/BaseKvmCPU.hh"
 #include "sim/process.hh"
+#include "sim/sim_exit.hh"
 #include "sim/system.hh"
 
 #include <signal.h>
@@ -76,15 +82,30 @@ BaseKvmCPU::BaseKvmCPU(BaseKvmCPUParams *params)
       pageSize(sysconf(_SC_PAGE_SIZE)),
       tickEvent(*this),
       activeInstPeriod(0),
+      perfStopType(0), perfStopConfig(0), perfStopCount(0),
+      perfStopPending(false),
       perfControlledByTimer(params->usePerfOverflow),
       hostFactor(params->hostFactor),
       drainManager(NULL),
-      ctrInsts(0)
+      ctrInsts(0),
+      simpoint(params->simpoint_profile),
+      intervalSize(params->simpoint_interval),
+      simpointSamplePeriod(params->simpoint_sample_period),
+      simpointNextSample(params->simpoint_sample_period),
+      simpointLastSample(0),
+      intervalCount(0),
+      simpointStream(NULL)
 {
     if (pageSize == -1)
         panic("KVM: Failed to determine host page size (%i)\n",
               errno);
 
+    if (simpoint) {
+        if (!simpointSamplePeriod)
+            fatal("%s: SimPoint sample period can't be 0\n", name());
+        simpointStream = simout.create(params->simpoint_profile_file, false);
+    }
+
     thread = new SimpleThread(this, 0, params->system,
                               params->itb, params->dtb, params->isa[0]);
     thread->setStatus(ThreadContext::Halted);
@@ -97,6 +118,8 @@ BaseKvmCPU::~BaseKvmCPU()
     if (_kvmRun)
         munmap(_kvmRun, vcpuMMapSize);
     close(vcpuFD);
+    if (simpointStream)
+        simout.close(simpointStream);
 }
 
 void
@@ -366,6 +389,16 @@ BaseKvmCPU::drainResume()
     }
 }
 
+void
+BaseKvmCPU::notifyFork()
+{
+    // The vCPU belongs to the VM of the parent, which can't be used
+    // from another process.
+    if (!switchedOut())
+        fatal("%s: Can't fork the simulator while a KVM CPU is active\n",
+              name());
+}
+
 void
 BaseKvmCPU::switchOut()
 {
@@ -531,6 +564,7 @@ BaseKvmCPU::tick()
           // Setup any pending instruction count breakpoints using
           // PerfEvent.
           setupInstStop();
+          setupPerfStop();
 
           DPRINTF(KvmRun, "Entering KVM...\n");
           if (drainManager) {
@@ -563,6 +597,10 @@ BaseKvmCPU::tick()
               _status = Running;
           }
 
+          if (simpoint)
+              profileSimPoint();
+          checkPerfStop();
+
           // Service any pending instruction events. The vCPU should
           // have exited in time for the event using the instruction
           // counter configured by setupInstStop().
@@ -1195,11 +1233,17 @@ BaseKvmCPU::ioctlRun()
 void
 BaseKvmCPU::setupInstStop()
 {
-    if (comInstEventQueue[0]->empty()) {
+    uint64_t next(0);
+    if (!comInstEventQueue[0]->empty())
+        next = comInstEventQueue[0]->nextTick();
+
+    // The SimPoint profiler needs an exit at every PC sample
+    if (simpoint && (!next || simpointNextSample < next))
+        next = simpointNextSample;
+
+    if (!next) {
         setupInstCounter(0);
     } else {
-        const uint64_t next(comInstEventQueue[0]->nextTick());
-
         assert(next > ctrInsts);
         setupInstCounter(next - ctrInsts);
     }
@@ -1242,3 +1286,136 @@ BaseKvmCPU::setupInstCounter(uint64_t period)
 
     activeInstPeriod = period;
 }
+
+void
+BaseKvmCPU::schedulePerfStop(const char *event, Counter count,
+                             const char *cause)
+{
+    static const struct {
+        const char *name;
+        uint64_t config;
+    } hwEvents[] = {
+        { "cycles", PERF_COUNT_HW_CPU_CYCLES },
+        { "instructions", PERF_COUNT_HW_INSTRUCTIONS },
+        { "branches", PERF_COUNT_HW_BRANCH_INSTRUCTIONS },
+        { "branch-misses", PERF_COUNT_HW_BRANCH_MISSES },
+        { "cache-references", PERF_COUNT_HW_CACHE_REFERENCES },
+        { "cache-misses", PERF_COUNT_HW_CACHE_MISSES },
+    };
+
+    if (count <= 0)
+        fatal("%s: Perf stop on '%s' needs a positive count\n",
+              name(), event);
+
+    if (strncmp(event, "raw:", 4) == 0) {
+        char *end;
+        perfStopType = PERF_TYPE_RAW;
+        perfStopConfig = strtoull(event + 4, &end, 0);
+        if (end == event + 4 || *end != '\0')
+            fatal("%s: Invalid raw perf event '%s'\n", name(), event);
+    } else {
+        const int num_events(sizeof(hwEvents) / sizeof(hwEvents[0]));
+        int i(0);
+        while (i < num_events && strcmp(event, hwEvents[i].name) != 0)
+            ++i;
+        if (i == num_events)
+            fatal("%s: Unknown perf event '%s'\n", name(), event);
+
+        perfStopType = PERF_TYPE_HARDWARE;
+        perfStopConfig = hwEvents[i].config;
+    }
+
+    DPRINTF(Kvm, "Stopping after %i %s events\n", count, event);
+    perfStopCount = count;
+    perfStopCause = cause;
+    perfStopPending = true;
+}
+
+void
+BaseKvmCPU::setupPerfStop()
+{
+    if (!perfStopPending)
+        return;
+
+    PerfKvmCounterConfig cfgStop(perfStopType, perfStopConfig);
+
+    // Count guest events only, see setupCounters()
+    cfgStop.exclude_hv(true)
+        .exclude_host(true)
+        .wakeupEvents(1)
+        .samplePeriod(perfStopCount);
+
+    if (hwPerfStop.attached())
+        hwPerfStop.detach();
+    assert(hwCycles.attached());
+    hwPerfStop.attach(cfgStop,
+                      0, // TID (0 => currentThread)
+                      hwCycles);
+    hwPerfStop.enableSignals(KVM_KICK_SIGNAL);
+
+    perfStopPending = false;
+}
+
+void
+BaseKvmCPU::checkPerfStop()
+{
+    if (!hwPerfStop.attached() || hwPerfStop.read() < perfStopCount)
+        return;
+
+    DPRINTF(Kvm, "Perf stop reached after %i events\n", hwPerfStop.read());
+    hwPerfStop.detach();
+    exitSimLoop(perfStopCause);
+}
+
+Addr
+BaseKvmCPU::sampleInstAddr()
+{
+    syncThreadContext();
+    return tc->instAddr();
+}
+
+void
+BaseKvmCPU::profileSimPoint()
+{
+    // The vCPU might have exited before the sample was due
+    if (ctrInsts < simpointNextSample)
+        return;
+
+    const Addr pc(sampleInstAddr());
+    const uint64_t insts(ctrInsts - simpointLastSample);
+    simpointLastSample = ctrInsts;
+    simpointNextSample = ctrInsts + simpointSamplePeriod;
+
+    m5::hash_map<Addr, PCInfo>::iterator pc_itr(pcMap.find(pc));
+    if (pc_itr == pcMap.end()) {
+        PCInfo info;
+        info.id = pcMap.size() + 1;
+        info.count = insts;
+        pcMap.insert(std::make_pair(pc, info));
+    } else {
+        pc_itr->second.count += insts;
+    }
+
+    intervalCount += insts;
+    if (intervalCount < intervalSize)
+        return;
+
+    // Summarize the interval in the format of the atomic CPU
+    std::vector<std::pair<uint64_t, uint64_t> > counts;
+    for (pc_itr = pcMap.begin(); pc_itr != pcMap.end(); ++pc_itr) {
+        PCInfo &info(pc_itr->second);
+        if (info.count != 0) {
+            counts.push_back(std::make_pair(info.id, info.count));
+            info.count = 0;
+        }
+    }
+    std::sort(counts.begin(), counts.end());
+
+    *simpointStream << "T";
+    for (int i = 0; i < counts.size(); ++i)
+        *simpointStream << ":" << counts[i].first
+                        << ":" << counts[i].second << " ";
+    *simpointStream << "\n";
+
+    intervalCount -= intervalSize;
+}
@@ -44,7 +44,9 @@
 
 #include <csignal>
 #include <memory>
+#include <string>
 
+#include "base/hashmap.hh"
 #include "base/statistics.hh"
 #include "cpu/kvm/perfevent.hh"
 #include "cpu/kvm/timer.hh"
@@ -91,6 +93,8 @@ class BaseKvmCPU : public BaseCPU
     unsigned int drain(DrainManager *dm);
     void drainResume();
 
+    void notifyFork();
+
     void switchOut();
     void takeOverFrom(BaseCPU *cpu);
 
@@ -113,6 +117,25 @@ class BaseKvmCPU : public BaseCPU
     /** Dump the internal state to the terminal. */
     virtual void dump();
 
+    /**
+     * Exit the simulation loop once the guest has caused a number of
+     * hardware events.
+     *
+     * The event is counted by a perf counter in the guest counter
+     * group, which interrupts KVM when it overflows, so the guest
+     * keeps running at native speed until the target is reached.
+     * Instruction counts are better handled through
+     * scheduleInstStop(), which is exact.
+     *
+     * @param event Name of a generic hardware event (cycles,
+     * instructions, branches, branch-misses, cache-references or
+     * cache-misses), or raw:CONFIG for a model specific event.
+     * @param count Number of events to run for.
+     * @param cause Cause of the simulation loop exit.
+     */
+    void schedulePerfStop(const char *event, Counter count,
+                          const char *cause);
+
     /**
      * Force an exit from KVM.
      *
@@ -331,6 +354,16 @@ class BaseKvmCPU : public BaseCPU
     void setSpecialRegisters(const struct kvm_sregs &regs);
     /** @} */
 
+    /**
+     * Get the address of the next guest instruction for SimPoint
+     * profiling.
+     *
+     * The default implementation synchronizes the whole thread
+     * context. Architectures should override this to read the PC
+     * directly from KVM since it is called at every profiling sample.
+     */
+    virtual Addr sampleInstAddr();
+
     /** @{ */
     /**
      * Get/Set the guest FPU/vector state
@@ -707,6 +740,29 @@ class BaseKvmCPU : public BaseCPU
     /** Currently active instruction count breakpoint */
     uint64_t activeInstPeriod;
 
+    /**
+     * Attach the counter requested by schedulePerfStop(). This has
+     * to happen in the vCPU thread for the overflow signal to be
+     * delivered to it.
+     */
+    void setupPerfStop();
+
+    /** Exit the simulation loop if the perf stop target is reached. */
+    void checkPerfStop();
+
+    /** @{ */
+    /** Event, target and exit cause of a pending perf stop */
+    uint32_t perfStopType;
+    uint64_t perfStopConfig;
+    uint64_t perfStopCount;
+    std::string perfStopCause;
+    /** The counter needs to be (re-)attached before entering KVM */
+    bool perfStopPending;
+    /** @} */
+
+    /** Guest event counter triggering the perf stop. */
+    PerfKvmCounter hwPerfStop;
+
     /**
      * Guest cycle counter.
      *
@@ -774,6 +830,56 @@ class BaseKvmCPU : public BaseCPU
 
     /** Number of instructions executed by the CPU */
     Counter ctrInsts;
+
+  private:
+    /**
+     * Profile basic blocks for SimPoints.
+     *
+     * KVM doesn't let us observe every basic block, so the profile
+     * is built by sampling the guest PC every simpointSamplePeriod
+     * instructions using the instruction counter overflow. Every
+     * sampled PC stands for a basic block and is credited with the
+     * instructions executed since the previous sample. The output
+     * has the same format as the one of the atomic CPU, and
+     * converges to the basic block vectors of the interval as the
+     * sample period decreases.
+     */
+    void profileSimPoint();
+
+    /** Data structures for SimPoint BBV generation
+     *  @{
+     */
+
+    /** Whether SimPoint BBV profiling is enabled */
+    const bool simpoint;
+    /** SimPoint profiling interval size in instructions */
+    const uint64_t intervalSize;
+    /** Instructions between PC samples */
+    const uint64_t simpointSamplePeriod;
+
+    /** Instruction count at which the next PC sample is taken */
+    Counter simpointNextSample;
+    /** Instruction count at the previous PC sample */
+    Counter simpointLastSample;
+    /** Instructions profiled in the current interval */
+    uint64_t intervalCount;
+    /** Pointer to SimPoint BBV output stream */
+    std::ostream *simpointStream;
+
+    /** Sampled PC information */
+    struct PCInfo {
+        /** Unique ID */
+        uint64_t id;
+        /** Instructions credited to the PC in the current interval */
+        uint64_t count;
+    };
+
+    /** Hash table containing all previously sampled PCs */
+    m5::hash_map<Addr, PCInfo> pcMap;
+
+    /** @}
+     *  End of data structures for SimPoint BBV generation
+     */
 };
 
 #endif
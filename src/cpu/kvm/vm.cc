@@ -286,11 +286,15 @@ KvmVM::KvmVM(KvmVMParams *params)
       kvm(), system(params->system),
       vmFD(kvm.createVM()),
       started(false),
-      nextVCPUID(0)
+      nextVCPUID(0),
+      warmer(params->warmer)
 {
     /* Setup the coalesced MMIO regions */
     for (int i = 0; i < params->coalescedMMIO.size(); ++i)
         coalesceMMIO(params->coalescedMMIO[i]);
+
+    if (warmer)
+        warmer->addSource(this);
 }
 
 KvmVM::~KvmVM()
@@ -323,7 +327,13 @@ KvmVM::delayedStartup()
             DPRINTF(Kvm, "Mapping region: 0x%p -> 0x%llx [size: 0x%llx]\n",
                     pmem, range.start(), range.size());
 
-            setUserMemoryRegion(slot, pmem, range, 0 /* flags */);
+            if (warmer) {
+                setUserMemoryRegion(slot, pmem, range,
+                                    KVM_MEM_LOG_DIRTY_PAGES);
+                dirtyLogSlots.push_back(std::make_pair(slot, range));
+            } else {
+                setUserMemoryRegion(slot, pmem, range, 0 /* flags */);
+            }
         } else {
             DPRINTF(Kvm, "Zero-region not mapped: [0x%llx]\n", range.start());
             hack("KVM: Zero memory handled as IO\n");
@@ -369,6 +379,63 @@ KvmVM::setUserMemoryRegion(uint32_t slot,
     }
 }
 
+void
+KvmVM::getDirtyLog(uint32_t slot, std::vector<uint64_t> &bitmap)
+{
+    struct kvm_dirty_log log;
+
+    memset(&log, 0, sizeof(log));
+    log.slot = slot;
+    log.dirty_bitmap = &bitmap[0];
+
+    if (ioctl(KVM_GET_DIRTY_LOG, (void *)&log) == -1)
+        panic("KVM: Failed to get the dirty page log of slot %i (%i)\n",
+              slot, errno);
+}
+
+void
+KvmVM::clearAccesses()
+{
+    std::vector<uint64_t> bitmap;
+    const uint64_t page_size(sysconf(_SC_PAGESIZE));
+
+    for (int i = 0; i < dirtyLogSlots.size(); ++i) {
+        const uint64_t pages(dirtyLogSlots[i].second.size() / page_size);
+        bitmap.resize((pages + 63) / 64);
+        getDirtyLog(dirtyLogSlots[i].first, bitmap);
+    }
+}
+
+void
+KvmVM::recordAccesses(CacheWarmer &warmer)
+{
+    std::vector<uint64_t> bitmap;
+    const uint64_t page_size(sysconf(_SC_PAGESIZE));
+    const unsigned blk_size(system->cacheLineSize());
+
+    for (int i = 0; i < dirtyLogSlots.size(); ++i) {
+        const AddrRange &range(dirtyLogSlots[i].second);
+        const uint64_t pages(range.size() / page_size);
+        bitmap.assign((pages + 63) / 64, 0);
+        getDirtyLog(dirtyLogSlots[i].first, bitmap);
+
+        uint64_t dirty(0);
+        for (uint64_t page = 0; page < pages; ++page) {
+            if (!(bitmap[page / 64] & (1ULL << (page % 64))))
+                continue;
+
+            ++dirty;
+            const Addr start(range.start() + page * page_size);
+            for (Addr addr = start; addr < start + page_size;
+                 addr += blk_size)
+                warmer.record(CacheWarmer::NoCPU, CacheWarmer::Write, addr);
+        }
+
+        DPRINTF(Kvm, "%i dirty page(s) in slot %i\n",
+                dirty, dirtyLogSlots[i].first);
+    }
+}
+
 void
 KvmVM::coalesceMMIO(const AddrRange &range)
 {
@@ -43,6 +43,7 @@
 #include <vector>
 
 #include "base/addr_range.hh"
+#include "mem/cache_warmer.hh"
 #include "sim/sim_object.hh"
 
 // forward declarations
@@ -268,7 +269,7 @@ class Kvm
  * the initialization code once when the first CPU in the VM is
  * starting.
  */
-class KvmVM : public SimObject
+class KvmVM : public SimObject, public CacheWarmer::Source
 {
     friend class BaseKvmCPU;
 
@@ -331,6 +332,19 @@ class KvmVM : public SimObject
     bool hasKernelIRQChip() const { return _hasKernelIRQChip; }
     /** @} */
 
+    /**
+     * @{
+     * @name Cache warming
+     *
+     * KVM can't report the individual memory accesses of the guest,
+     * only the pages it has written since the log was last read. When
+     * a cache warmer is attached, guest memory is mapped with dirty
+     * page logging and every block of the written pages is recorded.
+     */
+    void clearAccesses();
+    void recordAccesses(CacheWarmer &warmer);
+    /** @} */
+
     /** Global KVM interface */
     Kvm kvm;
 
@@ -437,6 +451,20 @@ class KvmVM : public SimObject
 
     /** Next unallocated vCPU ID */
     long nextVCPUID;
+
+    /** Cache warmer to report the written pages to, if any */
+    CacheWarmer *warmer;
+
+    /** Memory slots mapped with dirty page logging */
+    std::vector<std::pair<uint32_t, AddrRange> > dirtyLogSlots;
+
+    /**
+     * Read and clear the dirty page log of a memory slot.
+     *
+     * @param slot KVM memory slot ID
+     * @param bitmap Bitmap with one bit per page of the slot
+     */
+    void getDirtyLog(uint32_t slot, std::vector<uint64_t> &bitmap);
 };
 
 #endif
@@ -1270,6 +1270,14 @@ X86KvmCPU::getHostCycles() const
     return getMSR(MSR_TSC);
 }
 
+Addr
+X86KvmCPU::sampleInstAddr()
+{
+    struct kvm_regs regs;
+    getRegisters(regs);
+    return regs.rip;
+}
+
 void
 X86KvmCPU::handleIOMiscReg32(int miscreg)
 {
@@ -85,6 +85,13 @@ class X86KvmCPU : public BaseKvmCPU
 
     uint64_t getHostCycles() const;
 
+    /**
+     * Read RIP directly from KVM. The CS base is ignored, which
+     * doesn't matter for profiling and saves fetching the special
+     * registers.
+     */
+    Addr sampleInstAddr();
+
     /**
      * Methods to access CPUID information using the extended
      * API. Only available if Kvm::capExtendedCPUID() is true.
@@ -34,6 +34,8 @@ from FUPool import *
 from O3Checker import O3Checker
 from BranchPredictor import BranchPredictor
 
+class IQScheduler(Enum): vals = ['List', 'Matrix']
+
 class DerivO3CPU(BaseCPU):
     type = 'DerivO3CPU'
     cxx_header = 'cpu/o3/deriv.hh'
@@ -51,6 +53,8 @@ class DerivO3CPU(BaseCPU):
         return True
 
     activity = Param.Unsigned(0, "Initial count")
+    skipIdleCycles = Param.Bool(False, "Skip the cycles in which no stage "
+        "has work to do and no communication between stages arrives")
 
     cachePorts = Param.Unsigned(200, "Cache Ports")
 
@@ -126,7 +130,11 @@ class DerivO3CPU(BaseCPU):
     numPhysCCRegs = Param.Unsigned(_defaultNumPhysCCRegs,
                                    "Number of physical cc registers")
     numIQEntries = Param.Unsigned(64, "Number of instruction queue entries")
+    iqScheduler = Param.IQScheduler('List', "Instruction queue scheduler: "
+        "dependency and ready lists, or wakeup and age matrices")
     numROBEntries = Param.Unsigned(192, "Number of reorder buffer entries")
+    debugDynInstPool = Param.Bool(False, "Poison recycled dynamic "
+        "instructions to catch stale references to them")
 
     smtNumFetchingThreads = Param.Unsigned(1, "SMT Number of Fetching Threads")
     smtFetchPolicy = Param.String('SingleThread', "SMT Fetch policy")
@@ -44,6 +44,8 @@
  *          Rick Strong
  */
 
+#include <algorithm>
+
 #include "arch/kernel_stats.hh"
 #include "config/the_isa.hh"
 #include "cpu/checker/cpu.hh"
@@ -214,6 +216,11 @@ FullO3CPU<Impl>::FullO3CPU(DerivO3CPUParams *params)
       itb(params->itb),
       dtb(params->dtb),
       tickEvent(this),
+      // Everything in flight: the ROB, and whatever is queued between
+      // the front-end stages
+      dynInstPool(name() + ".dynInstPool", params->numROBEntries +
+                  3 * params->forwardComSize * params->fetchWidth,
+                  params->debugDynInstPool),
 #ifndef NDEBUG
       instcount(0),
 #endif
@@ -253,8 +260,33 @@ FullO3CPU<Impl>::FullO3CPU(DerivO3CPUParams *params)
       globalSeqNum(1),
       system(params->system),
       drainManager(NULL),
-      lastRunningCycle(curCycle())
-{
+      lastRunningCycle(curCycle()),
+      skipIdleCycles(params->skipIdleCycles),
+      skippingCycles(false)
+{
+    instList.reserve(dynInstPool.capacity());
+
+    // Every delay with which a stage reads a time buffer, used to
+    // work out when communication in flight reaches its destination
+    const Cycles delays[] = {
+        params->decodeToFetchDelay, params->renameToFetchDelay,
+        params->iewToFetchDelay, params->commitToFetchDelay,
+        params->renameToDecodeDelay, params->iewToDecodeDelay,
+        params->commitToDecodeDelay, params->fetchToDecodeDelay,
+        params->iewToRenameDelay, params->commitToRenameDelay,
+        params->decodeToRenameDelay, params->commitToIEWDelay,
+        params->renameToIEWDelay, params->issueToExecuteDelay,
+        params->iewToCommitDelay, params->renameToROBDelay
+    };
+    for (int i = 0; i < sizeof(delays) / sizeof(delays[0]); ++i)
+        commDelays.push_back(delays[i]);
+    std::sort(commDelays.begin(), commDelays.end());
+    commDelays.erase(std::unique(commDelays.begin(), commDelays.end()),
+                     commDelays.end());
+    if (commDelays.back() > params->backComSize + params->forwardComSize)
+        fatal("%s: Stage delays are longer than the time buffers\n",
+              name());
+
     if (!params->switched_out) {
         _status = Running;
     } else {
@@ -496,6 +528,12 @@ FullO3CPU<Impl>::regStats()
               "to idling")
         .prereq(idleCycles);
 
+    skippedCycles
+        .name(name() + ".skippedCycles")
+        .desc("Number of cycles skipped because no stage had work to do "
+              "and no communication between stages was arriving")
+        .prereq(skippedCycles);
+
     quiesceCycles
         .name(name() + ".quiesceCycles")
         .desc("Total number of cycles that CPU has spent quiesced or waiting "
@@ -602,6 +640,11 @@ FullO3CPU<Impl>::tick()
 
     ++numCycles;
 
+    if (skippingCycles) {
+        advanceSkippedCycles();
+        skippingCycles = false;
+    }
+
 //    activity = false;
 
     //Tick each of the stages
@@ -642,8 +685,19 @@ FullO3CPU<Impl>::tick()
             lastRunningCycle = curCycle();
             timesIdled++;
         } else {
-            schedule(tickEvent, clockEdge(Cycles(1)));
-            DPRINTF(O3CPU, "Scheduling next tick!\n");
+            int idle = skipIdleCycles ? idleCyclesAhead() : 0;
+            if (idle) {
+                lastRunningCycle = curCycle();
+                skippingCycles = true;
+            }
+
+            if (idle < 0) {
+                DPRINTF(O3CPU, "Quiescent, waiting to be woken!\n");
+            } else {
+                schedule(tickEvent, clockEdge(Cycles(idle + 1)));
+                DPRINTF(O3CPU, "Scheduling next tick in %i cycles!\n",
+                        idle + 1);
+            }
         }
     }
 
@@ -782,6 +836,8 @@ FullO3CPU<Impl>::activateContext(ThreadID tid, Cycles delay)
     // If we are time 0 or if the last activation time is in the past,
     // schedule the next tick and wake up the fetch unit
     if (lastActivatedCycle == 0 || lastActivatedCycle < curTick()) {
+        if (skippingCycles)
+            advanceSkippedCycles();
         scheduleTickEvent(delay);
 
         // Be sure to signal that there's some activity so the CPU doesn't
@@ -1313,6 +1369,7 @@ FullO3CPU<Impl>::drainResume()
     }
 
     assert(!tickEvent.scheduled());
+    skippingCycles = false;
     if (_status == Running)
         schedule(tickEvent, nextCycle());
 }
@@ -1325,6 +1382,7 @@ FullO3CPU<Impl>::switchOut()
     BaseCPU::switchOut();
 
     activityRec.reset();
+    skippingCycles = false;
 
     _status = SwitchedOut;
 
@@ -1776,10 +1834,54 @@ FullO3CPU<Impl>::wakeDependents(DynInstPtr &inst)
     iew.wakeDependents(inst);
 }
 */
+template <class Impl>
+void
+FullO3CPU<Impl>::advanceSkippedCycles()
+{
+    if (curCycle() <= lastRunningCycle + 1)
+        return;
+
+    // Nothing arrived at any stage in the skipped cycles, so the
+    // stages would only have moved the time buffers along
+    Cycles cycles(curCycle() - lastRunningCycle - 1);
+    skippedCycles += cycles;
+    numCycles += cycles;
+
+    int advance = std::min<int>(cycles, timeBuffer.getSize());
+    for (int i = 0; i < advance; ++i) {
+        timeBuffer.advance();
+        fetchQueue.advance();
+        decodeQueue.advance();
+        renameQueue.advance();
+        iewQueue.advance();
+        activityRec.advance();
+    }
+    iew.advanceSkippedCycles(cycles);
+
+    lastRunningCycle = Cycles(curCycle() - 1);
+}
+
 template <class Impl>
 void
 FullO3CPU<Impl>::wakeCPU()
 {
+    if (skippingCycles) {
+        // Whoever woke us is about to write to the time buffers or
+        // record activity, which has to land in the slots of the
+        // current cycle rather than of the last one ticked
+        advanceSkippedCycles();
+
+        // Tick on the next edge we have not ticked on yet
+        Tick when = curCycle() > lastRunningCycle ?
+            clockEdge() : clockEdge(Cycles(1));
+        DPRINTF(Activity, "Waking up CPU from skipping cycles\n");
+        if (!tickEvent.scheduled())
+            schedule(tickEvent, when);
+        else if (tickEvent.when() > when)
+            reschedule(tickEvent, when);
+        return;
+    }
+
     if (activityRec.active() || tickEvent.scheduled()) {
         DPRINTF(Activity, "CPU already running.\n");
         return;
@@ -1797,6 +1899,31 @@ FullO3CPU<Impl>::wakeCPU()
     schedule(tickEvent, clockEdge());
 }
 
+template <class Impl>
+int
+FullO3CPU<Impl>::idleCyclesAhead()
+{
+    // Stages with work to do, loads and stores waiting for the cache
+    // to unblock, and the rotation of thread priorities all need the
+    // CPU to tick every cycle
+    if (activityRec.anyStageActive() || iew.ldstQueue.cacheBlocked() ||
+        activeThreads.size() > 1)
+        return 0;
+
+    // Communication written n cycles ago reaches a stage reading it
+    // with a delay of d cycles d - n cycles after the next one
+    int longest = commDelays.back();
+    for (int cycles = 0; cycles <= longest; ++cycles) {
+        for (int i = 0; i < commDelays.size(); ++i) {
+            int age = commDelays[i] - cycles;
+            if (age >= 0 && activityRec.activityIn(age))
+                return cycles;
+        }
+    }
+
+    return -1;
+}
+
 template <class Impl>
 void
 FullO3CPU<Impl>::wakeup()
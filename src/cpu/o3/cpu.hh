@@ -54,10 +54,12 @@
 #include <vector>
 
 #include "arch/types.hh"
+#include "base/circular_list.hh"
 #include "base/statistics.hh"
 #include "config/the_isa.hh"
 #include "cpu/o3/comm.hh"
 #include "cpu/o3/cpu_policy.hh"
+#include "cpu/o3/dyn_inst_pool.hh"
 #include "cpu/o3/scoreboard.hh"
 #include "cpu/o3/thread_state.hh"
 #include "cpu/activity.hh"
@@ -106,7 +108,7 @@ class FullO3CPU : public BaseO3CPU
     typedef O3ThreadState<Impl> ImplState;
     typedef O3ThreadState<Impl> Thread;
 
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
+    typedef typename CircularList<DynInstPtr>::iterator ListIt;
 
     friend class O3ThreadContext<Impl>;
 
@@ -220,6 +222,8 @@ class FullO3CPU : public BaseO3CPU
             reschedule(tickEvent, clockEdge(delay));
         else if (!tickEvent.scheduled())
             schedule(tickEvent, clockEdge(delay));
+        else if (skippingCycles && tickEvent.when() > clockEdge(delay))
+            reschedule(tickEvent, clockEdge(delay));
     }
 
     /** Unschedule tick event, regardless of its current state. */
@@ -628,13 +632,19 @@ class FullO3CPU : public BaseO3CPU
     void dumpInsts();
 
   public:
+    /** Memory for the dynamic instructions, which must outlive them. */
+    DynInstPool dynInstPool;
+
 #ifndef NDEBUG
     /** Count of total number of dynamic instructions in flight. */
     int instcount;
 #endif
 
-    /** List of all the instructions in flight. */
-    std::list<DynInstPtr> instList;
+    /** List of all the instructions in flight. Instructions squashed in
+     *  the middle of the list (with SMT) leave holes behind until the
+     *  ones around them are removed.
+     */
+    CircularList<DynInstPtr> instList;
 
     /** List of all the instructions that will be removed at the end of this
      *  cycle.
@@ -761,6 +771,20 @@ class FullO3CPU : public BaseO3CPU
     /** Wakes the CPU, rescheduling the CPU if it's not already active. */
     void wakeCPU();
 
+    /**
+     * Advances the time buffers and the activity recorder over the
+     * cycles skipped since lastRunningCycle, so that writes made
+     * outside of tick() go to the slots of the current cycle.
+     */
+    void advanceSkippedCycles();
+
+    /**
+     * Returns how many cycles after the next one the CPU can skip
+     * because no stage has work to do and no communication between
+     * the stages arrives, or -1 if nothing is in flight at all.
+     */
+    int idleCyclesAhead();
+
     virtual void wakeup();
 
     /** Gets a free thread id. Use if thread ids change across system. */
@@ -798,9 +822,22 @@ class FullO3CPU : public BaseO3CPU
     /** Threads Scheduled to Enter CPU */
     std::list<int> cpuWaitList;
 
-    /** The cycle that the CPU was last running, used for statistics. */
+    /**
+     * The cycle that the CPU was last running, used for statistics.
+     * While skipping cycles, the last cycle the time buffers have
+     * been advanced over.
+     */
     Cycles lastRunningCycle;
 
+    /** Whether to skip cycles in which the pipeline is quiescent. */
+    const bool skipIdleCycles;
+
+    /** Whether the CPU is skipping cycles since lastRunningCycle. */
+    bool skippingCycles;
+
+    /** Distinct latencies of the communication between the stages. */
+    std::vector<int> commDelays;
+
     /** The cycle that the CPU was last activated by a new thread*/
     Tick lastActivatedCycle;
 
@@ -836,6 +873,8 @@ class FullO3CPU : public BaseO3CPU
     Stats::Scalar timesIdled;
     /** Stat for total number of cycles the CPU spends descheduled. */
     Stats::Scalar idleCycles;
+    /** Stat for total number of quiescent cycles the CPU skipped. */
+    Stats::Scalar skippedCycles;
     /** Stat for total number of cycles the CPU spends descheduled due to a
      * quiesce operation or waiting for an interrupt. */
     Stats::Scalar quiesceCycles;
@@ -47,6 +47,7 @@
 #include "arch/isa_traits.hh"
 #include "config/the_isa.hh"
 #include "cpu/o3/cpu.hh"
+#include "cpu/o3/dyn_inst_pool.hh"
 #include "cpu/o3/isa_specific.hh"
 #include "cpu/base_dyn_inst.hh"
 #include "cpu/inst_seq.hh"
@@ -93,6 +94,41 @@ class BaseO3DynInst : public BaseDynInst<Impl>
 
     ~BaseO3DynInst();
 
+    /** Allocate an instruction from the pool of a CPU. */
+    static void *
+    operator new(size_t size, DynInstPool &pool)
+    {
+        return pool.allocate(size);
+    }
+
+    /** Allocate an instruction that doesn't belong to a CPU. */
+    static void *
+    operator new(size_t size)
+    {
+        return DynInstPool::allocateUnpooled(size);
+    }
+
+    static void operator delete(void *p) { DynInstPool::release(p); }
+
+    static void
+    operator delete(void *p, DynInstPool &pool)
+    {
+        DynInstPool::release(p);
+    }
+
+    /**
+     * Allocate the buffer for the data of a memory access, which is
+     * part of the instruction unless the access is unusually large.
+     */
+    uint8_t *
+    allocMemData(unsigned size)
+    {
+        assert(!this->memData);
+        this->memData = size <= sizeof(memDataBuf) ?
+            (uint8_t *)memDataBuf : new uint8_t[size];
+        return this->memData;
+    }
+
     /** Executes the instruction.*/
     Fault execute();
 
@@ -119,6 +155,9 @@ class BaseO3DynInst : public BaseDynInst<Impl>
     /** Number of destination misc. registers. */
     uint8_t _numDestMiscRegs;
 
+    /** Storage for the data of memory accesses up to 64 bytes. */
+    uint64_t memDataBuf[8];
+
 
   public:
 #if TRACING_ON
@@ -99,6 +99,10 @@ template <class Impl>BaseO3DynInst<Impl>::~BaseO3DynInst()
         }
     }
 #endif
+
+    // Keep the base class from deleting the embedded data buffer
+    if (this->memData == (uint8_t *)memDataBuf)
+        this->memData = NULL;
 };
 
 
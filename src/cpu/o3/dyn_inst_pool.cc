@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cassert>
+#include <cstring>
+
+#include "base/intmath.hh"
+#include "base/misc.hh"
+#include "cpu/o3/dyn_inst_pool.hh"
+
+DynInstPool::DynInstPool(const std::string &name, unsigned capacity,
+                         bool debug)
+    : _name(name), _capacity(capacity ? capacity : 1), debug(debug),
+      objSize(0)
+{
+}
+
+DynInstPool::~DynInstPool()
+{
+    for (int i = 0; i < chunks.size(); ++i)
+        ::operator delete(chunks[i]);
+}
+
+void
+DynInstPool::grow()
+{
+    const size_t stride = headerSize + roundUp(objSize, headerSize);
+    char *chunk = (char *)::operator new(stride * _capacity);
+    chunks.push_back(chunk);
+
+    // Hand out the blocks in address order
+    for (int i = _capacity - 1; i >= 0; --i) {
+        void *p = chunk + i * stride + headerSize;
+        poolOf(p) = this;
+        freeBlocks.push_back(p);
+    }
+}
+
+void *
+DynInstPool::allocateSlow(size_t size)
+{
+    if (!objSize)
+        objSize = size;
+
+    // Objects of a different size (e.g., from a derived class) are
+    // allocated on their own.
+    if (size != objSize)
+        return allocateUnpooled(size);
+
+    if (debug && quarantine.size() > _capacity) {
+        void *p = quarantine.front();
+        quarantine.pop_front();
+        checkPoison(p);
+        return p;
+    }
+
+    if (freeBlocks.empty())
+        grow();
+
+    void *p = freeBlocks.back();
+    freeBlocks.pop_back();
+    return p;
+}
+
+void *
+DynInstPool::allocateUnpooled(size_t size)
+{
+    char *block = (char *)::operator new(headerSize + size);
+    void *p = block + headerSize;
+    poolOf(p) = NULL;
+    return p;
+}
+
+void
+DynInstPool::releaseSlow(void *p)
+{
+    DynInstPool *pool = poolOf(p);
+    if (!pool) {
+        ::operator delete((char *)p - headerSize);
+        return;
+    }
+
+    assert(pool->debug);
+    memset(p, poison, pool->objSize);
+    pool->quarantine.push_back(p);
+}
+
+void
+DynInstPool::checkPoison(void *p) const
+{
+    const unsigned char *bytes = (const unsigned char *)p;
+    for (size_t i = 0; i < objSize; ++i) {
+        if (bytes[i] != poison) {
+            panic("%s: dynamic instruction at %p was written to at offset "
+                  "%d after being freed\n", _name, p, i);
+        }
+    }
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Recycling of the dynamic instructions of an O3 CPU
+ */
+
+#ifndef __CPU_O3_DYN_INST_POOL_HH__
+#define __CPU_O3_DYN_INST_POOL_HH__
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <vector>
+
+/**
+ * Memory for the dynamic instructions of a CPU. Every instruction that
+ * is fetched used to be allocated and freed on its own; the pool
+ * instead carves them out of large chunks and keeps freed ones on a
+ * free list, so that the instructions in flight stay close together
+ * and most allocations are a pop off a vector.
+ *
+ * Each block is preceded by a small header pointing back to its pool,
+ * so that it can be released without knowing which CPU it belongs to.
+ * The first chunk is allocated when the first instruction is, and
+ * holds as many instructions as the CPU can have in flight; the pool
+ * grows by further chunks of the same size if instructions are kept
+ * alive for longer than that.
+ *
+ * In debug mode, freed instructions are overwritten with a poison
+ * pattern and only reused once capacity other instructions have been
+ * freed after them. Any access through a stale reference in the
+ * meantime either reads poison (usually crashing on the virtual
+ * table) or writes to the block, which is detected when the block is
+ * reused.
+ */
+class DynInstPool
+{
+  private:
+    /** Space reserved in front of each block for its header. */
+    static const size_t headerSize = 16;
+
+    /** Byte freed blocks are filled with in debug mode. */
+    static const unsigned char poison = 0xdb;
+
+    const std::string _name;
+
+    /** Number of blocks in a chunk. */
+    const unsigned _capacity;
+
+    /** Whether to poison and check freed blocks. */
+    const bool debug;
+
+    /** Size of the objects in the pool, 0 until first allocated. */
+    size_t objSize;
+
+    /** Chunks of blocks, freed with the pool. */
+    std::vector<char *> chunks;
+
+    /** Free blocks, most recently freed last. */
+    std::vector<void *> freeBlocks;
+
+    /** Poisoned blocks waiting to be reused in debug mode. */
+    std::deque<void *> quarantine;
+
+    /** Allocate a chunk and put its blocks on the free list. */
+    void grow();
+
+    /** Panic if a poisoned block has been written to. */
+    void checkPoison(void *p) const;
+
+    static DynInstPool *&poolOf(void *p)
+    {
+        return *(DynInstPool **)((char *)p - headerSize);
+    }
+
+    DynInstPool(const DynInstPool &);
+    DynInstPool &operator=(const DynInstPool &);
+
+  public:
+    /**
+     * @param name Name used in error messages.
+     * @param capacity Number of instructions the CPU can have in flight.
+     * @param debug Poison freed instructions to catch stale references.
+     */
+    DynInstPool(const std::string &name, unsigned capacity, bool debug);
+    ~DynInstPool();
+
+    const std::string &name() const { return _name; }
+
+    unsigned capacity() const { return _capacity; }
+
+    /** Allocate memory for an instruction of the given size. */
+    void *
+    allocate(size_t size)
+    {
+        if (!debug && !freeBlocks.empty() && size == objSize) {
+            void *p = freeBlocks.back();
+            freeBlocks.pop_back();
+            return p;
+        }
+
+        return allocateSlow(size);
+    }
+
+    /** Allocation path when the free list is empty or in debug mode. */
+    void *allocateSlow(size_t size);
+
+    /** Allocate memory for an instruction that is not pooled. */
+    static void *allocateUnpooled(size_t size);
+
+    /** Release the memory of an instruction to the pool it came from. */
+    static void
+    release(void *p)
+    {
+        DynInstPool *pool = poolOf(p);
+        if (pool && !pool->debug)
+            pool->freeBlocks.push_back(p);
+        else
+            releaseSlow(p);
+    }
+
+    /** Release path for unpooled blocks or in debug mode. */
+    static void releaseSlow(void *p);
+};
+
+#endif // __CPU_O3_DYN_INST_POOL_HH__
@@ -334,6 +334,12 @@ class DefaultIEW
      */
     void tick();
 
+    /**
+     * Advances the issue to execute queue over cycles the CPU skipped
+     * while the pipeline was quiescent, as tick() would have done.
+     */
+    void advanceSkippedCycles(int cycles);
+
   private:
     /** Updates execution stats based on the instruction. */
     void updateExeInstStats(DynInstPtr &inst);
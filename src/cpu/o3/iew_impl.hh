@@ -47,6 +47,7 @@
 // iew.  There's a clear delay between issue and execute, yet backwards
 // communication happens simultaneously.
 
+#include <algorithm>
 #include <queue>
 
 #include "arch/utility.hh"
@@ -1499,6 +1500,16 @@ DefaultIEW<Impl>::writebackInsts()
     }
 }
 
+template<class Impl>
+void
+DefaultIEW<Impl>::advanceSkippedCycles(int cycles)
+{
+    int advance = std::min<int>(cycles, issueToExecQueue.getSize());
+    for (int i = 0; i < advance; ++i) {
+        issueToExecQueue.advance();
+    }
+}
+
 template<class Impl>
 void
 DefaultIEW<Impl>::tick()
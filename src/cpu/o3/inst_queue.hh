@@ -49,9 +49,11 @@
 #include <queue>
 #include <vector>
 
+#include "base/circular_list.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "cpu/o3/dep_graph.hh"
+#include "cpu/o3/matrix_scheduler.hh"
 #include "cpu/inst_seq.hh"
 #include "cpu/op_class.hh"
 #include "cpu/timebuf.hh"
@@ -76,6 +78,9 @@ class MemInterface;
  * requiring IEW to be able to peek into the IQ. At the end of the execution
  * latency, the instruction is put into the queue to execute, where it will
  * have the execute() function called on it.
+ * With the matrix scheduler (iqScheduler = 'Matrix'), the dependency lists,
+ * ready queues and age order list are replaced by the bit matrices of a
+ * MatrixScheduler, with an entry per instruction in the IQ.
  * @todo: Make IQ able to handle multiple FU pools.
  */
 template <class Impl>
@@ -94,8 +99,12 @@ class InstructionQueue
     // Typedef of iterator through the list of instructions.
     typedef typename std::list<DynInstPtr>::iterator ListIt;
 
+    // Typedef of iterator through the per-thread instruction lists.
+    typedef typename CircularList<DynInstPtr>::iterator InstListIt;
+
     /** FU completion event class. */
-    class FUCompletion : public Event {
+    class FUCompletion : public Event, public PooledEvent<FUCompletion>
+    {
       private:
         /** Executing instruction. */
         DynInstPtr inst;
@@ -119,6 +128,8 @@ class InstructionQueue
         virtual void process();
         virtual const char *description() const;
         void setFreeFU() { freeFU = true; }
+
+        static const char *poolName() { return "o3_fu_completion"; }
     };
 
     /** Constructs an IQ. */
@@ -297,8 +308,11 @@ class InstructionQueue
     // Instruction lists, ready queues, and ordering
     //////////////////////////////////////
 
-    /** List of all the instructions in the IQ (some of which may be issued). */
-    std::list<DynInstPtr> instList[Impl::MaxThreads];
+    /** List of all the instructions in the IQ (some of which may be issued).
+     *  Instructions stay on it until they commit, so it is preallocated to
+     *  the size of the ROB.
+     */
+    CircularList<DynInstPtr> instList[Impl::MaxThreads];
 
     /** List of instructions that are ready to be executed. */
     std::list<DynInstPtr> instsToExecute;
@@ -377,6 +391,40 @@ class InstructionQueue
 
     DependencyGraph<DynInstPtr> dependGraph;
 
+    /** Whether the matrix scheduler is used instead of the dependency
+     *  graph, ready queues and age order list.
+     */
+    bool useMatrix;
+
+    /** Wakeup, age and select matrices of the matrix scheduler. */
+    MatrixScheduler matrix;
+
+    /** Instruction in each entry of the matrix scheduler. */
+    std::vector<DynInstPtr> matrixInsts;
+
+    /** Entries woken up by a register, reused across calls. */
+    std::vector<int> wokenEntries;
+
+    /** Allocates a matrix scheduler entry for an instruction. */
+    void addToMatrix(DynInstPtr &inst);
+
+    /** Frees the matrix scheduler entry of an instruction, if any. */
+    void removeFromMatrix(DynInstPtr &inst);
+
+    /** Issues the oldest ready instructions using the matrix scheduler.
+     *  @return The number of instructions issued.
+     */
+    int scheduleMatrix(IssueStruct *i2e_info, int width);
+
+    /**
+     * Tries to get a FU for an instruction and sends it to execute.
+     * @return False if no FU was available.
+     */
+    bool issueInst(DynInstPtr &issuing_inst, IssueStruct *i2e_info);
+
+    /** Updates the issue stats and CPU activity after scheduling. */
+    void finishScheduling(int total_issued, int total_deferred_mem_issued);
+
     //////////////////////////////////////
     // Various parameters
     //////////////////////////////////////
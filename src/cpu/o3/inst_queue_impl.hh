@@ -108,10 +108,17 @@ InstructionQueue<Impl>::InstructionQueue(O3CPU *cpu_ptr, IEW *iew_ptr,
     // Resize the register scoreboard.
     regScoreboard.resize(numPhysRegs);
 
+    useMatrix = params->iqScheduler == Enums::Matrix;
+    if (useMatrix) {
+        matrix.resize(numEntries, numPhysRegs);
+        matrixInsts.resize(numEntries);
+    }
+
     //Initialize Mem Dependence Units
     for (ThreadID tid = 0; tid < numThreads; tid++) {
         memDepUnit[tid].init(params, tid);
         memDepUnit[tid].setIQ(this);
+        instList[tid].reserve(params->numROBEntries);
     }
 
     resetState();
@@ -413,6 +420,16 @@ InstructionQueue<Impl>::resetState()
     nonSpecInsts.clear();
     listOrder.clear();
     deferredMemInsts.clear();
+
+    if (useMatrix) {
+        matrix.reset();
+        for (int i = 0; i < matrixInsts.size(); ++i) {
+            if (matrixInsts[i]) {
+                matrixInsts[i]->iqIdx = -1;
+                matrixInsts[i] = NULL;
+            }
+        }
+    }
 }
 
 template <class Impl>
@@ -531,6 +548,9 @@ template <class Impl>
 bool
 InstructionQueue<Impl>::hasReadyInsts()
 {
+    if (useMatrix)
+        return matrix.hasReady();
+
     if (!listOrder.empty()) {
         return true;
     }
@@ -563,6 +583,9 @@ InstructionQueue<Impl>::insert(DynInstPtr &new_inst)
 
     new_inst->setInIQ();
 
+    if (useMatrix)
+        addToMatrix(new_inst);
+
     // Look through its source registers (physical regs), and mark any
     // dependencies.
     addToDependents(new_inst);
@@ -608,6 +631,9 @@ InstructionQueue<Impl>::insertNonSpec(DynInstPtr &new_inst)
 
     new_inst->setInIQ();
 
+    if (useMatrix)
+        addToMatrix(new_inst);
+
     // Have this instruction set itself as the producer of its destination
     // register(s).
     addToProducers(new_inst);
@@ -743,6 +769,13 @@ InstructionQueue<Impl>::scheduleReadyInsts()
         total_deferred_mem_issued++;
     }
 
+    if (useMatrix) {
+        int width = totalWidth - total_deferred_mem_issued;
+        finishScheduling(scheduleMatrix(i2e_info, width),
+                         total_deferred_mem_issued);
+        return;
+    }
+
     // Have iterator to head of the list
     // While I haven't exceeded bandwidth or reached the end of the list,
     // Try to get a FU that can do what this op needs.
@@ -785,54 +818,7 @@ InstructionQueue<Impl>::scheduleReadyInsts()
             continue;
         }
 
-        int idx = -2;
-        Cycles op_latency = Cycles(1);
-        ThreadID tid = issuing_inst->threadNumber;
-
-        if (op_class != No_OpClass) {
-            idx = fuPool->getUnit(op_class);
-            issuing_inst->isFloating() ? fpAluAccesses++ : intAluAccesses++;
-            if (idx > -1) {
-                op_latency = fuPool->getOpLatency(op_class);
-            }
-        }
-
-        // If we have an instruction that doesn't require a FU, or a
-        // valid FU, then schedule for execution.
-        if (idx == -2 || idx != -1) {
-            if (op_latency == Cycles(1)) {
-                i2e_info->size++;
-                instsToExecute.push_back(issuing_inst);
-
-                // Add the FU onto the list of FU's to be freed next
-                // cycle if we used one.
-                if (idx >= 0)
-                    fuPool->freeUnitNextCycle(idx);
-            } else {
-                Cycles issue_latency = fuPool->getIssueLatency(op_class);
-                // Generate completion event for the FU
-                FUCompletion *execution = new FUCompletion(issuing_inst,
-                                                           idx, this);
-
-                cpu->schedule(execution,
-                              cpu->clockEdge(Cycles(op_latency - 1)));
-
-                // @todo: Enforce that issue_latency == 1 or op_latency
-                if (issue_latency > Cycles(1)) {
-                    // If FU isn't pipelined, then it must be freed
-                    // upon the execution completing.
-                    execution->setFreeFU();
-                } else {
-                    // Add the FU onto the list of FU's to be freed next cycle.
-                    fuPool->freeUnitNextCycle(idx);
-                }
-            }
-
-            DPRINTF(IQ, "Thread %i: Issuing instruction PC %s "
-                    "[sn:%lli]\n",
-                    tid, issuing_inst->pcState(),
-                    issuing_inst->seqNum);
-
+        if (issueInst(issuing_inst, i2e_info)) {
             readyInsts[op_class].pop();
 
             if (!readyInsts[op_class].empty()) {
@@ -842,33 +828,142 @@ InstructionQueue<Impl>::scheduleReadyInsts()
                 queueOnList[op_class] = false;
             }
 
-            issuing_inst->setIssued();
             ++total_issued;
 
+            listOrder.erase(order_it++);
+        } else {
+            ++order_it;
+        }
+    }
+
+    finishScheduling(total_issued, total_deferred_mem_issued);
+}
+
+template <class Impl>
+bool
+InstructionQueue<Impl>::issueInst(DynInstPtr &issuing_inst,
+                                  IssueStruct *i2e_info)
+{
+    OpClass op_class = issuing_inst->opClass();
+    int idx = -2;
+    Cycles op_latency = Cycles(1);
+    ThreadID tid = issuing_inst->threadNumber;
+
+    if (op_class != No_OpClass) {
+        idx = fuPool->getUnit(op_class);
+        issuing_inst->isFloating() ? fpAluAccesses++ : intAluAccesses++;
+        if (idx > -1) {
+            op_latency = fuPool->getOpLatency(op_class);
+        }
+    }
+
+    // Schedule the instruction for execution if it doesn't require a FU
+    // or got a valid one.
+    if (idx == -1) {
+        statFuBusy[op_class]++;
+        fuBusy[tid]++;
+        return false;
+    }
+
+    if (op_latency == Cycles(1)) {
+        i2e_info->size++;
+        instsToExecute.push_back(issuing_inst);
+
+        // Add the FU onto the list of FU's to be freed next
+        // cycle if we used one.
+        if (idx >= 0)
+            fuPool->freeUnitNextCycle(idx);
+    } else {
+        Cycles issue_latency = fuPool->getIssueLatency(op_class);
+        // Generate completion event for the FU
+        FUCompletion *execution = new FUCompletion(issuing_inst,
+                                                   idx, this);
+
+        cpu->schedule(execution,
+                      cpu->clockEdge(Cycles(op_latency - 1)));
+
+        // @todo: Enforce that issue_latency == 1 or op_latency
+        if (issue_latency > Cycles(1)) {
+            // If FU isn't pipelined, then it must be freed
+            // upon the execution completing.
+            execution->setFreeFU();
+        } else {
+            // Add the FU onto the list of FU's to be freed next cycle.
+            fuPool->freeUnitNextCycle(idx);
+        }
+    }
+
+    DPRINTF(IQ, "Thread %i: Issuing instruction PC %s "
+            "[sn:%lli]\n",
+            tid, issuing_inst->pcState(),
+            issuing_inst->seqNum);
+
+    issuing_inst->setIssued();
+
 #if TRACING_ON
-            issuing_inst->issueTick = curTick() - issuing_inst->fetchTick;
+    issuing_inst->issueTick = curTick() - issuing_inst->fetchTick;
 #endif
 
-            if (!issuing_inst->isMemRef()) {
-                // Memory instructions can not be freed from the IQ until they
-                // complete.
-                ++freeEntries;
-                count[tid]--;
-                issuing_inst->clearInIQ();
-            } else {
-                memDepUnit[tid].issue(issuing_inst);
-            }
+    if (!issuing_inst->isMemRef()) {
+        // Memory instructions can not be freed from the IQ until they
+        // complete.
+        ++freeEntries;
+        count[tid]--;
+        issuing_inst->clearInIQ();
+        removeFromMatrix(issuing_inst);
+    } else {
+        memDepUnit[tid].issue(issuing_inst);
+    }
 
-            listOrder.erase(order_it++);
-            statIssuedInstType[tid][op_class]++;
-            iewStage->incrWb(issuing_inst->seqNum);
+    statIssuedInstType[tid][op_class]++;
+    iewStage->incrWb(issuing_inst->seqNum);
+
+    return true;
+}
+
+template <class Impl>
+int
+InstructionQueue<Impl>::scheduleMatrix(IssueStruct *i2e_info, int width)
+{
+    // Repeatedly pick the oldest ready instruction of any op class
+    // that still has a free FU, as the age order list does.
+    int total_issued = 0;
+
+    matrix.startSelect();
+
+    while (total_issued < width && iewStage->canIssue()) {
+        int entry = matrix.selectOldest();
+        if (entry < 0)
+            break;
+
+        DynInstPtr issuing_inst = matrixInsts[entry];
+
+        issuing_inst->isFloating() ? fpInstQueueReads++ : intInstQueueReads++;
+
+        if (issuing_inst->isSquashed()) {
+            // Its entry is freed when the IQ squashes it
+            matrix.clearReady(entry);
+            ++iqSquashedInstsIssued;
+            continue;
+        }
+
+        if (issueInst(issuing_inst, i2e_info)) {
+            if (issuing_inst->isMemRef())
+                matrix.clearReady(entry);
+            ++total_issued;
         } else {
-            statFuBusy[op_class]++;
-            fuBusy[tid]++;
-            ++order_it;
+            matrix.blockClass(issuing_inst->opClass());
         }
     }
 
+    return total_issued;
+}
+
+template <class Impl>
+void
+InstructionQueue<Impl>::finishScheduling(int total_issued,
+                                         int total_deferred_mem_issued)
+{
     numIssuedDist.sample(total_issued);
     iqInstsIssued+= total_issued;
 
@@ -918,7 +1013,7 @@ InstructionQueue<Impl>::commit(const InstSeqNum &inst, ThreadID tid)
     DPRINTF(IQ, "[tid:%i]: Committing instructions older than [sn:%i]\n",
             tid,inst);
 
-    ListIt iq_it = instList[tid].begin();
+    InstListIt iq_it = instList[tid].begin();
 
     while (iq_it != instList[tid].end() &&
            (*iq_it)->seqNum <= inst) {
@@ -979,6 +1074,34 @@ InstructionQueue<Impl>::wakeDependents(DynInstPtr &completed_inst)
         DPRINTF(IQ, "Waking any dependents on register %i.\n",
                 (int) dest_reg);
 
+        if (useMatrix) {
+            matrix.wake(dest_reg, wokenEntries);
+
+            for (int i = 0; i < wokenEntries.size(); ++i) {
+                DynInstPtr &dep_inst = matrixInsts[wokenEntries[i]];
+
+                DPRINTF(IQ, "Waking up a dependent instruction, [sn:%lli] "
+                        "PC %s.\n", dep_inst->seqNum, dep_inst->pcState());
+
+                // The entry has a single wakeup bit per register, so
+                // mark every source that reads the register.
+                for (int src_reg_idx = 0;
+                     src_reg_idx < dep_inst->numSrcRegs();
+                     src_reg_idx++) {
+                    if (dep_inst->renamedSrcRegIdx(src_reg_idx) == dest_reg &&
+                        !dep_inst->isReadySrcRegIdx(src_reg_idx)) {
+                        dep_inst->markSrcRegReady(src_reg_idx);
+                        ++dependents;
+                    }
+                }
+
+                addIfReady(dep_inst);
+            }
+
+            regScoreboard[dest_reg] = true;
+            continue;
+        }
+
         //Go through the dependency chain, marking the registers as
         //ready within the waiting instructions.
         DynInstPtr dep_inst = dependGraph.pop(dest_reg);
@@ -1017,6 +1140,15 @@ InstructionQueue<Impl>::addReadyMemInst(DynInstPtr &ready_inst)
 {
     OpClass op_class = ready_inst->opClass();
 
+    if (useMatrix) {
+        // Squashed instructions have already left the matrix
+        if (ready_inst->iqIdx >= 0)
+            matrix.setReady(ready_inst->iqIdx);
+        else
+            ++iqSquashedInstsIssued;
+        return;
+    }
+
     readyInsts[op_class].push(ready_inst);
 
     // Will need to reorder the list if either a queue is not on the list,
@@ -1068,6 +1200,8 @@ InstructionQueue<Impl>::completeMemInst(DynInstPtr &completed_inst)
 
     completed_inst->memOpDone(true);
 
+    removeFromMatrix(completed_inst);
+
     memDepUnit[tid].completed(completed_inst);
     count[tid]--;
 }
@@ -1128,7 +1262,7 @@ void
 InstructionQueue<Impl>::doSquash(ThreadID tid)
 {
     // Start at the tail.
-    ListIt squash_it = instList[tid].end();
+    InstListIt squash_it = instList[tid].end();
     --squash_it;
 
     DPRINTF(IQ, "[tid:%i]: Squashing until sequence number %i!\n",
@@ -1187,7 +1321,10 @@ InstructionQueue<Impl>::doSquash(ThreadID tid)
 
                     if (!squashed_inst->isReadySrcRegIdx(src_reg_idx) &&
                         src_reg < numPhysRegs) {
-                        dependGraph.remove(src_reg, squashed_inst);
+                        if (useMatrix)
+                            matrix.removeWaiter(src_reg, squashed_inst->iqIdx);
+                        else
+                            dependGraph.remove(src_reg, squashed_inst);
                     }
 
 
@@ -1219,6 +1356,8 @@ InstructionQueue<Impl>::doSquash(ThreadID tid)
 
             // Might want to also clear out the head of the dependency graph.
 
+            removeFromMatrix(squashed_inst);
+
             // Mark it as squashed within the IQ.
             squashed_inst->setSquashedInIQ();
 
@@ -1267,7 +1406,10 @@ InstructionQueue<Impl>::addToDependents(DynInstPtr &new_inst)
                         "is being added to the dependency chain.\n",
                         new_inst->pcState(), src_reg);
 
-                dependGraph.insert(src_reg, new_inst);
+                if (useMatrix)
+                    matrix.addWaiter(src_reg, new_inst->iqIdx);
+                else
+                    dependGraph.insert(src_reg, new_inst);
 
                 // Change the return value to indicate that something
                 // was added to the dependency graph.
@@ -1309,12 +1451,14 @@ InstructionQueue<Impl>::addToProducers(DynInstPtr &new_inst)
             continue;
         }
 
-        if (!dependGraph.empty(dest_reg)) {
-            dependGraph.dump();
-            panic("Dependency graph %i not empty!", dest_reg);
-        }
+        if (!useMatrix) {
+            if (!dependGraph.empty(dest_reg)) {
+                dependGraph.dump();
+                panic("Dependency graph %i not empty!", dest_reg);
+            }
 
-        dependGraph.setInst(dest_reg, new_inst);
+            dependGraph.setInst(dest_reg, new_inst);
+        }
 
         // Mark the scoreboard to say it's not yet ready.
         regScoreboard[dest_reg] = false;
@@ -1347,6 +1491,11 @@ InstructionQueue<Impl>::addIfReady(DynInstPtr &inst)
                 "the ready list, PC %s opclass:%i [sn:%lli].\n",
                 inst->pcState(), op_class, inst->seqNum);
 
+        if (useMatrix) {
+            matrix.setReady(inst->iqIdx);
+            return;
+        }
+
         readyInsts[op_class].push(inst);
 
         // Will need to reorder the list if either a queue is not on the list,
@@ -1361,6 +1510,32 @@ InstructionQueue<Impl>::addIfReady(DynInstPtr &inst)
     }
 }
 
+template <class Impl>
+void
+InstructionQueue<Impl>::addToMatrix(DynInstPtr &inst)
+{
+    assert(inst->iqIdx < 0);
+
+    int entry = matrix.insert(inst->opClass(), inst->seqNum);
+    matrixInsts[entry] = inst;
+    inst->iqIdx = entry;
+}
+
+template <class Impl>
+void
+InstructionQueue<Impl>::removeFromMatrix(DynInstPtr &inst)
+{
+    if (!useMatrix || inst->iqIdx < 0)
+        return;
+
+    int entry = inst->iqIdx;
+    assert(matrixInsts[entry] == inst);
+
+    matrix.remove(entry);
+    matrixInsts[entry] = NULL;
+    inst->iqIdx = -1;
+}
+
 template <class Impl>
 int
 InstructionQueue<Impl>::countInsts()
@@ -1373,7 +1548,7 @@ InstructionQueue<Impl>::countInsts()
     int total_insts = 0;
 
     for (ThreadID tid = 0; tid < numThreads; ++tid) {
-        ListIt count_it = instList[tid].begin();
+        InstListIt count_it = instList[tid].begin();
 
         while (count_it != instList[tid].end()) {
             if (!(*count_it)->isSquashed() && !(*count_it)->isSquashedInIQ()) {
@@ -1407,6 +1582,9 @@ InstructionQueue<Impl>::dumpLists()
         cprintf("\n");
     }
 
+    if (useMatrix)
+        cprintf("Matrix scheduler ready entries: %i\n", matrix.numReady());
+
     cprintf("Non speculative list size: %i\n", nonSpecInsts.size());
 
     NonSpecMapIt non_spec_it = nonSpecInsts.begin();
@@ -1447,7 +1625,7 @@ InstructionQueue<Impl>::dumpInsts()
     for (ThreadID tid = 0; tid < numThreads; ++tid) {
         int num = 0;
         int valid_num = 0;
-        ListIt inst_list_it = instList[tid].begin();
+        InstListIt inst_list_it = instList[tid].begin();
 
         while (inst_list_it != instList[tid].end()) {
             cprintf("Instruction:%i\n", num);
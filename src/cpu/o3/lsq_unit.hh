@@ -321,7 +321,9 @@ class LSQUnit {
     };
 
     /** Writeback event, specifically for when stores forward data to loads. */
-    class WritebackEvent : public Event {
+    class WritebackEvent : public Event,
+                           public PooledEvent<WritebackEvent>
+    {
       public:
         /** Constructs a writeback event. */
         WritebackEvent(DynInstPtr &_inst, PacketPtr pkt, LSQUnit *lsq_ptr);
@@ -332,6 +334,8 @@ class LSQUnit {
         /** Returns the description of this event. */
         const char *description() const;
 
+        static const char *poolName() { return "o3_lsq_writeback"; }
+
       private:
         /** Instruction whose results are being written back. */
         DynInstPtr inst;
@@ -623,8 +627,7 @@ LSQUnit<Impl>::read(Request *req, Request *sreqLow, Request *sreqHigh,
     }
 
     if (req->isMmappedIpr()) {
-        assert(!load_inst->memData);
-        load_inst->memData = new uint8_t[64];
+        load_inst->allocMemData(64);
 
         ThreadContext *thread = cpu->tcBase(lsqID);
         Cycles delay(0);
@@ -702,8 +705,7 @@ LSQUnit<Impl>::read(Request *req, Request *sreqLow, Request *sreqHigh,
                 memcpy(data, storeQueue[store_idx].data + shift_amt,
                    req->getSize());
 
-            assert(!load_inst->memData);
-            load_inst->memData = new uint8_t[req->getSize()];
+            load_inst->allocMemData(req->getSize());
             if (storeQueue[store_idx].isAllZeros)
                 memset(load_inst->memData, 0, req->getSize());
             else
@@ -786,8 +788,7 @@ LSQUnit<Impl>::read(Request *req, Request *sreqLow, Request *sreqHigh,
     DPRINTF(LSQUnit, "Doing memory access for inst [sn:%lli] PC %s\n",
             load_inst->seqNum, load_inst->pcState());
 
-    assert(!load_inst->memData);
-    load_inst->memData = new uint8_t[req->getSize()];
+    load_inst->allocMemData(req->getSize());
 
     ++usedPorts;
 
@@ -823,8 +823,7 @@ LSQUnit<Impl>::writebackStores()
 
         storeQueue[storeWBIdx].committed = true;
 
-        assert(!inst->memData);
-        inst->memData = new uint8_t[req->getSize()];
+        inst->allocMemData(req->getSize());
 
         if (storeQueue[storeWBIdx].isAllZeros)
             memset(inst->memData, 0, req->getSize());
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cassert>
+
+#include "base/bitfield.hh"
+#include "base/misc.hh"
+#include "cpu/o3/matrix_scheduler.hh"
+
+MatrixScheduler::MatrixScheduler()
+    : numEntries(0), numWords(0), numRegs(0)
+{
+}
+
+void
+MatrixScheduler::resize(unsigned num_entries, unsigned num_regs)
+{
+    numEntries = num_entries;
+    numWords = (num_entries + wordBits - 1) / wordBits;
+    numRegs = num_regs;
+
+    waiting.assign(numRegs * numWords, 0);
+    classes.assign(Num_OpClasses * numWords, 0);
+    valid.assign(numWords, 0);
+    ready.assign(numWords, 0);
+    candidates.assign(numWords, 0);
+    entryClass.assign(numEntries, No_OpClass);
+    entrySeqNum.assign(numEntries, 0);
+}
+
+void
+MatrixScheduler::reset()
+{
+    std::fill(waiting.begin(), waiting.end(), 0);
+    std::fill(classes.begin(), classes.end(), 0);
+    std::fill(valid.begin(), valid.end(), 0);
+    std::fill(ready.begin(), ready.end(), 0);
+    std::fill(candidates.begin(), candidates.end(), 0);
+}
+
+int
+MatrixScheduler::insert(OpClass op_class, InstSeqNum seq_num)
+{
+    int entry = -1;
+    for (unsigned w = 0; w < numWords; ++w) {
+        if (~valid[w]) {
+            entry = w * wordBits + findLsbSet(~valid[w]);
+            break;
+        }
+    }
+
+    if (entry < 0 || entry >= numEntries)
+        panic("Matrix scheduler has no free entries\n");
+
+    set(&valid[0], entry);
+    set(row(classes, op_class), entry);
+    entryClass[entry] = op_class;
+    entrySeqNum[entry] = seq_num;
+
+    return entry;
+}
+
+void
+MatrixScheduler::remove(int entry)
+{
+    assert(test(&valid[0], entry));
+
+    clear(&valid[0], entry);
+    clearReady(entry);
+    clear(row(classes, entryClass[entry]), entry);
+}
+
+void
+MatrixScheduler::wake(unsigned reg, std::vector<int> &entries)
+{
+    Word *r = row(waiting, reg);
+    entries.clear();
+    for (unsigned w = 0; w < numWords; ++w) {
+        for (Word bits = r[w]; bits; bits &= bits - 1)
+            entries.push_back(w * wordBits + findLsbSet(bits));
+        r[w] = 0;
+    }
+}
+
+bool
+MatrixScheduler::hasReady() const
+{
+    for (unsigned w = 0; w < numWords; ++w) {
+        if (ready[w])
+            return true;
+    }
+    return false;
+}
+
+unsigned
+MatrixScheduler::numReady() const
+{
+    unsigned num = 0;
+    for (unsigned w = 0; w < numWords; ++w) {
+        for (Word bits = ready[w]; bits; bits &= bits - 1)
+            ++num;
+    }
+    return num;
+}
+
+int
+MatrixScheduler::selectOldest() const
+{
+    int oldest = -1;
+    InstSeqNum oldest_seq_num = 0;
+    for (unsigned w = 0; w < numWords; ++w) {
+        for (Word bits = candidates[w]; bits; bits &= bits - 1) {
+            int entry = w * wordBits + findLsbSet(bits);
+            if (oldest < 0 || entrySeqNum[entry] < oldest_seq_num) {
+                oldest = entry;
+                oldest_seq_num = entrySeqNum[entry];
+            }
+        }
+    }
+
+    return oldest;
+}
+
+void
+MatrixScheduler::blockClass(OpClass op_class)
+{
+    const Word *r = row(classes, op_class);
+    for (unsigned w = 0; w < numWords; ++w)
+        candidates[w] &= ~r[w];
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Bit-matrix wakeup and select logic for the O3 instruction queue
+ */
+
+#ifndef __CPU_O3_MATRIX_SCHEDULER_HH__
+#define __CPU_O3_MATRIX_SCHEDULER_HH__
+
+#include <vector>
+
+#include "base/types.hh"
+#include "cpu/inst_seq.hh"
+#include "cpu/op_class.hh"
+
+/**
+ * Wakeup and select logic of an instruction queue built out of bit
+ * matrices with a row per register or per op class and a column per
+ * entry. Entries are allocated when instructions enter the queue and
+ * freed when they leave it.
+ *
+ * - Wakeup: a row per physical register has a bit set for every
+ *   entry waiting for that register, so a register becoming ready
+ *   finds its consumers by scanning a row.
+ * - Select: a row per op class has a bit set for every entry of that
+ *   class. Masking the ready entries with the rows of the classes
+ *   whose functional units are busy leaves the candidates, of which
+ *   the one with the smallest sequence number issues, as with the
+ *   list scheduler.
+ *
+ * Rows are arrays of 64-bit words, so wakeup, allocating and freeing
+ * entries, and masking a class are loops over the words of a row.
+ * Selecting scans the words of the candidates and compares the
+ * sequence numbers of the candidates found.
+ */
+class MatrixScheduler
+{
+  private:
+    typedef uint64_t Word;
+
+    static const unsigned wordBits = 64;
+
+    /** Number of entries, i.e., of columns. */
+    unsigned numEntries;
+
+    /** Number of words in a row. */
+    unsigned numWords;
+
+    /** Number of registers with a wakeup row. */
+    unsigned numRegs;
+
+    /** For each register, the entries waiting for it. */
+    std::vector<Word> waiting;
+
+    /** For each op class, the entries of that class. */
+    std::vector<Word> classes;
+
+    /** Allocated entries. */
+    std::vector<Word> valid;
+
+    /** Entries ready to issue. */
+    std::vector<Word> ready;
+
+    /** Entries that may still be selected in the current cycle. */
+    std::vector<Word> candidates;
+
+    /** Op class of each entry. */
+    std::vector<OpClass> entryClass;
+
+    /** Sequence number of the instruction in each entry. */
+    std::vector<InstSeqNum> entrySeqNum;
+
+    Word *row(std::vector<Word> &m, unsigned i) { return &m[i * numWords]; }
+
+    const Word *
+    row(const std::vector<Word> &m, unsigned i) const
+    {
+        return &m[i * numWords];
+    }
+
+    static Word bit(unsigned entry) { return 1ULL << (entry % wordBits); }
+
+    static void
+    set(Word *r, unsigned entry)
+    {
+        r[entry / wordBits] |= bit(entry);
+    }
+
+    static void
+    clear(Word *r, unsigned entry)
+    {
+        r[entry / wordBits] &= ~bit(entry);
+    }
+
+    static bool
+    test(const Word *r, unsigned entry)
+    {
+        return r[entry / wordBits] & bit(entry);
+    }
+
+  public:
+    MatrixScheduler();
+
+    /** Size the matrices and free all entries. */
+    void resize(unsigned num_entries, unsigned num_regs);
+
+    /** Free all entries. */
+    void reset();
+
+    /**
+     * Allocate an entry.
+     * @param op_class Op class of the instruction.
+     * @param seq_num Sequence number of the instruction, which
+     * orders it for selection.
+     * @return The entry.
+     */
+    int insert(OpClass op_class, InstSeqNum seq_num);
+
+    /** Free an entry, which must not be waiting for any register. */
+    void remove(int entry);
+
+    /** Make an entry wait for a register. */
+    void addWaiter(unsigned reg, int entry) { set(row(waiting, reg), entry); }
+
+    /** Stop an entry from waiting for a register. */
+    void
+    removeWaiter(unsigned reg, int entry)
+    {
+        clear(row(waiting, reg), entry);
+    }
+
+    /**
+     * Wake up the entries waiting for a register.
+     * @param entries Filled in with the entries.
+     */
+    void wake(unsigned reg, std::vector<int> &entries);
+
+    void setReady(int entry) { set(&ready[0], entry); }
+
+    void
+    clearReady(int entry)
+    {
+        clear(&ready[0], entry);
+        clear(&candidates[0], entry);
+    }
+
+    bool hasReady() const;
+
+    unsigned numReady() const;
+
+    /** Start selecting from the entries that are ready. */
+    void startSelect() { candidates = ready; }
+
+    /**
+     * The oldest entry that is ready and not excluded from selection.
+     * @return The entry, or -1 if there is none.
+     */
+    int selectOldest() const;
+
+    /** Exclude an op class from selection until startSelect(). */
+    void blockClass(OpClass op_class);
+};
+
+#endif // __CPU_O3_MATRIX_SCHEDULER_HH__
@@ -103,6 +103,9 @@ ROB<Impl>::ROB(O3CPU *_cpu, DerivO3CPUParams *params)
                     "Partitioned, Threshold}");
     }
 
+    for (ThreadID tid = 0; tid < numThreads; tid++)
+        instList[tid].reserve(maxEntries[tid]);
+
     resetState();
 }
 
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+
+#include "base/misc.hh"
+#include "cpu/base.hh"
+#include "cpu/sampling_controller.hh"
+#include "debug/Sampling.hh"
+#include "mem/cache_warmer.hh"
+#include "sim/sim_exit.hh"
+#include "sim/stat_control.hh"
+#include "sim/system.hh"
+
+using namespace std;
+
+const char *const SamplingController::exitCause = "sample complete";
+
+void
+SamplingController::SwitchDrainManager::drainCycleDone()
+{
+    // Called from within the tick of the last CPU to drain, so leave
+    // the switch until the CPU is done.
+    controller->schedule(controller->switchEvent, curTick());
+}
+
+SamplingController::SamplingController(const Params *p)
+    : SimObject(p), system(p->system),
+      functionalCPUs(p->functional_cpus), detailedCPUs(p->detailed_cpus),
+      warmer(p->warmer), functionalInsts(p->functional_insts),
+      warmupInsts(p->warmup_insts), measureInsts(p->measure_insts),
+      maxSamples(p->max_samples),
+      startInsts(p->start_insts), phase(Idle), position(0),
+      windowInsts(0), sampleWarmup(0), instQueue(NULL), numSamples(0),
+      instEvent(this), switchEvent(this, false, Event::CPU_Switch_Pri),
+      drainManager(this)
+{
+    if (functionalCPUs.empty() ||
+        functionalCPUs.size() != detailedCPUs.size())
+        fatal("%s: needs as many functional as detailed CPUs\n", name());
+
+    if (!measureInsts)
+        fatal("%s: the measurement window can't be empty\n", name());
+
+    for (int i = 1; i < startInsts.size(); ++i) {
+        if (startInsts[i] <= startInsts[i - 1])
+            fatal("%s: sample starts must be increasing\n", name());
+    }
+}
+
+SamplingController::~SamplingController()
+{
+    if (instEvent.scheduled())
+        instQueue->deschedule(&instEvent);
+}
+
+void
+SamplingController::init()
+{
+    for (int i = 0; i < functionalCPUs.size(); ++i) {
+        if (functionalCPUs[i]->switchedOut())
+            fatal("%s: functional CPU %s must start switched in\n",
+                  name(), functionalCPUs[i]->name());
+        if (!detailedCPUs[i]->switchedOut())
+            fatal("%s: detailed CPU %s must start switched out\n",
+                  name(), detailedCPUs[i]->name());
+    }
+
+    if (warmer && warmer->hasTargets())
+        fatal("%s: %s warms caches outside of the classic memory system, "
+              "which can't be done from within the simulation loop\n",
+              name(), warmer->name());
+}
+
+bool
+SamplingController::done() const
+{
+    if (!startInsts.empty())
+        return numSamples >= startInsts.size();
+    return maxSamples && numSamples >= maxSamples;
+}
+
+void
+SamplingController::nextSample(Counter &functional, Counter &warmup) const
+{
+    if (startInsts.empty()) {
+        functional = functionalInsts;
+        warmup = warmupInsts;
+        return;
+    }
+
+    // Warm up for as long as possible without overlapping the
+    // previous sample.
+    Counter start = startInsts[numSamples];
+    if (start < position)
+        warn("%s: sample %d starts at %d, before the end of the "
+             "previous sample (%d)\n", name(), numSamples, start, position);
+    warmup = start > position ? min(warmupInsts, start - position) : 0;
+    functional = start > position + warmup ? start - position - warmup : 0;
+}
+
+void
+SamplingController::startWindow(Phase p, BaseCPU *cpu, Counter insts)
+{
+    DPRINTF(Sampling, "Sample %d: %d instructions of %s on %s\n",
+            numSamples, insts, p == Functional ? "functional warming" :
+            p == Warmup ? "detailed warmup" : "measurement", cpu->name());
+
+    phase = p;
+    windowInsts = insts;
+    instQueue = cpu->comInstEventQueue[0];
+    instQueue->schedule(&instEvent, instQueue->getCurTick() + insts);
+}
+
+void
+SamplingController::startFunctional()
+{
+    if (phase != Idle)
+        panic("%s: sample %d is still running\n", name(), numSamples);
+    if (done())
+        fatal("%s: all samples have been taken\n", name());
+
+    if (warmer)
+        warmer->startRecording();
+
+    Counter functional;
+    nextSample(functional, sampleWarmup);
+    if (functional) {
+        startWindow(Functional, functionalCPUs[0], functional);
+    } else {
+        phase = Functional;
+        windowInsts = 0;
+        schedule(switchEvent, curTick());
+    }
+}
+
+void
+SamplingController::switchToDetailed()
+{
+    assert(phase == Functional);
+
+    // The memory system has nothing in flight in atomic mode, so
+    // draining the CPUs (which may be in the middle of a macroop) is
+    // enough to change the memory mode.
+    unsigned count = system->drain(&drainManager);
+    for (int i = 0; i < functionalCPUs.size(); ++i)
+        count += functionalCPUs[i]->drain(&drainManager);
+    if (count) {
+        DPRINTF(Sampling, "Waiting for %d objects to drain\n", count);
+        drainManager.setCount(count);
+        return;
+    }
+
+    if (warmer)
+        warmer->warm();
+
+    DPRINTF(Sampling, "Switching to the detailed CPUs\n");
+    for (int i = 0; i < functionalCPUs.size(); ++i)
+        functionalCPUs[i]->switchOut();
+
+    system->setMemoryMode(Enums::timing);
+
+    for (int i = 0; i < detailedCPUs.size(); ++i)
+        detailedCPUs[i]->takeOverFrom(functionalCPUs[i]);
+
+    system->drainResume();
+    for (int i = 0; i < detailedCPUs.size(); ++i) {
+        functionalCPUs[i]->drainResume();
+        detailedCPUs[i]->drainResume();
+    }
+
+    if (sampleWarmup)
+        startWindow(Warmup, detailedCPUs[0], sampleWarmup);
+    else
+        startMeasurement();
+}
+
+void
+SamplingController::startMeasurement()
+{
+    Stats::schedStatEvent(false, true, curTick(), 0);
+    startWindow(Measure, detailedCPUs[0], measureInsts);
+}
+
+void
+SamplingController::windowDone()
+{
+    position += windowInsts;
+
+    switch (phase) {
+      case Functional:
+        // The event is serviced from within the tick of the CPU, so
+        // switch once it is done.
+        schedule(switchEvent, curTick());
+        break;
+
+      case Warmup:
+        startMeasurement();
+        break;
+
+      case Measure:
+        ++numSamples;
+        phase = Idle;
+        exitSimLoop(exitCause);
+        break;
+
+      default:
+        panic("%s: instruction event in phase %d\n", name(), phase);
+    }
+}
+
+SamplingController *
+SamplingControllerParams::create()
+{
+    return new SamplingController(this);
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Controller alternating functional warming and detailed simulation
+ */
+
+#ifndef __CPU_SAMPLING_CONTROLLER_HH__
+#define __CPU_SAMPLING_CONTROLLER_HH__
+
+#include <vector>
+
+#include "base/types.hh"
+#include "params/SamplingController.hh"
+#include "sim/drain.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+class BaseCPU;
+class CacheWarmer;
+class System;
+
+/**
+ * Drives sampled simulation (SMARTS, or SimPoint when the samples
+ * are given explicitly). Every sample consists of a functional
+ * window on the atomic CPUs, which keeps the caches warm, followed
+ * by a detailed warmup window and a measurement window on the
+ * detailed CPUs. The functional CPUs may also be KVM CPUs, which
+ * fast-forward at native speed to the start of every sample (using
+ * the instruction counter overflow of the host) at the price of
+ * cold caches, unless a CacheWarmer records the accesses of the
+ * functional window and replays them into the caches before the
+ * switch (atomic CPUs can then run with fastmem as well). The
+ * statistics are reset when measurement starts, and the simulation
+ * loop exits with exitCause at the end of every measurement window
+ * so that the statistics of the sample can be collected (see
+ * m5.sampling).
+ *
+ * Windows are counted in instructions committed by the first thread
+ * of the first CPU in the active set. Switching from the atomic to
+ * the detailed CPUs is done from within the simulation loop: nothing
+ * is in flight in the memory system in atomic mode, so only the CPUs
+ * and the system need to be drained, which leaves KVM CPUs with the
+ * architectural state in their thread context. Going back requires
+ * a full drain of the memory system and is left to m5.switchCpus(),
+ * which costs nothing extra as the loop has to exit for the
+ * statistics anyway.
+ */
+class SamplingController : public SimObject
+{
+  public:
+    typedef SamplingControllerParams Params;
+
+    /** Cause of the simulation loop exit at the end of a sample. */
+    static const char *const exitCause;
+
+    enum Phase {
+        Idle,
+        Functional,
+        Warmup,
+        Measure
+    };
+
+  protected:
+    class InstEvent : public Event
+    {
+      private:
+        SamplingController *controller;
+
+      public:
+        InstEvent(SamplingController *c) : controller(c) { }
+        void process() { controller->windowDone(); }
+        const char *description() const { return "sampling window"; }
+    };
+
+    /** Drain manager that retries the switch once the CPUs drained. */
+    class SwitchDrainManager : public DrainManager
+    {
+      private:
+        SamplingController *controller;
+
+      public:
+        SwitchDrainManager(SamplingController *c) : controller(c) { }
+
+      protected:
+        void drainCycleDone();
+    };
+
+    System *system;
+    std::vector<BaseCPU *> functionalCPUs;
+    std::vector<BaseCPU *> detailedCPUs;
+
+    /** Warms the caches bypassed in the functional windows, if any */
+    CacheWarmer *warmer;
+
+    const Counter functionalInsts;
+    const Counter warmupInsts;
+    const Counter measureInsts;
+    const unsigned maxSamples;
+
+    /** Explicit instruction counts at which measurement starts. */
+    const std::vector<Counter> startInsts;
+
+    Phase phase;
+
+    /** Instructions committed at the start of the current window. */
+    Counter position;
+
+    /** Length of the current window. */
+    Counter windowInsts;
+
+    /** Length of the detailed warmup window of the current sample. */
+    Counter sampleWarmup;
+
+    /** Queue the instruction event of the current window is on. */
+    EventQueue *instQueue;
+
+    /** Number of completed samples. */
+    unsigned numSamples;
+
+    InstEvent instEvent;
+
+    void switchToDetailed();
+    EventWrapper<SamplingController,
+                 &SamplingController::switchToDetailed> switchEvent;
+
+    SwitchDrainManager drainManager;
+
+    /** Length of the functional and warmup windows of the next sample. */
+    void nextSample(Counter &functional, Counter &warmup) const;
+
+    /** Start a window of the given length on the given CPU. */
+    void startWindow(Phase p, BaseCPU *cpu, Counter insts);
+
+    void startMeasurement();
+
+    /** The instruction event of the current window fired. */
+    void windowDone();
+
+  public:
+    SamplingController(const Params *p);
+    ~SamplingController();
+
+    void init();
+
+    /**
+     * Start the functional warming window of the next sample. The
+     * functional CPUs must be running.
+     */
+    void startFunctional();
+
+    /** All samples have been taken. */
+    bool done() const;
+
+    unsigned samples() const { return numSamples; }
+    Counter instructions() const { return position; }
+};
+
+#endif // __CPU_SAMPLING_CONTROLLER_HH__
@@ -110,7 +110,7 @@ AtomicSimpleCPU::AtomicSimpleCPU(AtomicSimpleCPUParams *p)
       drain_manager(NULL),
       icachePort(name() + ".icache_port", this),
       dcachePort(name() + ".dcache_port", this),
-      fastmem(p->fastmem),
+      fastmem(p->fastmem), ppInstAccess(NULL), ppDataAccess(NULL),
       simpoint(p->simpoint_profile),
       intervalSize(p->simpoint_interval),
       intervalCount(0),
@@ -137,6 +137,17 @@ AtomicSimpleCPU::~AtomicSimpleCPU()
     }
 }
 
+void
+AtomicSimpleCPU::regProbePoints()
+{
+    BaseSimpleCPU::regProbePoints();
+
+    ppInstAccess = new ProbePointArg<PacketPtr>(getProbeManager(),
+                                                "InstAccess");
+    ppDataAccess = new ProbePointArg<PacketPtr>(getProbeManager(),
+                                                "DataAccess");
+}
+
 unsigned int
 AtomicSimpleCPU::drain(DrainManager *dm)
 {
@@ -352,6 +363,7 @@ AtomicSimpleCPU::readMem(Addr addr, uint8_t * data,
                     system->getPhysMem().access(&pkt);
                 else
                     dcache_latency += dcachePort.sendAtomic(&pkt);
+                ppDataAccess->notify(&pkt);
             }
             dcache_access = true;
 
@@ -463,6 +475,7 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size,
                         system->getPhysMem().access(&pkt);
                     else
                         dcache_latency += dcachePort.sendAtomic(&pkt);
+                    ppDataAccess->notify(&pkt);
                 }
                 dcache_access = true;
                 assert(!pkt.isError());
@@ -561,6 +574,7 @@ AtomicSimpleCPU::tick()
                         system->getPhysMem().access(&ifetch_pkt);
                     else
                         icache_latency = icachePort.sendAtomic(&ifetch_pkt);
+                    ppInstAccess->notify(&ifetch_pkt);
 
                     assert(!ifetch_pkt.isError());
 
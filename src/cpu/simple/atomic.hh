@@ -46,6 +46,7 @@
 #include "base/hashmap.hh"
 #include "cpu/simple/base.hh"
 #include "params/AtomicSimpleCPU.hh"
+#include "sim/probe/probe.hh"
 
 /**
  *  Start and end address of basic block for SimPoint profiling.
@@ -193,6 +194,16 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     AtomicCPUDPort dcachePort;
 
     bool fastmem;
+
+    /**
+     * Probe points notified of the physical instruction and data
+     * accesses to memory (e.g., to record them for cache warming).
+     * @{
+     */
+    ProbePointArg<PacketPtr> *ppInstAccess;
+    ProbePointArg<PacketPtr> *ppDataAccess;
+    /** @} */
+
     Request ifetch_req;
     Request data_read_req;
     Request data_write_req;
@@ -254,6 +265,8 @@ class AtomicSimpleCPU : public BaseSimpleCPU
 
   public:
 
+    void regProbePoints();
+
     unsigned int drain(DrainManager *drain_manager);
     void drainResume();
 
@@ -44,6 +44,24 @@ StaticInst::~StaticInst()
         delete cachedDisassembly;
 }
 
+void
+StaticInst::pin()
+{
+    if (pinned)
+        return;
+
+    if (isMacroop()) {
+        for (MicroPC upc = 0; ; ++upc) {
+            StaticInstPtr microop = fetchMicroop(upc);
+            microop->pin();
+            if (microop->isLastMicroop())
+                break;
+        }
+    }
+
+    pinned = true;
+}
+
 bool
 StaticInst::hasBranchTarget(const TheISA::PCState &pc, ThreadContext *tc,
                             TheISA::PCState &tgt) const
@@ -320,6 +320,9 @@ class StaticInst : public RefCounted
      */
     mutable std::string *cachedDisassembly;
 
+    /// Whether reference counting is disabled, see pin().
+    bool pinned;
+
     /**
      * Internal function to generate disassembly string.
      */
@@ -334,12 +337,30 @@ class StaticInst : public RefCounted
     StaticInst(const char *_mnemonic, ExtMachInst _machInst, OpClass __opClass)
         : _opClass(__opClass), _numSrcRegs(0), _numDestRegs(0),
           _numFPDestRegs(0), _numIntDestRegs(0),
-          machInst(_machInst), mnemonic(_mnemonic), cachedDisassembly(0)
+          machInst(_machInst), mnemonic(_mnemonic), cachedDisassembly(0),
+          pinned(false)
     { }
 
   public:
     virtual ~StaticInst();
 
+    /// Increment the reference count, unless the instruction is pinned.
+    void incref() { if (!pinned) RefCounted::incref(); }
+
+    /// Decrement the reference count, unless the instruction is pinned.
+    void decref() { if (!pinned) RefCounted::decref(); }
+
+    /**
+     * Stop reference counting this instruction and its microops, so
+     * that they can be shared by decoders running in different
+     * threads; the reference count is not thread-safe. Pinned
+     * instructions are never freed. Must be called before the
+     * instruction is made visible to other threads. This applies to
+     * any instruction that decoders share outside of the decode
+     * caches, such as x86's badMicroop.
+     */
+    void pin();
+
 /**
  * The execute() signatures are auto-generated by scons based on the
  * set of CPU models we are compiling in today.
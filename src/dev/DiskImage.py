@@ -45,4 +45,6 @@ class CowDiskImage(DiskImage):
     child = Param.DiskImage(RawDiskImage(read_only=True),
                             "child image")
     table_size = Param.Int(65536, "initial table size")
+    compress_checkpoint = Param.Bool(True,
+        "Compress the sectors written to checkpoints in parallel")
     image_file = ""
@@ -39,9 +39,11 @@
 #include <cerrno>
 #include <cstring>
 #include <fstream>
+#include <sstream>
 #include <string>
 
 #include "base/callback.hh"
+#include "base/chunked_image.hh"
 #include "base/misc.hh"
 #include "base/trace.hh"
 #include "debug/DiskImageRead.hh"
@@ -169,7 +171,8 @@ class CowDiskCallback : public Callback
 };
 
 CowDiskImage::CowDiskImage(const Params *p)
-    : DiskImage(p), filename(p->image_file), child(p->child), table(NULL)
+    : DiskImage(p), filename(p->image_file), child(p->child), table(NULL),
+      compressCheckpoint(p->compress_checkpoint)
 {
     if (filename.empty()) {
         initSectorTable(p->table_size);
@@ -197,12 +200,9 @@ CowDiskImage::~CowDiskImage()
 }
 
 void
-SafeRead(ifstream &stream, void *data, int count)
+SafeRead(istream &stream, void *data, int count)
 {
     stream.read((char *)data, count);
-    if (!stream.is_open())
-        panic("file not open");
-
     if (stream.eof())
         panic("premature end-of-file");
 
@@ -212,14 +212,14 @@ SafeRead(ifstream &stream, void *data, int count)
 
 template<class T>
 void
-SafeRead(ifstream &stream, T &data)
+SafeRead(istream &stream, T &data)
 {
     SafeRead(stream, &data, sizeof(data));
 }
 
 template<class T>
 void
-SafeReadSwap(ifstream &stream, T &data)
+SafeReadSwap(istream &stream, T &data)
 {
     SafeRead(stream, &data, sizeof(data));
     data = letoh(data); //is this the proper byte order conversion?
@@ -235,6 +235,15 @@ CowDiskImage::open(const string &file)
     if (stream.fail() || stream.bad())
         panic("Error opening %s", file);
 
+    load(stream, file);
+    stream.close();
+
+    return true;
+}
+
+void
+CowDiskImage::load(istream &stream, const string &file)
+{
     uint64_t magic;
     SafeRead(stream, magic);
 
@@ -265,10 +274,7 @@ CowDiskImage::open(const string &file)
         (*table)[offset] = sector;
     }
 
-    stream.close();
-
     initialized = true;
-    return true;
 }
 
 void
@@ -280,12 +286,9 @@ CowDiskImage::initSectorTable(int hash_size)
 }
 
 void
-SafeWrite(ofstream &stream, const void *data, int count)
+SafeWrite(ostream &stream, const void *data, int count)
 {
     stream.write((const char *)data, count);
-    if (!stream.is_open())
-        panic("file not open");
-
     if (stream.eof())
         panic("premature end-of-file");
 
@@ -295,14 +298,14 @@ SafeWrite(ofstream &stream, const void *data, int count)
 
 template<class T>
 void
-SafeWrite(ofstream &stream, const T &data)
+SafeWrite(ostream &stream, const T &data)
 {
     SafeWrite(stream, &data, sizeof(data));
 }
 
 template<class T>
 void
-SafeWriteSwap(ofstream &stream, const T &data)
+SafeWriteSwap(ostream &stream, const T &data)
 {
     T swappeddata = letoh(data); //is this the proper byte order conversion?
     SafeWrite(stream, &swappeddata, sizeof(data));
@@ -323,6 +326,13 @@ CowDiskImage::save(const string &file)
     if (!stream.is_open() || stream.fail() || stream.bad())
         panic("Error opening %s", file);
 
+    save(stream);
+    stream.close();
+}
+
+void
+CowDiskImage::save(ostream &stream)
+{
     uint64_t magic;
     memcpy(&magic, "COWDISK!", sizeof(magic));
     SafeWrite(stream, magic);
@@ -343,8 +353,6 @@ CowDiskImage::save(const string &file)
         SafeWrite(stream, (*iter).second->data, sizeof(Sector));
         ++iter;
     }
-
-    stream.close();
 }
 
 void
@@ -410,9 +418,30 @@ CowDiskImage::write(const uint8_t *data, std::streampos offset)
 void
 CowDiskImage::serialize(ostream &os)
 {
-    string cowFilename = name() + ".cow";
+    if (!compressCheckpoint) {
+        string cowFilename = name() + ".cow";
+        SERIALIZE_SCALAR(cowFilename);
+        save(Checkpoint::dir() + "/" + cowFilename);
+        return;
+    }
+
+    // the image is built in memory and then compressed by as many
+    // threads as there are host cores
+    if (!initialized)
+        panic("CowDiskImage not initialized");
+
+    ostringstream image;
+    save(image);
+    string data = image.str();
+
+    string cowFilename = name() + ".cow.z";
+    string cowFormat = "chunked";
+    uint64_t cowSize = data.size();
     SERIALIZE_SCALAR(cowFilename);
-    save(Checkpoint::dir() + "/" + cowFilename);
+    SERIALIZE_SCALAR(cowFormat);
+    SERIALIZE_SCALAR(cowSize);
+    ChunkedImage::write(Checkpoint::dir() + "/" + cowFilename,
+                        (const uint8_t *)data.data(), data.size());
 }
 
 void
@@ -421,7 +450,25 @@ CowDiskImage::unserialize(Checkpoint *cp, const string &section)
     string cowFilename;
     UNSERIALIZE_SCALAR(cowFilename);
     cowFilename = cp->cptDir + "/" + cowFilename;
-    open(cowFilename);
+
+    // checkpoints without a format hold the image as is
+    string cowFormat = "raw";
+    UNSERIALIZE_OPT_SCALAR(cowFormat);
+
+    if (cowFormat == "raw") {
+        open(cowFilename);
+    } else if (cowFormat == "chunked") {
+        uint64_t cowSize;
+        UNSERIALIZE_SCALAR(cowSize);
+
+        string data(cowSize, '\0');
+        ChunkedImage::read(cowFilename, (uint8_t *)&data[0], cowSize);
+        istringstream image(data);
+        load(image, cowFilename);
+    } else {
+        fatal("Unknown format '%s' of COW disk image '%s'\n", cowFormat,
+              cowFilename);
+    }
 }
 
 CowDiskImage *
@@ -118,6 +118,15 @@ class CowDiskImage : public DiskImage
     DiskImage *child;
     SectorTable *table;
 
+    /** Write checkpoints as chunked images rather than raw files. */
+    bool compressCheckpoint;
+
+    /** Read the sector table from a stream in the file format. */
+    void load(std::istream &stream, const std::string &file);
+
+    /** Write the sector table to a stream in the file format. */
+    void save(std::ostream &stream);
+
   public:
     typedef CowDiskImageParams Params;
     CowDiskImage(const Params *p);
@@ -137,20 +146,20 @@ class CowDiskImage : public DiskImage
     virtual std::streampos write(const uint8_t *data, std::streampos offset);
 };
 
-void SafeRead(std::ifstream &stream, void *data, int count);
+void SafeRead(std::istream &stream, void *data, int count);
 
 template<class T>
-void SafeRead(std::ifstream &stream, T &data);
+void SafeRead(std::istream &stream, T &data);
 
 template<class T>
-void SafeReadSwap(std::ifstream &stream, T &data);
+void SafeReadSwap(std::istream &stream, T &data);
 
-void SafeWrite(std::ofstream &stream, const void *data, int count);
+void SafeWrite(std::ostream &stream, const void *data, int count);
 
 template<class T>
-void SafeWrite(std::ofstream &stream, const T &data);
+void SafeWrite(std::ostream &stream, const T &data);
 
 template<class T>
-void SafeWriteSwap(std::ofstream &stream, const T &data);
+void SafeWriteSwap(std::ostream &stream, const T &data);
 
 #endif // __DISK_IMAGE_HH__
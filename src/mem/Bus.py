@@ -40,6 +40,7 @@
 #          Andreas Hansson
 
 from MemObject import MemObject
+from SnoopFilter import SnoopFilter
 from System import System
 from m5.params import *
 from m5.proxy import *
@@ -74,3 +75,7 @@ class CoherentBus(BaseBus):
     cxx_header = "mem/coherent_bus.hh"
 
     system = Param.System(Parent.any, "System that the bus belongs to.")
+
+    # Optionally track the snooping masters that may hold a line and
+    # only forward snoops to those, rather than to all of them
+    snoop_filter = Param.SnoopFilter(NULL, "Snoop filter")
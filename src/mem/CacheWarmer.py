@@ -0,0 +1,53 @@
+# Copyright (c) 2014 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.SimObject import SimObject
+from m5.params import *
+from m5.proxy import *
+
+class CacheWarmer(SimObject):
+    type = 'CacheWarmer'
+    cxx_header = "mem/cache_warmer.hh"
+
+    @classmethod
+    def export_methods(cls, code):
+        code('''
+    void startRecording();
+    void warm();
+''')
+
+    system = Param.System(Parent.any, "system the caches belong to")
+    cpus = VectorParam.BaseCPU([], "CPUs whose accesses are recorded")
+    icaches = VectorParam.BaseCache([], "instruction caches of the CPUs, "
+                                    "in the same order as cpus")
+    dcaches = VectorParam.BaseCache([], "data caches of the CPUs, "
+                                    "in the same order as cpus")
+    shared_caches = VectorParam.BaseCache([], "shared cache levels, "
+                                          "closest to the CPUs first")
+    targets = VectorParam.SimObject([], "other memory systems to warm "
+                                    "(e.g., a RubySystem)")
+    max_records = Param.Unsigned(4194304, "number of most recent accesses "
+                                 "kept in the trace")
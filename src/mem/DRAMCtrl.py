@@ -42,9 +42,12 @@
 from m5.params import *
 from AbstractMemory import *
 
-# Enum for memory scheduling algorithms, currently First-Come
-# First-Served and a First-Row Hit then First-Come First-Served
-class MemSched(Enum): vals = ['fcfs', 'frfcfs']
+# Enum for memory scheduling algorithms: First-Come First-Served, First-Row
+# Hit then First-Come First-Served, FR-FCFS with a cap on the row hits
+# overtaking older requests, FR-FCFS within batches of requests formed in
+# order of arrival, and the Blacklisting scheduler (BLISS) that
+# deprioritises masters that were recently served many requests in a row
+class MemSched(Enum): vals = ['fcfs', 'frfcfs', 'frfcfs_cap', 'batch', 'bliss']
 
 # Enum for the address mapping. With Ch, Ra, Ba, Ro and Co denoting
 # channel, rank, bank, row and column, respectively, and going from
@@ -89,6 +92,18 @@ class DRAMCtrl(AbstractMemory):
 
     # scheduler, address map and page policy
     mem_sched_policy = Param.MemSched('frfcfs', "Memory scheduling policy")
+
+    # number of row hits that FR-FCFS-Cap allows to overtake an older
+    # request to the same bank
+    row_hit_cap = Param.Unsigned(4, "Max row hits overtaking an older "
+                                 "request")
+
+    # BLISS blacklists a master after this many consecutive requests,
+    # and clears the blacklist at the given interval
+    bliss_threshold = Param.Unsigned(4, "Consecutive requests before a "
+                                     "master is blacklisted")
+    bliss_clearing_interval = Param.Latency("10us", "Interval at which the "
+                                            "blacklist is cleared")
     addr_mapping = Param.AddrMap('RoRaBaChCo', "Address mapping policy")
     page_policy = Param.PageManage('open_adaptive', "Page management policy")
 
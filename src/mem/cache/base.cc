@@ -49,6 +49,8 @@
 #include "debug/Drain.hh"
 #include "mem/cache/tags/fa_lru.hh"
 #include "mem/cache/tags/lru.hh"
+#include "mem/cache/tags/packed_lru.hh"
+#include "mem/cache/tags/set_assoc.hh"
 #include "mem/cache/base.hh"
 #include "mem/cache/cache.hh"
 #include "mem/cache/mshr.hh"
@@ -779,10 +781,15 @@ BaseCacheParams::create()
         if (numSets != 1)
             fatal("Got FALRU tags with more than one set\n");
         return new Cache<FALRU>(this);
+    } else if (dynamic_cast<PackedLRU*>(tags)) {
+        // check before LRU, which PackedLRU derives from
+        return new Cache<PackedLRU>(this);
     } else if (dynamic_cast<LRU*>(tags)) {
         if (numSets == 1)
             warn("Consider using FALRU tags for a fully associative cache\n");
         return new Cache<LRU>(this);
+    } else if (dynamic_cast<SetAssoc*>(tags)) {
+        return new Cache<SetAssoc>(this);
     } else {
         fatal("No suitable tags selected\n");
     }
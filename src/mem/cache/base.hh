@@ -564,6 +564,34 @@ class BaseCache : public MemObject
 
     virtual bool inMissQueue(Addr addr, bool is_secure) const = 0;
 
+    /**
+     * Functionally bring a block into the cache, or touch it if it is
+     * already present, to warm the cache. No timing is modelled and
+     * the hit, miss and writeback statistics of the cache are left
+     * alone. The tag store does count the access or insertion in its
+     * own statistics (tag and data accesses, replacements, occupancy)
+     * as it does for any other, which is harmless when the statistics
+     * are reset before measuring, as sampling does. The state of a
+     * present block is only ever upgraded.
+     *
+     * @param addr Address of the block.
+     * @param is_secure Security state of the block.
+     * @param writable Give the block write permission.
+     * @param dirty Mark the block dirty.
+     * @param data Contents of the block, used if it isn't present.
+     * @param writebacks Dirty blocks evicted to make room, which the
+     * caller has to pass on and delete.
+     */
+    virtual void warmBlock(Addr addr, bool is_secure, bool writable,
+                           bool dirty, const uint8_t *data,
+                           PacketList &writebacks) = 0;
+
+    /**
+     * Functionally snoop a block while warming the cache, either
+     * invalidating it or taking away its write permission.
+     */
+    virtual void warmSnoop(Addr addr, bool is_secure, bool invalidate) = 0;
+
     void incMissCount(PacketPtr pkt)
     {
         assert(pkt->req->masterId() < system->maxMasters());
@@ -38,6 +38,8 @@
 
 #include "mem/cache/tags/fa_lru.hh"
 #include "mem/cache/tags/lru.hh"
+#include "mem/cache/tags/packed_lru.hh"
+#include "mem/cache/tags/set_assoc.hh"
 #include "mem/cache/cache_impl.hh"
 
 // Template Instantiations
@@ -45,5 +47,7 @@
 
 template class Cache<FALRU>;
 template class Cache<LRU>;
+template class Cache<PackedLRU>;
+template class Cache<SetAssoc>;
 
 #endif //DOXYGEN_SHOULD_SKIP_THIS
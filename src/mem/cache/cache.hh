@@ -397,6 +397,10 @@ class Cache : public BaseCache
         return (mshrQueue.findMatch(addr, is_secure) != 0);
     }
 
+    void warmBlock(Addr addr, bool is_secure, bool writable, bool dirty,
+                   const uint8_t *data, PacketList &writebacks);
+    void warmSnoop(Addr addr, bool is_secure, bool invalidate);
+
     /**
      * Find next request ready time from among possible sources.
      */
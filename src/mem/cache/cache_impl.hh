@@ -1140,6 +1140,79 @@ Cache<TagStore>::isDirty() const
     return visitor.isDirty();
 }
 
+template<class TagStore>
+void
+Cache<TagStore>::warmBlock(Addr addr, bool is_secure, bool writable,
+                           bool dirty, const uint8_t *data,
+                           PacketList &writebacks)
+{
+    addr = blockAlign(addr);
+    BlkType *blk = tags->findBlock(addr, is_secure);
+
+    if (blk) {
+        // Only update the replacement state
+        Cycles lat;
+        tags->accessBlock(addr, is_secure, lat, Request::funcMasterId);
+    } else {
+        blk = tags->findVictim(addr);
+        if (blk->isValid()) {
+            Addr repl_addr = tags->regenerateBlkAddr(blk->tag, blk->set);
+            if (mshrQueue.findMatch(repl_addr, blk->isSecure())) {
+                // Leave blocks in transient states alone
+                return;
+            }
+
+            if (blk->isDirty()) {
+                // Same as writebackBlk(), without the statistics
+                Request *req = new Request(repl_addr, blkSize, 0,
+                                           Request::wbMasterId);
+                if (blk->isSecure())
+                    req->setFlags(Request::SECURE);
+                PacketPtr writeback = new Packet(req, MemCmd::Writeback);
+                if (blk->isWritable())
+                    writeback->setSupplyExclusive();
+                writeback->allocate();
+                std::memcpy(writeback->getPtr<uint8_t>(), blk->data, blkSize);
+                writebacks.push_back(writeback);
+            }
+        }
+
+        Request req(addr, blkSize, 0, Request::funcMasterId);
+        if (is_secure)
+            req.setFlags(Request::SECURE);
+        Packet pkt(&req, MemCmd::ReadReq);
+        tags->insertBlock(&pkt, blk);
+
+        blk->status |= BlkValid | BlkReadable;
+        std::memcpy(blk->data, data, blkSize);
+        blk->whenReady = curTick();
+    }
+
+    DPRINTF(Cache, "Warming block addr %x (%s), writable %d, dirty %d\n",
+            addr, is_secure ? "s" : "ns", writable, dirty);
+
+    if (writable)
+        blk->status |= BlkWritable;
+    if (dirty)
+        blk->status |= BlkDirty;
+}
+
+template<class TagStore>
+void
+Cache<TagStore>::warmSnoop(Addr addr, bool is_secure, bool invalidate)
+{
+    BlkType *blk = tags->findBlock(blockAlign(addr), is_secure);
+    if (!blk)
+        return;
+
+    if (invalidate) {
+        tags->invalidate(blk);
+        blk->invalidate();
+    } else {
+        blk->status &= ~BlkWritable;
+    }
+}
+
 template<class TagStore>
 bool
 Cache<TagStore>::writebackVisitor(BlkType &blk)
@@ -50,6 +50,7 @@
 
 #include <list>
 
+#include "base/pooled_list.hh"
 #include "base/printable.hh"
 #include "mem/packet.hh"
 
@@ -115,10 +116,10 @@ class MSHR : public Packet::SenderState, public Printable
         {}
     };
 
-    class TargetList : public std::list<Target> {
+    class TargetList : public PooledList<Target> {
         /** Target list iterator. */
-        typedef std::list<Target>::iterator Iterator;
-        typedef std::list<Target>::const_iterator ConstIterator;
+        typedef PooledList<Target>::iterator Iterator;
+        typedef PooledList<Target>::const_iterator ConstIterator;
 
       public:
         bool needsExclusive;
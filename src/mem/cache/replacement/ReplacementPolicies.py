@@ -0,0 +1,65 @@
+# Copyright (c) 2014 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.SimObject import SimObject
+from m5.params import *
+
+class BaseReplacementPolicy(SimObject):
+    type = 'BaseReplacementPolicy'
+    abstract = True
+    cxx_header = "mem/cache/replacement/base.hh"
+
+class LRURP(BaseReplacementPolicy):
+    type = 'LRURP'
+    cxx_class = 'LRURP'
+    cxx_header = "mem/cache/replacement/lru.hh"
+
+class TreePLRURP(BaseReplacementPolicy):
+    type = 'TreePLRURP'
+    cxx_class = 'TreePLRURP'
+    cxx_header = "mem/cache/replacement/tree_plru.hh"
+
+class RandomRP(BaseReplacementPolicy):
+    type = 'RandomRP'
+    cxx_class = 'RandomRP'
+    cxx_header = "mem/cache/replacement/random_rp.hh"
+
+class BRRIPRP(BaseReplacementPolicy):
+    type = 'BRRIPRP'
+    cxx_class = 'BRRIPRP'
+    cxx_header = "mem/cache/replacement/brrip.hh"
+    num_bits = Param.Unsigned(2, "Number of bits per re-reference prediction")
+    # Percentage of fills predicted to be re-referenced in the long
+    # rather than the distant future
+    btp = Param.Percent(3, "Bimodal throttle parameter")
+
+class SRRIPRP(BRRIPRP):
+    btp = 100
+
+class LFURP(BaseReplacementPolicy):
+    type = 'LFURP'
+    cxx_class = 'LFURP'
+    cxx_header = "mem/cache/replacement/lfu.hh"
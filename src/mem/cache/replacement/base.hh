@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of the interface of cache replacement policies.
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_BASE_HH__
+#define __MEM_CACHE_REPLACEMENT_BASE_HH__
+
+#include "params/BaseReplacementPolicy.hh"
+#include "sim/sim_object.hh"
+
+/**
+ * A replacement policy for a set associative tag store. The policy
+ * keeps its own state for every block, identified by its set and
+ * way, so the tag store never has to reorder its blocks. The tag
+ * store tells the policy about every hit, fill and invalidation, and
+ * asks it for a victim when all ways of a set are valid.
+ */
+class BaseReplacementPolicy : public SimObject
+{
+  protected:
+    /** Number of sets of the tag store, 0 until setGeometry(). */
+    unsigned numSets;
+    /** Associativity of the tag store. */
+    unsigned assoc;
+
+  public:
+    /** Convenience typedef. */
+    typedef BaseReplacementPolicyParams Params;
+
+    BaseReplacementPolicy(const Params *p);
+
+    /**
+     * Size the replacement state for a tag store. Called once by the
+     * tag store using the policy, before any other method.
+     * @param num_sets The number of sets.
+     * @param assoc The associativity.
+     */
+    virtual void setGeometry(unsigned num_sets, unsigned assoc);
+
+    /**
+     * A valid block was accessed.
+     * @param set The set of the block.
+     * @param way The way of the block.
+     */
+    virtual void touch(unsigned set, unsigned way) = 0;
+
+    /**
+     * A new block was inserted.
+     * @param set The set of the block.
+     * @param way The way of the block.
+     */
+    virtual void insert(unsigned set, unsigned way) = 0;
+
+    /**
+     * A block was invalidated. Invalid ways are filled before the
+     * policy is asked for a victim, so by default this does nothing.
+     * @param set The set of the block.
+     * @param way The way of the block.
+     */
+    virtual void invalidate(unsigned set, unsigned way) {}
+
+    /**
+     * Choose a block to evict from a set in which all ways are valid.
+     * @param set The set to evict from.
+     * @return The way of the victim.
+     */
+    virtual unsigned getVictim(unsigned set) = 0;
+};
+
+#endif // __MEM_CACHE_REPLACEMENT_BASE_HH__
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definition of a re-reference interval prediction replacement policy.
+ */
+
+#include "base/misc.hh"
+#include "base/random.hh"
+#include "mem/cache/replacement/brrip.hh"
+
+BRRIPRP::BRRIPRP(const Params *p)
+    : BaseReplacementPolicy(p), maxRRPV((1 << p->num_bits) - 1),
+      btp(p->btp)
+{
+    if (p->num_bits < 1 || p->num_bits > 8)
+        fatal("RRIP replacement policy %s needs between 1 and 8 bits\n",
+              name());
+}
+
+void
+BRRIPRP::setGeometry(unsigned num_sets, unsigned _assoc)
+{
+    BaseReplacementPolicy::setGeometry(num_sets, _assoc);
+    rrpvs.assign(numSets * assoc, maxRRPV);
+}
+
+void
+BRRIPRP::insert(unsigned set, unsigned way)
+{
+    uint8_t rrpv = maxRRPV;
+    if (btp >= 100 || random_mt.random<unsigned>(0, 99) < btp)
+        rrpv = maxRRPV - 1;
+    rrpvs[set * assoc + way] = rrpv;
+}
+
+unsigned
+BRRIPRP::getVictim(unsigned set)
+{
+    uint8_t *set_rrpvs = &rrpvs[set * assoc];
+
+    // The first block with the most distant prediction is the victim
+    unsigned victim = 0;
+    for (unsigned i = 1; i < assoc; ++i) {
+        if (set_rrpvs[i] > set_rrpvs[victim])
+            victim = i;
+    }
+
+    // Age the set until the victim is predicted as distant, all at
+    // once rather than one step at a time
+    uint8_t age = maxRRPV - set_rrpvs[victim];
+    if (age) {
+        for (unsigned i = 0; i < assoc; ++i)
+            set_rrpvs[i] += age;
+    }
+
+    return victim;
+}
+
+BRRIPRP *
+BRRIPRPParams::create()
+{
+    return new BRRIPRP(this);
+}
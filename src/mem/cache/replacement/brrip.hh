@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a re-reference interval prediction replacement policy.
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_BRRIP_HH__
+#define __MEM_CACHE_REPLACEMENT_BRRIP_HH__
+
+#include <vector>
+
+#include "base/types.hh"
+#include "mem/cache/replacement/base.hh"
+#include "params/BRRIPRP.hh"
+
+/**
+ * Re-reference interval prediction (Jaleel et al., ISCA 2010). Every
+ * block holds a small counter predicting how far in the future it
+ * will be referenced again: 0 for the near future, up to the largest
+ * value for the distant future. Hits predict a near re-reference,
+ * and the victim is a block predicted to be re-referenced in the
+ * distant future, after ageing the whole set if there is none.
+ *
+ * Fills are predicted to be re-referenced in the distant future,
+ * except for a fraction btp of them that are predicted to be
+ * re-referenced in the long (one less than distant) future. That is
+ * bimodal RRIP, which protects the cache from thrashing, and with btp
+ * at 100% it is static RRIP, which protects it from scans.
+ */
+class BRRIPRP : public BaseReplacementPolicy
+{
+  private:
+    /** The largest re-reference prediction, meaning distant. */
+    const uint8_t maxRRPV;
+
+    /** Percentage of fills predicted as long rather than distant. */
+    const unsigned btp;
+
+    /** Re-reference prediction of every block, assoc per set. */
+    std::vector<uint8_t> rrpvs;
+
+  public:
+    /** Convenience typedef. */
+    typedef BRRIPRPParams Params;
+
+    BRRIPRP(const Params *p);
+
+    void setGeometry(unsigned num_sets, unsigned assoc);
+
+    void touch(unsigned set, unsigned way) { rrpvs[set * assoc + way] = 0; }
+    void insert(unsigned set, unsigned way);
+
+    void
+    invalidate(unsigned set, unsigned way)
+    {
+        rrpvs[set * assoc + way] = maxRRPV;
+    }
+
+    unsigned getVictim(unsigned set);
+};
+
+#endif // __MEM_CACHE_REPLACEMENT_BRRIP_HH__
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definition of a LFU replacement policy.
+ */
+
+#include "mem/cache/replacement/lfu.hh"
+
+LFURP::LFURP(const Params *p)
+    : BaseReplacementPolicy(p)
+{
+}
+
+void
+LFURP::setGeometry(unsigned num_sets, unsigned _assoc)
+{
+    BaseReplacementPolicy::setGeometry(num_sets, _assoc);
+    counts.assign(numSets * assoc, 0);
+}
+
+void
+LFURP::touch(unsigned set, unsigned way)
+{
+    uint8_t *set_counts = &counts[set * assoc];
+    if (set_counts[way] == 0xff) {
+        for (unsigned i = 0; i < assoc; ++i)
+            set_counts[i] >>= 1;
+    }
+    ++set_counts[way];
+}
+
+unsigned
+LFURP::getVictim(unsigned set)
+{
+    const uint8_t *set_counts = &counts[set * assoc];
+
+    // The first block with the fewest references is the victim
+    unsigned victim = 0;
+    for (unsigned i = 1; i < assoc; ++i) {
+        if (set_counts[i] < set_counts[victim])
+            victim = i;
+    }
+
+    return victim;
+}
+
+LFURP *
+LFURPParams::create()
+{
+    return new LFURP(this);
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a LFU replacement policy.
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_LFU_HH__
+#define __MEM_CACHE_REPLACEMENT_LFU_HH__
+
+#include <vector>
+
+#include "base/types.hh"
+#include "mem/cache/replacement/base.hh"
+#include "params/LFURP.hh"
+
+/**
+ * Least frequently used replacement. Every block counts its
+ * references in a one byte counter. When a counter would overflow,
+ * all counters of the set are halved, which keeps their relative
+ * order and makes the policy favour recent over old references.
+ */
+class LFURP : public BaseReplacementPolicy
+{
+  private:
+    /** Reference count of every block, assoc per set. */
+    std::vector<uint8_t> counts;
+
+  public:
+    /** Convenience typedef. */
+    typedef LFURPParams Params;
+
+    LFURP(const Params *p);
+
+    void setGeometry(unsigned num_sets, unsigned assoc);
+
+    void touch(unsigned set, unsigned way);
+    void insert(unsigned set, unsigned way) { counts[set * assoc + way] = 1; }
+
+    void
+    invalidate(unsigned set, unsigned way)
+    {
+        counts[set * assoc + way] = 0;
+    }
+
+    unsigned getVictim(unsigned set);
+};
+
+#endif // __MEM_CACHE_REPLACEMENT_LFU_HH__
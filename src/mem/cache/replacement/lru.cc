@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definition of a LRU replacement policy.
+ */
+
+#include "base/misc.hh"
+#include "mem/cache/replacement/lru.hh"
+
+LRURP::LRURP(const Params *p)
+    : BaseReplacementPolicy(p)
+{
+}
+
+void
+LRURP::setGeometry(unsigned num_sets, unsigned _assoc)
+{
+    BaseReplacementPolicy::setGeometry(num_sets, _assoc);
+    if (assoc > 256)
+        fatal("LRU replacement policy %s supports at most 256 ways\n",
+              name());
+
+    // Start out with the blocks of every set ranked in way order
+    ranks.resize(numSets * assoc);
+    for (unsigned i = 0; i < numSets; ++i) {
+        for (unsigned j = 0; j < assoc; ++j)
+            ranks[i * assoc + j] = j;
+    }
+}
+
+void
+LRURP::setRank(unsigned set, unsigned way, unsigned rank)
+{
+    uint8_t *set_ranks = &ranks[set * assoc];
+    unsigned old_rank = set_ranks[way];
+
+    if (rank < old_rank) {
+        for (unsigned i = 0; i < assoc; ++i) {
+            if (set_ranks[i] >= rank && set_ranks[i] < old_rank)
+                ++set_ranks[i];
+        }
+    } else {
+        for (unsigned i = 0; i < assoc; ++i) {
+            if (set_ranks[i] > old_rank && set_ranks[i] <= rank)
+                --set_ranks[i];
+        }
+    }
+    set_ranks[way] = rank;
+}
+
+unsigned
+LRURP::getVictim(unsigned set)
+{
+    const uint8_t *set_ranks = &ranks[set * assoc];
+    for (unsigned i = 0; i < assoc; ++i) {
+        if (set_ranks[i] == assoc - 1)
+            return i;
+    }
+
+    panic("LRU ranks of set %d are corrupt\n", set);
+}
+
+LRURP *
+LRURPParams::create()
+{
+    return new LRURP(this);
+}
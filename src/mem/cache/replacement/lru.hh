@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a LRU replacement policy.
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_LRU_HH__
+#define __MEM_CACHE_REPLACEMENT_LRU_HH__
+
+#include <vector>
+
+#include "base/types.hh"
+#include "mem/cache/replacement/base.hh"
+#include "params/LRURP.hh"
+
+/**
+ * Least recently used replacement. Rather than keeping the blocks of
+ * a set in a list, every block holds a one byte rank in the recency
+ * order of its set, so a hit only updates a few bytes in one cache
+ * line of replacement state.
+ */
+class LRURP : public BaseReplacementPolicy
+{
+  private:
+    /**
+     * Recency rank of every block, assoc per set. The most recently
+     * used block of a set has rank 0, the least recently used one
+     * assoc - 1.
+     */
+    std::vector<uint8_t> ranks;
+
+    /**
+     * Move a block to the given rank, shifting the blocks in between.
+     * @param set The set of the block.
+     * @param way The way of the block.
+     * @param rank The new rank of the block.
+     */
+    void setRank(unsigned set, unsigned way, unsigned rank);
+
+  public:
+    /** Convenience typedef. */
+    typedef LRURPParams Params;
+
+    LRURP(const Params *p);
+
+    void setGeometry(unsigned num_sets, unsigned assoc);
+
+    void touch(unsigned set, unsigned way) { setRank(set, way, 0); }
+    void insert(unsigned set, unsigned way) { setRank(set, way, 0); }
+
+    void
+    invalidate(unsigned set, unsigned way)
+    {
+        setRank(set, way, assoc - 1);
+    }
+
+    unsigned getVictim(unsigned set);
+};
+
+#endif // __MEM_CACHE_REPLACEMENT_LRU_HH__
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a random replacement policy.
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_RANDOM_RP_HH__
+#define __MEM_CACHE_REPLACEMENT_RANDOM_RP_HH__
+
+#include "mem/cache/replacement/base.hh"
+#include "params/RandomRP.hh"
+
+/**
+ * Random replacement. No state is kept at all, the victim is drawn
+ * uniformly from the ways of the set.
+ */
+class RandomRP : public BaseReplacementPolicy
+{
+  public:
+    /** Convenience typedef. */
+    typedef RandomRPParams Params;
+
+    RandomRP(const Params *p);
+
+    void touch(unsigned set, unsigned way) {}
+    void insert(unsigned set, unsigned way) {}
+
+    unsigned getVictim(unsigned set);
+};
+
+#endif // __MEM_CACHE_REPLACEMENT_RANDOM_RP_HH__
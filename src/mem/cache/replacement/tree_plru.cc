@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definition of a tree pseudo-LRU replacement policy.
+ */
+
+#include "base/intmath.hh"
+#include "base/misc.hh"
+#include "mem/cache/replacement/tree_plru.hh"
+
+TreePLRURP::TreePLRURP(const Params *p)
+    : BaseReplacementPolicy(p), levels(0)
+{
+}
+
+void
+TreePLRURP::setGeometry(unsigned num_sets, unsigned _assoc)
+{
+    BaseReplacementPolicy::setGeometry(num_sets, _assoc);
+    if (!isPowerOf2(assoc) || assoc > 64)
+        fatal("Tree PLRU replacement policy %s needs a power of 2 "
+              "associativity of at most 64\n", name());
+
+    levels = floorLog2(assoc);
+    trees.assign(numSets, 0);
+}
+
+unsigned
+TreePLRURP::getVictim(unsigned set)
+{
+    uint64_t tree = trees[set];
+    unsigned node = 0;
+    unsigned way = 0;
+    for (unsigned level = 0; level < levels; ++level) {
+        unsigned right = (tree >> node) & 1;
+        way = (way << 1) | right;
+        node = 2 * node + 1 + right;
+    }
+
+    return way;
+}
+
+TreePLRURP *
+TreePLRURPParams::create()
+{
+    return new TreePLRURP(this);
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a tree pseudo-LRU replacement policy.
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_TREE_PLRU_HH__
+#define __MEM_CACHE_REPLACEMENT_TREE_PLRU_HH__
+
+#include <vector>
+
+#include "base/types.hh"
+#include "mem/cache/replacement/base.hh"
+#include "params/TreePLRURP.hh"
+
+/**
+ * Tree pseudo-LRU replacement, as commonly built in hardware. The
+ * ways of a set are the leaves of a binary tree, and every inner node
+ * holds one bit pointing at the half of its subtree that was used
+ * least recently. An access flips the bits on the path to its way to
+ * point away from it, and the victim is found by following the bits
+ * from the root. A set of n ways needs n - 1 bits, so the state of a
+ * set fits in a single word and every update is O(log n).
+ */
+class TreePLRURP : public BaseReplacementPolicy
+{
+  private:
+    /**
+     * The tree of every set. Node i has children 2i + 1 and 2i + 2,
+     * and its bit is set when the victim is in its right subtree.
+     */
+    std::vector<uint64_t> trees;
+
+    /** Depth of the trees, log2 of the associativity. */
+    unsigned levels;
+
+    /**
+     * Update the bits on the path from the root to a way.
+     * @param set The set of the way.
+     * @param way The way.
+     * @param toward Point the bits toward rather than away from the way.
+     */
+    void
+    update(unsigned set, unsigned way, bool toward)
+    {
+        uint64_t &tree = trees[set];
+        unsigned node = 0;
+        for (int level = levels - 1; level >= 0; --level) {
+            unsigned right = (way >> level) & 1;
+            if (right == toward)
+                tree |= ULL(1) << node;
+            else
+                tree &= ~(ULL(1) << node);
+            node = 2 * node + 1 + right;
+        }
+    }
+
+  public:
+    /** Convenience typedef. */
+    typedef TreePLRURPParams Params;
+
+    TreePLRURP(const Params *p);
+
+    void setGeometry(unsigned num_sets, unsigned assoc);
+
+    void touch(unsigned set, unsigned way) { update(set, way, false); }
+    void insert(unsigned set, unsigned way) { update(set, way, false); }
+    void invalidate(unsigned set, unsigned way) { update(set, way, true); }
+
+    unsigned getVictim(unsigned set);
+};
+
+#endif // __MEM_CACHE_REPLACEMENT_TREE_PLRU_HH__
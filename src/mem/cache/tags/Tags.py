@@ -38,6 +38,7 @@
 from m5.params import *
 from m5.proxy import *
 from ClockedObject import ClockedObject
+from ReplacementPolicies import *
 
 class BaseTags(ClockedObject):
     type = 'BaseTags'
@@ -61,6 +62,21 @@ class LRU(BaseTags):
     sequential_access = Param.Bool(Parent.sequential_access,
         "Whether to access tags and data sequentially")
 
+class PackedLRU(LRU):
+    type = 'PackedLRU'
+    cxx_class = 'PackedLRU'
+    cxx_header = "mem/cache/tags/packed_lru.hh"
+
+class SetAssoc(BaseTags):
+    type = 'SetAssoc'
+    cxx_class = 'SetAssoc'
+    cxx_header = "mem/cache/tags/set_assoc.hh"
+    assoc = Param.Int(Parent.assoc, "associativity")
+    sequential_access = Param.Bool(Parent.sequential_access,
+        "Whether to access tags and data sequentially")
+    replacement_policy = Param.BaseReplacementPolicy(LRURP(),
+        "Replacement policy")
+
 class FALRU(BaseTags):
     type = 'FALRU'
     cxx_class = 'FALRU'
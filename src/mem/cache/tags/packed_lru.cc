@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a LRU tag store with packed tags.
+ */
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "base/intmath.hh"
+#include "debug/CacheRepl.hh"
+#include "mem/cache/tags/packed_lru.hh"
+#include "mem/cache/base.hh"
+
+PackedLRU::PackedLRU(const Params *p)
+    : LRU(p), paddedAssoc(roundUp(assoc, 2))
+{
+    tagArray = new Addr[numSets * paddedAssoc];
+    for (unsigned i = 0; i < numSets; ++i) {
+        for (unsigned j = 0; j < paddedAssoc; ++j) {
+            // tags are at most 62 bits wide as blocks are at least 4
+            // bytes, so padding can never match
+            tagArray[i * paddedAssoc + j] =
+                j < assoc ? blks[i * assoc + j].tag : MaxAddr;
+        }
+    }
+}
+
+PackedLRU::~PackedLRU()
+{
+    delete [] tagArray;
+}
+
+PackedLRU::BlkType*
+PackedLRU::findBlk(unsigned set, Addr tag, bool is_secure) const
+{
+    const Addr *set_tags = &tagArray[set * paddedAssoc];
+    BlkType *set_blks = &blks[set * assoc];
+
+#if defined(__SSE2__)
+    const __m128i key = _mm_set1_epi64x(tag);
+    for (unsigned way = 0; way < paddedAssoc; way += 2) {
+        __m128i eq = _mm_cmpeq_epi32(
+            _mm_loadu_si128((const __m128i *)&set_tags[way]), key);
+        // a tag matches if both of its 32-bit halves do
+        eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+        int match = _mm_movemask_pd(_mm_castsi128_pd(eq));
+
+        // a set holds at most one valid block with a given tag, but
+        // invalid blocks may still carry it
+        for (int i = 0; match; ++i, match >>= 1) {
+            BlkType *blk = &set_blks[way + i];
+            if ((match & 1) && blk->isValid() && blk->isSecure() == is_secure)
+                return blk;
+        }
+    }
+#else
+    for (unsigned way = 0; way < assoc; ++way) {
+        BlkType *blk = &set_blks[way];
+        if (set_tags[way] == tag && blk->isValid() &&
+            blk->isSecure() == is_secure)
+            return blk;
+    }
+#endif
+
+    return NULL;
+}
+
+PackedLRU::BlkType*
+PackedLRU::accessBlock(Addr addr, bool is_secure, Cycles &lat, int master_id)
+{
+    Addr tag = extractTag(addr);
+    unsigned set = extractSet(addr);
+    BlkType *blk = findBlk(set, tag, is_secure);
+    lat = hitLatency;
+
+    // Access all tags in parallel, hence one in each way.  The data side
+    // either accesses all blocks in parallel, or one block sequentially on
+    // a hit.  Sequential access with a miss doesn't access data.
+    tagAccesses += assoc;
+    if (sequentialAccess) {
+        if (blk != NULL) {
+            dataAccesses += 1;
+        }
+    } else {
+        dataAccesses += assoc;
+    }
+
+    if (blk != NULL) {
+        // move this block to head of the MRU list
+        sets[set].moveToHead(blk);
+        DPRINTF(CacheRepl, "set %x: moving blk %x (%s) to MRU\n",
+                set, regenerateBlkAddr(tag, set), is_secure ? "s" : "ns");
+        if (blk->whenReady > curTick()
+            && cache->ticksToCycles(blk->whenReady - curTick()) > hitLatency) {
+            lat = cache->ticksToCycles(blk->whenReady - curTick());
+        }
+        blk->refCount += 1;
+    }
+
+    return blk;
+}
+
+PackedLRU::BlkType*
+PackedLRU::findBlock(Addr addr, bool is_secure) const
+{
+    return findBlk(extractSet(addr), extractTag(addr), is_secure);
+}
+
+void
+PackedLRU::insertBlock(PacketPtr pkt, BlkType *blk)
+{
+    LRU::insertBlock(pkt, blk);
+
+    // blocks are laid out set by set, assoc blocks per set
+    unsigned index = blk - blks;
+    tagArray[blk->set * paddedAssoc + index % assoc] = blk->tag;
+}
+
+PackedLRU *
+PackedLRUParams::create()
+{
+    return new PackedLRU(this);
+}
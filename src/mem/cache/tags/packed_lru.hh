@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a LRU tag store with packed tags.
+ */
+
+#ifndef __MEM_CACHE_TAGS_PACKED_LRU_HH__
+#define __MEM_CACHE_TAGS_PACKED_LRU_HH__
+
+#include "mem/cache/tags/lru.hh"
+#include "params/PackedLRU.hh"
+
+/**
+ * A LRU tag store that keeps the tags of every set contiguously in
+ * memory, so that a lookup compares the tags of several ways at once
+ * with SIMD instructions rather than chasing a pointer per way. The
+ * recency order is kept by the sets of the LRU tag store, which only
+ * need to be touched on hits and fills, so replacement decisions are
+ * identical to LRU.
+ */
+class PackedLRU : public LRU
+{
+  protected:
+    /** Number of tags per set in tagArray, a multiple of two. */
+    const unsigned paddedAssoc;
+
+    /**
+     * The tags of all blocks, paddedAssoc per set, in the order of
+     * the blocks in blks. Padding entries hold an impossible tag.
+     */
+    Addr *tagArray;
+
+    /**
+     * Find a valid block with the given tag in a set.
+     * @param set The set to search.
+     * @param tag The tag to find.
+     * @param is_secure True if the target memory space is secure.
+     * @return Pointer to the block if found.
+     */
+    BlkType *findBlk(unsigned set, Addr tag, bool is_secure) const;
+
+  public:
+    /** Convenience typedef. */
+    typedef PackedLRUParams Params;
+
+    /**
+     * Construct and initialize this tag store.
+     */
+    PackedLRU(const Params *p);
+
+    /**
+     * Destructor
+     */
+    virtual ~PackedLRU();
+
+    /**
+     * Access block and update replacement data, see LRU::accessBlock.
+     */
+    BlkType* accessBlock(Addr addr, bool is_secure, Cycles &lat,
+                         int context_src);
+
+    /**
+     * Finds the given address in the cache without updating the
+     * replacement data, see LRU::findBlock.
+     */
+    BlkType* findBlock(Addr addr, bool is_secure) const;
+
+    /**
+     * Insert the new block into the cache, see LRU::insertBlock.
+     */
+    void insertBlock(PacketPtr pkt, BlkType *blk);
+};
+
+#endif // __MEM_CACHE_TAGS_PACKED_LRU_HH__
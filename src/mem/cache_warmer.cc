@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+
+#include "cpu/base.hh"
+#include "debug/CacheWarmer.hh"
+#include "mem/cache/base.hh"
+#include "mem/cache_warmer.hh"
+#include "mem/physical.hh"
+#include "mem/request.hh"
+#include "sim/system.hh"
+
+using namespace std;
+
+namespace
+{
+
+/**
+ * Write back the dirty blocks of a cache, and optionally empty it.
+ * Caches only expose these through the Drainable interface.
+ */
+void
+flushCache(Drainable *cache, bool invalidate)
+{
+    cache->memWriteback();
+    if (invalidate)
+        cache->memInvalidate();
+}
+
+}
+
+CacheWarmer::CacheWarmer(const Params *p)
+    : SimObject(p), system(p->system),
+      blkSize(p->system->cacheLineSize()),
+      cpus(p->cpus), icaches(p->icaches), dcaches(p->dcaches),
+      sharedCaches(p->shared_caches),
+      trace(p->max_records), traceHead(0), traceWrapped(false),
+      lastBlock(p->cpus.size() * NumAccessTypes, MaxAddr),
+      blkData(blkSize)
+{
+    if (p->max_records == 0)
+        fatal("%s: max_records must be greater than zero\n", name());
+
+    if (cpus.size() >= NoCPU)
+        fatal("%s: too many CPUs\n", name());
+
+    if ((!icaches.empty() && icaches.size() != cpus.size()) ||
+        (!dcaches.empty() && dcaches.size() != cpus.size()))
+        fatal("%s: there must be one instruction and data cache per CPU\n",
+              name());
+
+    cpuCaches.insert(cpuCaches.end(), icaches.begin(), icaches.end());
+    cpuCaches.insert(cpuCaches.end(), dcaches.begin(), dcaches.end());
+
+    for (int i = 0; i < p->targets.size(); ++i) {
+        Target *target = dynamic_cast<Target *>(p->targets[i]);
+        if (!target)
+            fatal("%s: %s can't warm caches\n", name(),
+                  p->targets[i]->name());
+        targets.push_back(target);
+    }
+}
+
+CacheWarmer::~CacheWarmer()
+{
+    for (int i = 0; i < listeners.size(); ++i)
+        delete listeners[i];
+}
+
+void
+CacheWarmer::regProbeListeners()
+{
+    for (int i = 0; i < cpus.size(); ++i) {
+        ProbeManager *pm = cpus[i]->getProbeManager();
+        listeners.push_back(
+            new AccessListener(*this, pm, "InstAccess", i, true));
+        listeners.push_back(
+            new AccessListener(*this, pm, "DataAccess", i, false));
+    }
+}
+
+void
+CacheWarmer::AccessListener::notify(const PacketPtr &pkt)
+{
+    const Request *req = pkt->req;
+    if (req->isUncacheable() || req->isMmappedIpr() ||
+        !warmer.system->isMemAddr(pkt->getAddr()))
+        return;
+
+    AccessType type = inst ? Inst : (pkt->isWrite() ? Write : Read);
+    warmer.record(cpu, type, pkt->getAddr(), pkt->isSecure());
+}
+
+void
+CacheWarmer::startRecording()
+{
+    DPRINTF(CacheWarmer, "Starting a new trace\n");
+
+    for (int i = 0; i < cpuCaches.size(); ++i)
+        flushCache(cpuCaches[i], true);
+    for (int i = 0; i < sharedCaches.size(); ++i)
+        flushCache(sharedCaches[i], true);
+
+    traceHead = 0;
+    traceWrapped = false;
+    fill(lastBlock.begin(), lastBlock.end(), MaxAddr);
+
+    for (int i = 0; i < sources.size(); ++i)
+        sources[i]->clearAccesses();
+}
+
+void
+CacheWarmer::getTrace(vector<Access> &accesses) const
+{
+    accesses.clear();
+    if (traceWrapped) {
+        accesses.reserve(trace.size());
+        accesses.insert(accesses.end(), trace.begin() + traceHead,
+                        trace.end());
+    }
+    accesses.insert(accesses.end(), trace.begin(),
+                    trace.begin() + traceHead);
+}
+
+void
+CacheWarmer::warm()
+{
+    for (int i = 0; i < sources.size(); ++i)
+        sources[i]->recordAccesses(*this);
+
+    vector<Access> accesses;
+    getTrace(accesses);
+
+    DPRINTF(CacheWarmer, "Warming caches with %d accesses\n",
+            accesses.size());
+
+    if (!cpuCaches.empty() || !sharedCaches.empty()) {
+        // Make sure memory holds the latest data, so that the blocks
+        // can be installed with it.
+        for (int i = 0; i < cpuCaches.size(); ++i)
+            flushCache(cpuCaches[i], false);
+        for (int i = 0; i < sharedCaches.size(); ++i)
+            flushCache(sharedCaches[i], false);
+
+        for (int i = 0; i < accesses.size(); ++i)
+            warmAccess(accesses[i]);
+    }
+
+    for (int i = 0; i < targets.size(); ++i)
+        targets[i]->warmCaches(*this, accesses);
+
+    traceHead = 0;
+    traceWrapped = false;
+    fill(lastBlock.begin(), lastBlock.end(), MaxAddr);
+}
+
+void
+CacheWarmer::readBlock(Addr addr, uint8_t *data)
+{
+    Request req(addr & ~Addr(blkSize - 1), blkSize, 0,
+                Request::funcMasterId);
+    Packet pkt(&req, MemCmd::ReadReq);
+    pkt.dataStatic(data);
+    system->getPhysMem().functionalAccess(&pkt);
+}
+
+void
+CacheWarmer::warmAccess(const Access &access)
+{
+    const Addr addr = access.addr;
+    const bool write = access.type == Write;
+    const bool secure = access.secure;
+
+    readBlock(addr, &blkData[0]);
+
+    PacketList writebacks;
+
+    if (access.cpu == NoCPU) {
+        // Written by a CPU whose caches we know nothing about, so the
+        // data can only be placed in the shared levels.
+        for (int i = 0; i < cpuCaches.size(); ++i)
+            cpuCaches[i]->warmSnoop(addr, secure, true);
+        if (!sharedCaches.empty()) {
+            sharedCaches[0]->warmBlock(addr, secure, true, true,
+                                       &blkData[0], writebacks);
+            warmWritebacks(0, writebacks);
+        }
+        return;
+    }
+
+    BaseCache *l1 = NULL;
+    if (access.type == Inst)
+        l1 = icaches.empty() ? NULL : icaches[access.cpu];
+    else
+        l1 = dcaches.empty() ? NULL : dcaches[access.cpu];
+
+    // Keep the other CPUs' caches coherent: a write invalidates their
+    // copies, a read takes away their write permission.
+    bool shared = false;
+    for (int i = 0; i < cpuCaches.size(); ++i) {
+        BaseCache *cache = cpuCaches[i];
+        if (cache == l1)
+            continue;
+        if (cache->inCache(addr, secure)) {
+            cache->warmSnoop(addr, secure, write);
+            shared = true;
+        }
+    }
+
+    if (write) {
+        // The block is owned by the writer's L1, any copies further
+        // down are stale.
+        for (int i = 0; i < sharedCaches.size(); ++i)
+            sharedCaches[i]->warmSnoop(addr, secure, l1 != NULL);
+        shared = false;
+    }
+
+    if (!write || !l1) {
+        // Walk down the shared levels until the block is found, and
+        // fill the levels above it on the way back.
+        int level = 0;
+        while (level < (int)sharedCaches.size() - 1 &&
+               !sharedCaches[level]->inCache(addr, secure))
+            ++level;
+
+        for (int i = level; i >= 0 && !sharedCaches.empty(); --i) {
+            sharedCaches[i]->warmBlock(addr, secure, !shared && !l1,
+                                       write && i == 0, &blkData[0],
+                                       writebacks);
+            warmWritebacks(i, writebacks);
+        }
+    }
+
+    if (l1) {
+        l1->warmBlock(addr, secure, write || (!shared && access.type != Inst),
+                      write, &blkData[0], writebacks);
+        warmWritebacks(-1, writebacks);
+    }
+}
+
+void
+CacheWarmer::warmWritebacks(int level, PacketList &writebacks)
+{
+    while (!writebacks.empty()) {
+        PacketPtr pkt = writebacks.front();
+        writebacks.pop_front();
+
+        // Blocks falling out of the last level are already in memory
+        int next = level + 1;
+        if (next < sharedCaches.size()) {
+            PacketList evicted;
+            sharedCaches[next]->warmBlock(pkt->getAddr(),
+                                          pkt->isSecure(),
+                                          pkt->isSupplyExclusive(), true,
+                                          pkt->getPtr<uint8_t>(), evicted);
+            warmWritebacks(next, evicted);
+        }
+
+        delete pkt->req;
+        delete pkt;
+    }
+}
+
+CacheWarmer *
+CacheWarmerParams::create()
+{
+    return new CacheWarmer(this);
+}
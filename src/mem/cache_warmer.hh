@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Functional cache warming from a trace of memory accesses
+ */
+
+#ifndef __MEM_CACHE_WARMER_HH__
+#define __MEM_CACHE_WARMER_HH__
+
+#include <vector>
+
+#include "base/types.hh"
+#include "mem/packet.hh"
+#include "params/CacheWarmer.hh"
+#include "sim/probe/probe.hh"
+#include "sim/sim_object.hh"
+
+class BaseCache;
+class BaseCPU;
+class System;
+
+/**
+ * Warms caches that were bypassed during fast-forwarding (by the
+ * atomic CPU with fastmem, or by KVM) from a trace of the accesses
+ * made meanwhile. The trace keeps the most recent accesses, one
+ * record per block, which is all that can still be in the caches.
+ * Warming replays the trace through the classic caches directly,
+ * installing and touching blocks and keeping the CPU caches
+ * coherent, without modelling timing, latencies or statistics.
+ * Other memory systems (e.g., Ruby) can be warmed by implementing
+ * Target.
+ *
+ * Accesses are recorded through the InstAccess and DataAccess probe
+ * points of the CPUs, and from Sources for CPUs whose accesses can't
+ * be observed one by one (KVM only reports the pages written by the
+ * guest).
+ */
+class CacheWarmer : public SimObject
+{
+  public:
+    typedef CacheWarmerParams Params;
+
+    enum AccessType {
+        Inst,
+        Read,
+        Write,
+        NumAccessTypes
+    };
+
+    /** A recorded access */
+    struct Access
+    {
+        /** Address of the block */
+        Addr addr;
+        /** Index of the CPU in the cpus parameter, or NoCPU */
+        uint16_t cpu;
+        uint8_t type;
+        /** Security state of the access */
+        bool secure;
+    };
+
+    /** CPU of accesses that can't be attributed to a CPU */
+    static const uint16_t NoCPU = 0xffff;
+
+    /** Provider of accesses that are collected in bulk */
+    class Source
+    {
+      public:
+        virtual ~Source() { }
+
+        /** Forget the accesses made so far. */
+        virtual void clearAccesses() = 0;
+
+        /** Record the accesses made since the last call. */
+        virtual void recordAccesses(CacheWarmer &warmer) = 0;
+    };
+
+    /** Memory system that warms its caches itself */
+    class Target
+    {
+      public:
+        virtual ~Target() { }
+
+        /**
+         * Warm the caches from a trace, oldest access first. This
+         * may run the simulation loop, so it must not be called from
+         * within it.
+         *
+         * @param warmer Warmer the trace comes from, see readBlock().
+         * @param trace Recorded accesses.
+         */
+        virtual void warmCaches(CacheWarmer &warmer,
+                                const std::vector<Access> &trace) = 0;
+    };
+
+    CacheWarmer(const Params *p);
+    ~CacheWarmer();
+
+    void regProbeListeners();
+
+    /** Record an access to the block containing addr. */
+    void
+    record(uint16_t cpu, AccessType type, Addr addr, bool secure = false)
+    {
+        addr &= ~Addr(blkSize - 1);
+
+        // Consecutive accesses to a block only count once. Blocks are
+        // aligned, so the secure bit fits in the offset.
+        if (cpu != NoCPU) {
+            Addr &last = lastBlock[cpu * NumAccessTypes + type];
+            if (last == (addr | secure))
+                return;
+            last = addr | secure;
+        }
+
+        Access &access = trace[traceHead];
+        access.addr = addr;
+        access.cpu = cpu;
+        access.type = type;
+        access.secure = secure;
+
+        if (++traceHead == trace.size()) {
+            traceHead = 0;
+            traceWrapped = true;
+        }
+    }
+
+    /**
+     * Start recording a new trace. The classic caches are written
+     * back and emptied, since the CPUs may bypass them while the
+     * trace is recorded, and will be refilled by warm().
+     */
+    void startRecording();
+
+    /**
+     * Warm the caches from the trace recorded since
+     * startRecording(). Must be called with the system drained.
+     */
+    void warm();
+
+    /** Whether warm() needs to run outside the simulation loop. */
+    bool hasTargets() const { return !targets.empty(); }
+
+    void addSource(Source *source) { sources.push_back(source); }
+
+    /**
+     * Read the current contents of a block from memory, which is up
+     * to date when warming.
+     */
+    void readBlock(Addr addr, uint8_t *data);
+
+    /** Size of the blocks in the trace */
+    unsigned blockSize() const { return blkSize; }
+
+  protected:
+    /** Listener recording the accesses of a CPU's probe point */
+    class AccessListener : public ProbeListenerArgBase<PacketPtr>
+    {
+      private:
+        CacheWarmer &warmer;
+        const uint16_t cpu;
+        const bool inst;
+
+      public:
+        AccessListener(CacheWarmer &w, ProbeManager *pm,
+                       const std::string &name, uint16_t c, bool i)
+            : ProbeListenerArgBase<PacketPtr>(pm, name),
+              warmer(w), cpu(c), inst(i)
+        { }
+
+        void notify(const PacketPtr &pkt);
+    };
+
+    /** Oldest to newest accesses of the trace. */
+    void getTrace(std::vector<Access> &accesses) const;
+
+    /** Warm the classic caches with an access. */
+    void warmAccess(const Access &access);
+
+    /**
+     * Install the blocks evicted dirty from a cache level (-1 for the
+     * CPU caches) in the next shared level, and so on for the blocks
+     * that evicts in turn.
+     */
+    void warmWritebacks(int level, PacketList &writebacks);
+
+    System *system;
+    const unsigned blkSize;
+
+    std::vector<BaseCPU *> cpus;
+    std::vector<BaseCache *> icaches;
+    std::vector<BaseCache *> dcaches;
+    std::vector<BaseCache *> sharedCaches;
+    std::vector<Target *> targets;
+    std::vector<Source *> sources;
+
+    /** Instruction and data caches of all CPUs */
+    std::vector<BaseCache *> cpuCaches;
+
+    /** Ring buffer holding the most recent accesses */
+    std::vector<Access> trace;
+    size_t traceHead;
+    bool traceWrapped;
+
+    /** Last block accessed by every CPU, per access type */
+    std::vector<Addr> lastBlock;
+
+    std::vector<ProbeListener *> listeners;
+
+    /** Contents of the block being installed */
+    std::vector<uint8_t> blkData;
+};
+
+#endif // __MEM_CACHE_WARMER_HH__
@@ -55,7 +55,7 @@
 #include "sim/system.hh"
 
 CoherentBus::CoherentBus(const CoherentBusParams *p)
-    : BaseBus(p), system(p->system)
+    : BaseBus(p), system(p->system), snoopFilter(p->snoop_filter)
 {
     // create the ports based on the size of the master and slave
     // vector ports, and the presence of the default port, the ports
@@ -130,6 +130,9 @@ CoherentBus::init()
 
     if (snoopPorts.empty())
         warn("CoherentBus %s has no snooping ports attached!\n", name());
+
+    if (snoopFilter)
+        snoopFilter->setSlavePorts(snoopPorts, slavePorts.size());
 }
 
 bool
@@ -416,6 +419,19 @@ CoherentBus::recvTimingSnoopResp(PacketPtr pkt, PortID slave_port_id)
 }
 
 
+SnoopFilter::SnoopMask
+CoherentBus::lookupSnoopTargets(PacketPtr pkt, PortID exclude_slave_port_id)
+{
+    if (!snoopFilter)
+        return 0;
+
+    // a request from one of our masters, or a snoop from below
+    if (exclude_slave_port_id != InvalidPortID)
+        return snoopFilter->lookupRequest(pkt, exclude_slave_port_id);
+    else
+        return snoopFilter->lookupSnoop(pkt);
+}
+
 void
 CoherentBus::forwardTiming(PacketPtr pkt, PortID exclude_slave_port_id)
 {
@@ -425,14 +441,18 @@ CoherentBus::forwardTiming(PacketPtr pkt, PortID exclude_slave_port_id)
     // snoops should only happen if the system isn't bypassing caches
     assert(!system->bypassCaches());
 
-    for (SlavePortIter s = snoopPorts.begin(); s != snoopPorts.end(); ++s) {
-        SlavePort *p = *s;
+    SnoopFilter::SnoopMask targets = lookupSnoopTargets(pkt,
+                                                        exclude_slave_port_id);
+
+    for (int i = 0; i < snoopPorts.size(); ++i) {
+        SlavePort *p = snoopPorts[i];
         // we could have gotten this request from a snooping master
         // (corresponding to our own slave port that is also in
         // snoopPorts) and should not send it back to where it came
         // from
-        if (exclude_slave_port_id == InvalidPortID ||
-            p->getId() != exclude_slave_port_id) {
+        if ((exclude_slave_port_id == InvalidPortID ||
+             p->getId() != exclude_slave_port_id) &&
+            isSnoopTarget(targets, i)) {
             // cache is not allowed to refuse snoop
             p->sendTimingSnoopReq(pkt);
         }
@@ -535,14 +555,18 @@ CoherentBus::forwardAtomic(PacketPtr pkt, PortID exclude_slave_port_id)
     // snoops should only happen if the system isn't bypassing caches
     assert(!system->bypassCaches());
 
-    for (SlavePortIter s = snoopPorts.begin(); s != snoopPorts.end(); ++s) {
-        SlavePort *p = *s;
+    SnoopFilter::SnoopMask targets = lookupSnoopTargets(pkt,
+                                                        exclude_slave_port_id);
+
+    for (int i = 0; i < snoopPorts.size(); ++i) {
+        SlavePort *p = snoopPorts[i];
         // we could have gotten this request from a snooping master
         // (corresponding to our own slave port that is also in
         // snoopPorts) and should not send it back to where it came
         // from
-        if (exclude_slave_port_id == InvalidPortID ||
-            p->getId() != exclude_slave_port_id) {
+        if ((exclude_slave_port_id == InvalidPortID ||
+             p->getId() != exclude_slave_port_id) &&
+            isSnoopTarget(targets, i)) {
             Tick latency = p->sendAtomicSnoop(pkt);
             // in contrast to a functional access, we have to keep on
             // going as all snoopers must be updated even if we get a
@@ -614,6 +638,10 @@ CoherentBus::forwardFunctional(PacketPtr pkt, PortID exclude_slave_port_id)
     // snoops should only happen if the system isn't bypassing caches
     assert(!system->bypassCaches());
 
+    // functional snoops are always broadcast and bypass the snoop
+    // filter, as data for the line may still be in flight in a
+    // master that the filter no longer considers a holder
+
     for (SlavePortIter s = snoopPorts.begin(); s != snoopPorts.end(); ++s) {
         SlavePort *p = *s;
         // we could have gotten this request from a snooping master
@@ -53,6 +53,7 @@
 
 #include "base/hashmap.hh"
 #include "mem/bus.hh"
+#include "mem/snoop_filter.hh"
 #include "params/CoherentBus.hh"
 
 /**
@@ -270,6 +271,22 @@ class CoherentBus : public BaseBus
      */
     System *system;
 
+    /** Optional snoop filter, NULL if snoops are broadcast. */
+    SnoopFilter *snoopFilter;
+
+    /**
+     * Determine if the snoop port at the given position in
+     * snoopPorts has to see a snoop.
+     *
+     * @param targets Snoop ports returned by the snoop filter
+     * @param index Position of the port in snoopPorts
+     */
+    bool
+    isSnoopTarget(SnoopFilter::SnoopMask targets, int index) const
+    {
+        return !snoopFilter || (targets >> index) & 1;
+    }
+
     /** Function called by the port when the bus is recieving a Timing
       request packet.*/
     bool recvTimingReq(PacketPtr pkt, PortID slave_port_id);
@@ -290,6 +307,18 @@ class CoherentBus : public BaseBus
      * requests. */
     void recvRetry(PortID master_port_id);
 
+    /**
+     * Ask the snoop filter, if there is one, which of the snoopers
+     * need to see a packet, updating the filter with the packet.
+     *
+     * @param pkt Packet about to be forwarded to the snoopers
+     * @param exclude_slave_port_id Slave port the request came in on,
+     *                              InvalidPortID for a snoop from below
+     * @return The snoop ports to forward to, see isSnoopTarget
+     */
+    SnoopFilter::SnoopMask lookupSnoopTargets(PacketPtr pkt,
+                                              PortID exclude_slave_port_id);
+
     /**
      * Forward a timing packet to our snoopers, potentially excluding
      * one of the connected coherent masters to avoid sending a packet
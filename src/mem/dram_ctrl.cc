@@ -79,6 +79,10 @@ DRAMCtrl::DRAMCtrl(const DRAMCtrlParams* p) :
     memSchedPolicy(p->mem_sched_policy), addrMapping(p->addr_mapping),
     pageMgmt(p->page_policy),
     maxAccessesPerRow(p->max_accesses_per_row),
+    rowHitCap(p->row_hit_cap), blissThreshold(p->bliss_threshold),
+    blissClearingInterval(p->bliss_clearing_interval),
+    lastServedMaster(Request::invldMasterId), lastServedStreak(0),
+    blacklistClearAt(0),
     frontendLatency(p->static_frontend_latency),
     backendLatency(p->static_backend_latency),
     busBusyUntil(0),  prevArrival(0),
@@ -93,6 +97,9 @@ DRAMCtrl::DRAMCtrl(const DRAMCtrlParams* p) :
         actTicks[c].resize(activationLimit, 0);
     }
 
+    readQueue.setBanks(ranksPerChannel * banksPerRank);
+    writeQueue.setBanks(ranksPerChannel * banksPerRank);
+
     // perform a basic check of the write thresholds
     if (p->write_low_thresh_perc >= p->write_high_thresh_perc)
         fatal("Write buffer low threshold %d must be smaller than the "
@@ -598,7 +605,7 @@ DRAMCtrl::printParams() const
             columnsPerRowBuffer, rowsPerBank, banksPerRank, ranksPerChannel,
             rowBufferSize * rowsPerBank * banksPerRank * ranksPerChannel);
 
-    string scheduler =  memSchedPolicy == Enums::fcfs ? "FCFS" : "FR-FCFS";
+    string scheduler = Enums::MemSchedStrings[memSchedPolicy];
     string address_mapping = addrMapping == Enums::RoRaBaChCo ? "RoRaBaChCo" :
         (addrMapping == Enums::RoRaBaCoCh ? "RoRaBaCoCh" : "RoCoRaBaCh");
     string page_policy = pageMgmt == Enums::open ? "OPEN" :
@@ -783,10 +790,9 @@ DRAMCtrl::chooseNextWrite()
 
     if (memSchedPolicy == Enums::fcfs) {
         // Do nothing, since the correct request is already head
-    } else if (memSchedPolicy == Enums::frfcfs) {
+    } else {
         reorderQueue(writeQueue);
-    } else
-        panic("No scheduling policy chosen\n");
+    }
 
     DPRINTF(DRAM, "Selected next write request\n");
 }
@@ -810,53 +816,165 @@ DRAMCtrl::chooseNextRead()
     if (memSchedPolicy == Enums::fcfs) {
         // Do nothing, since the request to serve is already the first
         // one in the read queue
-    } else if (memSchedPolicy == Enums::frfcfs) {
+    } else {
         reorderQueue(readQueue);
-    } else
-        panic("No scheduling policy chosen!\n");
+    }
 
     DPRINTF(DRAM, "Selected next read request\n");
     return true;
 }
 
 void
-DRAMCtrl::reorderQueue(std::deque<DRAMPacket*>& queue)
+DRAMCtrl::RequestQueue::push_back(DRAMPacket* dram_pkt)
 {
-    // Only determine this when needed
-    uint64_t earliest_banks = 0;
-
-    // Search for row hits first, if no row hit is found then schedule the
-    // packet to one of the earliest banks available
-    bool found_earliest_pkt = false;
-    auto selected_pkt_it = queue.begin();
-
-    for (auto i = queue.begin(); i != queue.end() ; ++i) {
-        DRAMPacket* dram_pkt = *i;
-        const Bank& bank = dram_pkt->bankRef;
-        // Check if it is a row hit
-        if (bank.openRow == dram_pkt->row) {
-            DPRINTF(DRAM, "Row buffer hit\n");
-            selected_pkt_it = i;
-            break;
-        } else if (!found_earliest_pkt) {
-            // No row hit, go for first ready
-            if (earliest_banks == 0)
-                earliest_banks = minBankFreeAt(queue);
-
-            // Bank is ready or is the first available bank
-            if (bank.freeAt <= curTick() ||
-                bits(earliest_banks, dram_pkt->bankId, dram_pkt->bankId)) {
-                // Remember the packet to be scheduled to one of the earliest
-                // banks available
-                selected_pkt_it = i;
-                found_earliest_pkt = true;
-            }
+    dram_pkt->seqNum = nextSeqNum++;
+
+    BankQueue& bank_queue = bankQueues[dram_pkt->bankId];
+    dram_pkt->queuePos = pkts.insert(pkts.end(), dram_pkt);
+    dram_pkt->bankPos = bank_queue.pkts.insert(bank_queue.pkts.end(),
+                                               dram_pkt);
+    DRAMPacketList& row_pkts = bank_queue.rows[dram_pkt->row];
+    dram_pkt->rowPos = row_pkts.insert(row_pkts.end(), dram_pkt);
+}
+
+void
+DRAMCtrl::RequestQueue::remove(DRAMPacket* dram_pkt)
+{
+    BankQueue& bank_queue = bankQueues[dram_pkt->bankId];
+    pkts.erase(dram_pkt->queuePos);
+    bank_queue.pkts.erase(dram_pkt->bankPos);
+
+    auto row = bank_queue.rows.find(dram_pkt->row);
+    assert(row != bank_queue.rows.end());
+    row->second.erase(dram_pkt->rowPos);
+    if (row->second.empty())
+        bank_queue.rows.erase(row);
+}
+
+void
+DRAMCtrl::RequestQueue::moveToFront(DRAMPacket* dram_pkt)
+{
+    pkts.erase(dram_pkt->queuePos);
+    dram_pkt->queuePos = pkts.insert(pkts.begin(), dram_pkt);
+}
+
+const DRAMCtrl::DRAMPacketList*
+DRAMCtrl::RequestQueue::row(uint16_t bank_id, uint32_t row) const
+{
+    const BankQueue& bank_queue = bankQueues[bank_id];
+    auto row_pkts = bank_queue.rows.find(row);
+    return row_pkts == bank_queue.rows.end() ? NULL : &row_pkts->second;
+}
+
+void
+DRAMCtrl::reorderQueue(RequestQueue& queue)
+{
+    DRAMPacket* selected_pkt = NULL;
+
+    if (memSchedPolicy == Enums::batch) {
+        // Once all packets of the current batch are served, the
+        // packets waiting form the next batch. The batch cannot be
+        // overtaken by younger row hits, which bounds the time any
+        // packet waits.
+        if (queue.front()->seqNum >= queue.batchEnd) {
+            queue.batchEnd = queue.nextSeq();
+            DPRINTF(DRAM, "New batch of %d packets\n", queue.size());
         }
+        selected_pkt = selectPacket(queue, true);
+    } else if (memSchedPolicy == Enums::bliss) {
+        if (curTick() >= blacklistClearAt) {
+            blacklist.assign(blacklist.size(), false);
+            blacklistClearAt = curTick() + blissClearingInterval;
+        }
+
+        // Packets from masters that are not blacklisted go first,
+        // and within each group it is FR-FCFS
+        selected_pkt = selectPacket(queue, true);
+        if (selected_pkt == NULL)
+            selected_pkt = selectPacket(queue, false);
+    } else {
+        selected_pkt = selectPacket(queue, false);
     }
 
-    DRAMPacket* selected_pkt = *selected_pkt_it;
-    queue.erase(selected_pkt_it);
-    queue.push_front(selected_pkt);
+    assert(selected_pkt != NULL);
+    queue.moveToFront(selected_pkt);
+}
+
+DRAMCtrl::DRAMPacket*
+DRAMCtrl::firstPacket(const RequestQueue& queue, const DRAMPacketList& list,
+                      bool preferred_only) const
+{
+    if (!preferred_only)
+        return list.empty() ? NULL : list.front();
+
+    for (auto p = list.begin(); p != list.end(); ++p) {
+        if (memSchedPolicy == Enums::batch) {
+            // Batches are formed in order of arrival, so if the
+            // oldest packet is not in the batch no other one is
+            return (*p)->seqNum < queue.batchEnd ? *p : NULL;
+        }
+
+        if ((*p)->masterId >= blacklist.size() ||
+            !blacklist[(*p)->masterId])
+            return *p;
+    }
+
+    return NULL;
+}
+
+DRAMCtrl::DRAMPacket*
+DRAMCtrl::selectPacket(const RequestQueue& queue, bool preferred_only)
+{
+    const uint16_t num_banks = ranksPerChannel * banksPerRank;
+
+    // Search for row hits first, looking only at the row that is open
+    // in each bank, and find out when the first bank is available
+    DRAMPacket* row_hit = NULL;
+    Tick min_free_at = MaxTick;
+    for (uint16_t b = 0; b < num_banks; ++b) {
+        const DRAMPacketList& bank_pkts = queue.bank(b);
+        if (bank_pkts.empty())
+            continue;
+
+        const Bank& bank = banks[b / banksPerRank][b % banksPerRank];
+        const DRAMPacketList* row_pkts = queue.row(b, bank.openRow);
+        if (row_pkts) {
+            DRAMPacket* hit = firstPacket(queue, *row_pkts, preferred_only);
+
+            // With FR-FCFS-Cap, do not let row hits overtake the
+            // older packets to the bank indefinitely
+            if (hit && memSchedPolicy == Enums::frfcfs_cap &&
+                hit != bank_pkts.front() && queue.bypasses(b) >= rowHitCap)
+                hit = NULL;
+
+            if (hit && (!row_hit || hit->seqNum < row_hit->seqNum))
+                row_hit = hit;
+        }
+
+        if (firstPacket(queue, bank_pkts, preferred_only))
+            min_free_at = std::min(min_free_at, bank.freeAt);
+    }
+
+    if (row_hit) {
+        DPRINTF(DRAM, "Row buffer hit\n");
+        return row_hit;
+    }
+
+    // No row hit, so go for the oldest packet to a bank that is ready
+    // or is one of the first to become available
+    DRAMPacket* selected_pkt = NULL;
+    for (uint16_t b = 0; b < num_banks; ++b) {
+        const Bank& bank = banks[b / banksPerRank][b % banksPerRank];
+        if (bank.freeAt > curTick() && bank.freeAt != min_free_at)
+            continue;
+
+        DRAMPacket* oldest = firstPacket(queue, queue.bank(b),
+                                         preferred_only);
+        if (oldest && (!selected_pkt || oldest->seqNum < selected_pkt->seqNum))
+            selected_pkt = oldest;
+    }
+
+    return selected_pkt;
 }
 
 void
@@ -1070,6 +1188,31 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
 
     Bank& bank = dram_pkt->bankRef;
 
+    // Keep track of how many row hits overtook older packets to this
+    // bank, for FR-FCFS-Cap
+    RequestQueue& queue = dram_pkt->isRead ? readQueue : writeQueue;
+    if (rowHitFlag && queue.bank(dram_pkt->bankId).front() != dram_pkt)
+        ++queue.bypasses(dram_pkt->bankId);
+    else
+        queue.bypasses(dram_pkt->bankId) = 0;
+
+    // Keep track of how many requests in a row were served for the
+    // same master, and blacklist masters that hog the memory, for
+    // BLISS
+    if (dram_pkt->masterId == lastServedMaster) {
+        if (++lastServedStreak > blissThreshold &&
+            memSchedPolicy == Enums::bliss) {
+            if (dram_pkt->masterId >= blacklist.size())
+                blacklist.resize(dram_pkt->masterId + 1, false);
+            if (!blacklist[dram_pkt->masterId])
+                DPRINTF(DRAM, "Blacklisting master %d\n", dram_pkt->masterId);
+            blacklist[dram_pkt->masterId] = true;
+        }
+    } else {
+        lastServedMaster = dram_pkt->masterId;
+        lastServedStreak = 1;
+    }
+
     // Update bank state
     if (pageMgmt == Enums::open || pageMgmt == Enums::open_adaptive ||
         pageMgmt == Enums::close_adaptive) {
@@ -1122,26 +1265,16 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
             bool got_more_hits = false;
             bool got_bank_conflict = false;
 
-            // either look at the read queue or write queue
-            const deque<DRAMPacket*>& queue = dram_pkt->isRead ? readQueue :
+            // either look at the read queue or write queue, where the
+            // packet we are currently dealing with is still queued
+            const RequestQueue& queue = dram_pkt->isRead ? readQueue :
                 writeQueue;
-            auto p = queue.begin();
-            // make sure we are not considering the packet that we are
-            // currently dealing with (which is the head of the queue)
-            ++p;
-
-            // keep on looking until we have found required condition or
-            // reached the end
-            while (!(got_more_hits &&
-                    (got_bank_conflict || pageMgmt == Enums::close_adaptive)) &&
-                   p != queue.end()) {
-                bool same_rank_bank = (dram_pkt->rank == (*p)->rank) &&
-                    (dram_pkt->bank == (*p)->bank);
-                bool same_row = dram_pkt->row == (*p)->row;
-                got_more_hits |= same_rank_bank && same_row;
-                got_bank_conflict |= same_rank_bank && !same_row;
-                ++p;
-            }
+            const DRAMPacketList* same_row =
+                queue.row(dram_pkt->bankId, dram_pkt->row);
+            assert(same_row);
+            got_more_hits = same_row->size() > 1;
+            got_bank_conflict =
+                queue.bank(dram_pkt->bankId).size() > same_row->size();
 
             // auto pre-charge when either
             // 1) open_adaptive policy, we have not got any more hits, and
@@ -1323,38 +1456,6 @@ DRAMCtrl::maxBankFreeAt() const
     return banksFree;
 }
 
-uint64_t
-DRAMCtrl::minBankFreeAt(const deque<DRAMPacket*>& queue) const
-{
-    uint64_t bank_mask = 0;
-    Tick freeAt = MaxTick;
-
-    // detemrine if we have queued transactions targetting the
-    // bank in question
-    vector<bool> got_waiting(ranksPerChannel * banksPerRank, false);
-    for (auto p = queue.begin(); p != queue.end(); ++p) {
-        got_waiting[(*p)->bankId] = true;
-    }
-
-    for (int i = 0; i < ranksPerChannel; i++) {
-        for (int j = 0; j < banksPerRank; j++) {
-            // if we have waiting requests for the bank, and it is
-            // amongst the first available, update the mask
-            if (got_waiting[i * banksPerRank + j] &&
-                banks[i][j].freeAt <= freeAt) {
-                // reset bank mask if new minimum is found
-                if (banks[i][j].freeAt < freeAt)
-                    bank_mask = 0;
-                // set the bit corresponding to the available bank
-                uint8_t bit_index = i * ranksPerChannel + j;
-                replaceBits(bank_mask, bit_index, bit_index, 1);
-                freeAt = banks[i][j].freeAt;
-            }
-        }
-    }
-    return bank_mask;
-}
-
 void
 DRAMCtrl::processRefreshEvent()
 {
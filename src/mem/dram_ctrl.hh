@@ -51,7 +51,10 @@
 #define __MEM_DRAM_CTRL_HH__
 
 #include <deque>
+#include <vector>
 
+#include "base/hashmap.hh"
+#include "base/pooled_list.hh"
 #include "base/statistics.hh"
 #include "enums/AddrMap.hh"
 #include "enums/MemSched.hh"
@@ -185,6 +188,11 @@ class DRAMCtrl : public AbstractMemory
             { }
     };
 
+    class DRAMPacket;
+
+    /** A list of DRAM packets, as used by the request queues. */
+    typedef PooledList<DRAMPacket*> DRAMPacketList;
+
     /**
      * A DRAM packet stores packets along with the timestamp of when
      * the packet entered the queue, and also the decoded address.
@@ -237,17 +245,132 @@ class DRAMCtrl : public AbstractMemory
         BurstHelper* burstHelper;
         Bank& bankRef;
 
+        /**
+         * The master that issued the request, kept here as the
+         * packet of a write is handed back before the write is done
+         */
+        const MasterID masterId;
+
+        /** Order of arrival in the request queue, set when queued */
+        uint64_t seqNum;
+
+        /** Position in the request queue and in its bank and row lists */
+        DRAMPacketList::iterator queuePos;
+        DRAMPacketList::iterator bankPos;
+        DRAMPacketList::iterator rowPos;
+
         DRAMPacket(PacketPtr _pkt, bool is_read, uint8_t _rank, uint8_t _bank,
                    uint16_t _row, uint16_t bank_id, Addr _addr,
                    unsigned int _size, Bank& bank_ref)
             : entryTime(curTick()), readyTime(curTick()),
               pkt(_pkt), isRead(is_read), rank(_rank), bank(_bank), row(_row),
               bankId(bank_id), addr(_addr), size(_size), burstHelper(NULL),
-              bankRef(bank_ref)
+              bankRef(bank_ref), masterId(_pkt->req->masterId()), seqNum(0)
         { }
 
     };
 
+    /**
+     * A read or write queue of the controller. Besides keeping all
+     * packets in the order the scheduler looks at them, the queue
+     * keeps the packets of every bank, and of every row within a
+     * bank, in order of arrival. This lets the scheduler find the
+     * oldest row hit, or the oldest packet for a bank, in time
+     * proportional to the number of banks rather than the depth of
+     * the queue.
+     */
+    class RequestQueue
+    {
+      private:
+
+        struct BankQueue
+        {
+            /** Packets to the bank in order of arrival */
+            DRAMPacketList pkts;
+
+            /** Packets to the bank in order of arrival, per row */
+            m5::hash_map<uint32_t, DRAMPacketList> rows;
+
+            /**
+             * Row hits in a row that were scheduled ahead of older
+             * packets to the same bank
+             */
+            uint32_t bypasses;
+
+            BankQueue() : bypasses(0) { }
+        };
+
+        /** All packets, in order of arrival unless reordered */
+        DRAMPacketList pkts;
+
+        std::vector<BankQueue> bankQueues;
+
+        /** Sequence number given to the next packet to arrive */
+        uint64_t nextSeqNum;
+
+      public:
+
+        /**
+         * Packets with a sequence number lower than this belong to
+         * the current batch of the batch scheduler
+         */
+        uint64_t batchEnd;
+
+        RequestQueue() : nextSeqNum(0), batchEnd(0) { }
+
+        /** Set the total number of banks, over all ranks */
+        void setBanks(unsigned num_banks) { bankQueues.resize(num_banks); }
+
+        bool empty() const { return pkts.empty(); }
+        size_t size() const { return pkts.size(); }
+
+        DRAMPacketList::const_iterator begin() const { return pkts.begin(); }
+        DRAMPacketList::const_iterator end() const { return pkts.end(); }
+        DRAMPacket* front() const { return pkts.front(); }
+
+        /** Sequence number the next packet will get */
+        uint64_t nextSeq() const { return nextSeqNum; }
+
+        /** Add a packet at the back of the queue */
+        void push_back(DRAMPacket* dram_pkt);
+
+        /** Remove a packet from anywhere in the queue */
+        void remove(DRAMPacket* dram_pkt);
+
+        void pop_front() { remove(front()); }
+
+        /**
+         * Move a packet to the front of the queue, leaving the bank
+         * and row lists untouched
+         */
+        void moveToFront(DRAMPacket* dram_pkt);
+
+        /** Packets to a bank, in order of arrival */
+        const DRAMPacketList&
+        bank(uint16_t bank_id) const
+        {
+            return bankQueues[bank_id].pkts;
+        }
+
+        /**
+         * Packets to a row of a bank, in order of arrival
+         *
+         * @return The list of packets, or NULL if there are none
+         */
+        const DRAMPacketList* row(uint16_t bank_id, uint32_t row) const;
+
+        /** Row hits that bypassed older packets to a bank */
+        uint32_t& bypasses(uint16_t bank_id)
+        {
+            return bankQueues[bank_id].bypasses;
+        }
+
+        uint32_t bypasses(uint16_t bank_id) const
+        {
+            return bankQueues[bank_id].bypasses;
+        }
+    };
+
     /**
      * Bunch of things requires to setup "events" in gem5
      * When event "writeEvent" occurs for example, the method
@@ -400,27 +523,44 @@ class DRAMCtrl : public AbstractMemory
     void chooseNextWrite();
 
     /**
-     * For FR-FCFS policy reorder the read/write queue depending on row buffer
-     * hits and earliest banks available in DRAM
+     * For all policies but FCFS, pick the packet to serve next from
+     * the read/write queue and move it to the head of the queue
      */
-    void reorderQueue(std::deque<DRAMPacket*>& queue);
+    void reorderQueue(RequestQueue& queue);
 
     /**
-     * Looking at all banks, determine the moment in time when they
-     * are all free.
+     * Find the packet FR-FCFS would pick: the oldest row hit, if
+     * any, else the oldest packet to one of the banks that are free
+     * or the first to become free. With FR-FCFS-Cap, row hits that
+     * already bypassed too many older packets to their bank are not
+     * considered.
      *
-     * @return The tick when all banks are free
+     * @param queue The queue to pick from
+     * @param preferred_only Only consider packets that are in the
+     *        current batch, or from masters that are not blacklisted
+     * @return The selected packet, NULL if there is none to consider
      */
-    Tick maxBankFreeAt() const;
+    DRAMPacket* selectPacket(const RequestQueue& queue, bool preferred_only);
 
     /**
-     * Find which are the earliest available banks for the enqueued
-     * requests. Assumes maximum of 64 banks per DIMM
+     * Find the oldest packet in a list of packets to consider
      *
-     * @param Queued requests to consider
-     * @return One-hot encoded mask of bank indices
+     * @param queue The queue the list belongs to
+     * @param list A bank or row list of the queue
+     * @param preferred_only See selectPacket
+     * @return The packet, NULL if there is none
      */
-    uint64_t minBankFreeAt(const std::deque<DRAMPacket*>& queue) const;
+    DRAMPacket* firstPacket(const RequestQueue& queue,
+                            const DRAMPacketList& list,
+                            bool preferred_only) const;
+
+    /**
+     * Looking at all banks, determine the moment in time when they
+     * are all free.
+     *
+     * @return The tick when all banks are free
+     */
+    Tick maxBankFreeAt() const;
 
     /**
      * Keep track of when row activations happen, in order to enforce
@@ -440,8 +580,8 @@ class DRAMCtrl : public AbstractMemory
     /**
      * The controller's main read and write queues
      */
-    std::deque<DRAMPacket*> readQueue;
-    std::deque<DRAMPacket*> writeQueue;
+    RequestQueue readQueue;
+    RequestQueue writeQueue;
 
     /**
      * Response queue where read packets wait after we're done working
@@ -520,6 +660,25 @@ class DRAMCtrl : public AbstractMemory
      */
     const uint32_t maxAccessesPerRow;
 
+    /**
+     * With FR-FCFS-Cap, the number of row hits that may be scheduled
+     * ahead of an older packet to the same bank
+     */
+    const uint32_t rowHitCap;
+
+    /**
+     * BLISS blacklists a master once this many of its requests in a
+     * row were served, and clears the blacklist at the given interval
+     */
+    const uint32_t blissThreshold;
+    const Tick blissClearingInterval;
+
+    /** BLISS state: the blacklist, indexed by master */
+    std::vector<bool> blacklist;
+    MasterID lastServedMaster;
+    uint32_t lastServedStreak;
+    Tick blacklistClearAt;
+
     /**
      * Pipeline latency of the controller frontend. The frontend
      * contribution is added to writes (that complete when they are in
@@ -60,6 +60,8 @@
 #include "base/compiler.hh"
 #include "base/flags.hh"
 #include "base/misc.hh"
+#include "base/pool_alloc.hh"
+#include "base/pooled_list.hh"
 #include "base/printable.hh"
 #include "base/types.hh"
 #include "mem/request.hh"
@@ -68,7 +70,7 @@
 class Packet;
 typedef Packet *PacketPtr;
 typedef uint8_t* PacketDataPtr;
-typedef std::list<PacketPtr> PacketList;
+typedef PooledList<PacketPtr> PacketList;
 
 class MemCmd
 {
@@ -225,7 +227,7 @@ class MemCmd
  * ultimate destination and back, possibly being conveyed by several
  * different Packets along the way.)
  */
-class Packet : public Printable
+class Packet : public Printable, public PoolAllocated
 {
   public:
     typedef uint32_t FlagsType;
@@ -233,7 +235,7 @@ class Packet : public Printable
 
   private:
     static const FlagsType PUBLIC_FLAGS           = 0x00000000;
-    static const FlagsType PRIVATE_FLAGS          = 0x00007F0F;
+    static const FlagsType PRIVATE_FLAGS          = 0x00017F0F;
     static const FlagsType COPY_FLAGS             = 0x0000000F;
 
     static const FlagsType SHARED                 = 0x00000001;
@@ -260,6 +262,8 @@ class Packet : public Printable
     /// suppress the error if this packet encounters a functional
     /// access failure.
     static const FlagsType SUPPRESS_FUNC_ERROR    = 0x00008000;
+    /// The data pointer points to a buffer obtained from PoolAlloc.
+    static const FlagsType POOLED_DATA            = 0x00010000;
 
     Flags flags;
 
@@ -689,6 +693,8 @@ class Packet : public Printable
     reinitFromRequest()
     {
         assert(req->hasPaddr());
+        // Free the data while its size is still known
+        deleteData();
         flags = 0;
         addr = req->getPaddr();
         _isSecure = req->isSecure();
@@ -702,7 +708,6 @@ class Packet : public Printable
         busLastWordDelay = 0;
 
         flags.set(VALID_ADDR|VALID_SIZE);
-        deleteData();
     }
 
     /**
@@ -870,12 +875,14 @@ class Packet : public Printable
     void
     deleteData()
     {
-        if (flags.isSet(ARRAY_DATA))
+        if (flags.isSet(POOLED_DATA))
+            PoolAlloc::release(data, getSize());
+        else if (flags.isSet(ARRAY_DATA))
             delete [] data;
         else if (flags.isSet(DYNAMIC_DATA))
             delete data;
 
-        flags.clear(STATIC_DATA|DYNAMIC_DATA|ARRAY_DATA);
+        flags.clear(STATIC_DATA|DYNAMIC_DATA|ARRAY_DATA|POOLED_DATA);
         data = NULL;
     }
 
@@ -889,8 +896,14 @@ class Packet : public Printable
         }
 
         assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
-        flags.set(DYNAMIC_DATA|ARRAY_DATA);
-        data = new uint8_t[getSize()];
+        if (getSize() <= PoolAlloc::maxSize) {
+            // Cache lines and smaller accesses are recycled
+            flags.set(DYNAMIC_DATA|POOLED_DATA);
+            data = (PacketDataPtr)PoolAlloc::allocate(getSize());
+        } else {
+            flags.set(DYNAMIC_DATA|ARRAY_DATA);
+            data = new uint8_t[getSize()];
+        }
     }
 
     /**
@@ -53,8 +53,7 @@
  * notifying the queue when a transfer ends.
  */
 
-#include <list>
-
+#include "base/pooled_list.hh"
 #include "mem/port.hh"
 #include "sim/drain.hh"
 #include "sim/eventq_impl.hh"
@@ -77,8 +76,8 @@ class PacketQueue : public Drainable
         {}
     };
 
-    typedef std::list<DeferredPacket> DeferredPacketList;
-    typedef std::list<DeferredPacket>::iterator DeferredPacketIterator;
+    typedef PooledList<DeferredPacket> DeferredPacketList;
+    typedef DeferredPacketList::iterator DeferredPacketIterator;
 
     /** A list of outgoing timing response packets that haven't been
      * serviced yet. */
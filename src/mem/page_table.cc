@@ -203,7 +203,7 @@ PageTable::serialize(std::ostream &os)
     PTableItr iter = pTable.begin();
     PTableItr end = pTable.end();
     while (iter != end) {
-        os << "\n[" << csprintf("%s.Entry%d", name(), count) << "]\n";
+        Serializable::nameOut(os, csprintf("%s.Entry%d", name(), count));
 
         paramOut(os, "vaddr", iter->first);
         iter->second.serialize(os);
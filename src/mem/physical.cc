@@ -47,9 +47,12 @@
 #include <cerrno>
 #include <climits>
 #include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <string>
 
+#include "base/chunked_image.hh"
+#include "base/intmath.hh"
 #include "base/trace.hh"
 #include "debug/BusAddrRanges.hh"
 #include "debug/Checkpoint.hh"
@@ -58,9 +61,85 @@
 
 using namespace std;
 
+namespace
+{
+
+const char sparseImageMagic[8] = { 'g', 'e', 'm', '5', 'p', 'm', 'e', 'm' };
+const uint32_t sparseImageVersion = 1;
+
+/** Header of a sparse memory image, see unserializeStore(). */
+struct SparseImageHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t pageSize;
+    uint64_t rangeSize;
+    uint64_t numPages;
+};
+
+/**
+ * Above this many runs of pages a sparse image is read rather than
+ * mapped, to stay well within the limit on the number of mappings
+ * of a process.
+ */
+const size_t maxMappedRuns = 16384;
+
+bool
+isZero(const uint8_t* p, size_t len)
+{
+    const uint64_t* words = (const uint64_t*)p;
+    size_t num_words = len / sizeof(uint64_t);
+    for (size_t i = 0; i < num_words; ++i)
+        if (words[i])
+            return false;
+    for (size_t i = num_words * sizeof(uint64_t); i < len; ++i)
+        if (p[i])
+            return false;
+    return true;
+}
+
+void
+writeAll(int fd, const void* buf, size_t len, const string& filename)
+{
+    const uint8_t* p = (const uint8_t*)buf;
+    while (len) {
+        ssize_t ret = write(fd, p, len);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            fatal("Write failed on physical memory checkpoint file '%s': "
+                  "%s\n", filename, strerror(errno));
+        }
+        p += ret;
+        len -= ret;
+    }
+}
+
+void
+readAll(int fd, void* buf, size_t len, off_t offset, const string& filename)
+{
+    uint8_t* p = (uint8_t*)buf;
+    while (len) {
+        ssize_t ret = pread(fd, p, len, offset);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0)
+            fatal("Read failed on physical memory checkpoint file '%s'\n",
+                  filename);
+        p += ret;
+        len -= ret;
+        offset += ret;
+    }
+}
+
+}
+
 PhysicalMemory::PhysicalMemory(const string& _name,
-                               const vector<AbstractMemory*>& _memories) :
-    _name(_name), size(0)
+                               const vector<AbstractMemory*>& _memories,
+                               Enums::MemoryImageFormat image_format,
+                               unsigned checkpoint_threads) :
+    _name(_name), size(0), imageFormat(image_format),
+    checkpointThreads(checkpoint_threads)
 {
     // add the memories from the system to the address map as
     // appropriate
@@ -301,23 +380,45 @@ PhysicalMemory::serializeStore(ostream& os, unsigned int store_id,
     DPRINTF(Checkpoint, "Serializing physical memory %s with size %d\n",
             filename, range_size);
 
+    string format = Enums::MemoryImageFormatStrings[imageFormat];
+
     SERIALIZE_SCALAR(store_id);
     SERIALIZE_SCALAR(filename);
     SERIALIZE_SCALAR(range_size);
+    SERIALIZE_SCALAR(format);
 
     // write memory file
     string filepath = Checkpoint::dir() + "/" + filename.c_str();
+    switch (imageFormat) {
+      case Enums::gzip:
+        writeGzipImage(filepath, range, pmem);
+        break;
+      case Enums::sparse:
+        writeSparseImage(filepath, range, pmem);
+        break;
+      case Enums::chunked:
+        writeChunkedImage(filepath, range, pmem);
+        break;
+      default:
+        panic("Unknown memory image format %d\n", imageFormat);
+    }
+}
+
+void
+PhysicalMemory::writeGzipImage(const string& filepath, AddrRange range,
+                               uint8_t* pmem)
+{
     int fd = creat(filepath.c_str(), 0664);
     if (fd < 0) {
         perror("creat");
         fatal("Can't open physical memory checkpoint file '%s'\n",
-              filename);
+              filepath);
     }
 
     gzFile compressed_mem = gzdopen(fd, "wb");
     if (compressed_mem == NULL)
         fatal("Insufficient memory to allocate compression state for %s\n",
-              filename);
+              filepath);
 
     uint64_t pass_size = 0;
 
@@ -330,7 +431,7 @@ PhysicalMemory::serializeStore(ostream& os, unsigned int store_id,
         if (gzwrite(compressed_mem, pmem + written,
                     (unsigned int) pass_size) != (int) pass_size) {
             fatal("Write failed on physical memory checkpoint file '%s'\n",
-                  filename);
+                  filepath);
         }
     }
 
@@ -338,8 +439,102 @@ PhysicalMemory::serializeStore(ostream& os, unsigned int store_id,
     // is zero
     if (gzclose(compressed_mem))
         fatal("Close failed on physical memory checkpoint file '%s'\n",
-              filename);
+              filepath);
+
+}
+
+void
+PhysicalMemory::writeSparseImage(const string& filepath, AddrRange range,
+                                 uint8_t* pmem)
+{
+    const uint64_t page_size = sysconf(_SC_PAGESIZE);
+    const uint64_t num_pages = divCeil(range.size(), page_size);
+
+    // the last page of the range may be partial
+    vector<uint64_t> pages;
+    for (uint64_t p = 0; p < num_pages; ++p) {
+        uint64_t len = min(page_size, range.size() - p * page_size);
+        if (!isZero(pmem + p * page_size, len))
+            pages.push_back(p);
+    }
+
+    DPRINTF(Checkpoint, "Writing %d of %d pages to %s\n", pages.size(),
+            num_pages, filepath);
+
+    // The pages are written to a new file that then replaces the old
+    // one, as the backing store may be mapped from the old one if we
+    // were restored from a checkpoint in the same place
+    string tmp_path = filepath + ".tmp";
+    int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0664);
+    if (fd < 0) {
+        perror("open");
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              tmp_path);
+    }
+
+    SparseImageHeader header;
+    memcpy(header.magic, sparseImageMagic, sizeof(header.magic));
+    header.version = sparseImageVersion;
+    header.pageSize = page_size;
+    header.rangeSize = range.size();
+    header.numPages = pages.size();
+    writeAll(fd, &header, sizeof(header), tmp_path);
+    if (!pages.empty())
+        writeAll(fd, &pages[0], pages.size() * sizeof(uint64_t), tmp_path);
+
+    uint64_t index_end = sizeof(header) + pages.size() * sizeof(uint64_t);
+    vector<uint8_t> padding(roundUp(index_end, page_size) - index_end, 0);
+    if (!padding.empty())
+        writeAll(fd, &padding[0], padding.size(), tmp_path);
+
+    // write runs of consecutive pages at once
+    size_t first = 0;
+    while (first < pages.size()) {
+        size_t last = first;
+        while (last + 1 < pages.size() && pages[last + 1] == pages[last] + 1)
+            ++last;
+
+        uint64_t offset = pages[first] * page_size;
+        uint64_t len = min((pages[last] + 1) * page_size, range.size()) -
+            offset;
+        writeAll(fd, pmem + offset, len, tmp_path);
+        first = last + 1;
+    }
+
+    // pad a partial last page, so that all pages can be mapped
+    if (!pages.empty() && (pages.back() + 1) * page_size > range.size()) {
+        padding.assign((pages.back() + 1) * page_size - range.size(), 0);
+        writeAll(fd, &padding[0], padding.size(), tmp_path);
+    }
+
+    if (close(fd) != 0)
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              tmp_path);
 
+    if (rename(tmp_path.c_str(), filepath.c_str()) != 0) {
+        perror("rename");
+        fatal("Can't rename physical memory checkpoint file '%s'\n",
+              tmp_path);
+    }
+}
+
+void
+PhysicalMemory::writeChunkedImage(const string& filepath, AddrRange range,
+                                  uint8_t* pmem)
+{
+    DPRINTF(Checkpoint, "Writing %s in chunks of %d bytes\n", filepath,
+            ChunkedImage::defaultChunkSize);
+
+    // as for sparse images, the backing store may be mapped from the
+    // file being replaced
+    string tmp_path = filepath + ".tmp";
+    ChunkedImage::write(tmp_path, pmem, range.size(), checkpointThreads);
+
+    if (rename(tmp_path.c_str(), filepath.c_str()) != 0) {
+        perror("rename");
+        fatal("Can't rename physical memory checkpoint file '%s'\n",
+              tmp_path);
+    }
 }
 
 void
@@ -370,8 +565,6 @@ PhysicalMemory::unserialize(Checkpoint* cp, const string& section)
 void
 PhysicalMemory::unserializeStore(Checkpoint* cp, const string& section)
 {
-    const uint32_t chunk_size = 16384;
-
     unsigned int store_id;
     UNSERIALIZE_SCALAR(store_id);
 
@@ -379,17 +572,9 @@ PhysicalMemory::unserializeStore(Checkpoint* cp, const string& section)
     UNSERIALIZE_SCALAR(filename);
     string filepath = cp->cptDir + "/" + filename;
 
-    // mmap memoryfile
-    int fd = open(filepath.c_str(), O_RDONLY);
-    if (fd < 0) {
-        perror("open");
-        fatal("Can't open physical memory checkpoint file '%s'", filename);
-    }
-
-    gzFile compressed_mem = gzdopen(fd, "rb");
-    if (compressed_mem == NULL)
-        fatal("Insufficient memory to allocate compression state for %s\n",
-              filename);
+    // checkpoints without a format predate the sparse images
+    string format = "gzip";
+    UNSERIALIZE_OPT_SCALAR(format);
 
     // we've already got the actual backing store mapped
     uint8_t* pmem = backingStore[store_id].second;
@@ -405,6 +590,35 @@ PhysicalMemory::unserializeStore(Checkpoint* cp, const string& section)
         fatal("Memory range size has changed! Saw %lld, expected %lld\n",
               range_size, range.size());
 
+    if (format == "gzip")
+        readGzipImage(filepath, range, pmem);
+    else if (format == "sparse")
+        readSparseImage(filepath, range, pmem);
+    else if (format == "chunked")
+        readChunkedImage(filepath, range, pmem);
+    else
+        fatal("Unknown format '%s' of physical memory checkpoint file "
+              "'%s'\n", format, filename);
+}
+
+void
+PhysicalMemory::readGzipImage(const string& filepath, AddrRange range,
+                              uint8_t* pmem)
+{
+    const uint32_t chunk_size = 16384;
+
+    // mmap memoryfile
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        perror("open");
+        fatal("Can't open physical memory checkpoint file '%s'", filepath);
+    }
+
+    gzFile compressed_mem = gzdopen(fd, "rb");
+    if (compressed_mem == NULL)
+        fatal("Insufficient memory to allocate compression state for %s\n",
+              filepath);
+
     uint64_t curr_size = 0;
     long* temp_page = new long[chunk_size];
     long* pmem_current;
@@ -431,5 +645,119 @@ PhysicalMemory::unserializeStore(Checkpoint* cp, const string& section)
 
     if (gzclose(compressed_mem))
         fatal("Close failed on physical memory checkpoint file '%s'\n",
-              filename);
+              filepath);
+}
+
+void
+PhysicalMemory::readSparseImage(const string& filepath, AddrRange range,
+                                uint8_t* pmem)
+{
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        perror("open");
+        fatal("Can't open physical memory checkpoint file '%s'", filepath);
+    }
+
+    SparseImageHeader header;
+    readAll(fd, &header, sizeof(header), 0, filepath);
+    if (memcmp(header.magic, sparseImageMagic, sizeof(header.magic)) != 0)
+        fatal("'%s' is not a sparse memory image\n", filepath);
+    if (header.version != sparseImageVersion)
+        fatal("Sparse memory image '%s' has version %d, expected %d\n",
+              filepath, header.version, sparseImageVersion);
+    if (header.rangeSize != range.size())
+        fatal("Sparse memory image '%s' has size %lld, expected %lld\n",
+              filepath, header.rangeSize, range.size());
+
+    const uint64_t page_size = header.pageSize;
+    if (page_size == 0 || (page_size & (page_size - 1)) != 0)
+        fatal("Sparse memory image '%s' has a bad page size %d\n",
+              filepath, page_size);
+
+    vector<uint64_t> pages(header.numPages);
+    if (!pages.empty())
+        readAll(fd, &pages[0], pages.size() * sizeof(uint64_t),
+                sizeof(header), filepath);
+
+    const off_t data_offset =
+        roundUp(sizeof(header) + pages.size() * sizeof(uint64_t), page_size);
+
+    // find the runs of consecutive pages, which are also consecutive
+    // in the file
+    vector<pair<size_t, size_t> > runs;
+    for (size_t i = 0; i < pages.size(); ++i) {
+        if (i > 0 && pages[i] <= pages[i - 1])
+            fatal("Sparse memory image '%s' has a corrupt index\n",
+                  filepath);
+        if ((pages[i] + 1) * page_size > roundUp(range.size(), page_size))
+            fatal("Sparse memory image '%s' has a page outside the range\n",
+                  filepath);
+        if (runs.empty() || pages[i] != pages[i - 1] + 1)
+            runs.push_back(make_pair(i, 0));
+        ++runs.back().second;
+    }
+
+    // Pages can only be mapped if they are whole host pages, and if
+    // they tile the mapped part of the store exactly, as mapping a
+    // last page that goes beyond it would clobber whatever is mapped
+    // after the store
+    const uint64_t host_page_size = sysconf(_SC_PAGESIZE);
+    const uint64_t store_size = roundUp(range.size(), host_page_size);
+    bool map = page_size % host_page_size == 0 &&
+        store_size % page_size == 0 && runs.size() <= maxMappedRuns;
+
+    DPRINTF(Checkpoint, "%s %d pages in %d runs from %s\n",
+            map ? "Mapping" : "Reading", pages.size(), runs.size(), filepath);
+
+    // The pages missing from the image are zero. Rather than relying
+    // on the store being untouched since it was created, replace it
+    // with a fresh anonymous mapping, which also drops any pages it
+    // had already been given.
+    if (mmap(pmem, store_size, PROT_READ | PROT_WRITE,
+             MAP_ANON | MAP_PRIVATE | MAP_FIXED, -1, 0) == MAP_FAILED)
+        fatal("Could not clear the backing store for %s\n", filepath);
+
+    for (size_t r = 0; r < runs.size(); ++r) {
+        uint64_t offset = pages[runs[r].first] * page_size;
+        uint64_t len = runs[r].second * page_size;
+        off_t file_offset = data_offset + runs[r].first * page_size;
+
+        // the pages are only read from the file when first touched,
+        // and writes go to private copies
+        if (map &&
+            mmap(pmem + offset, len, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_FIXED, fd, file_offset) != MAP_FAILED)
+            continue;
+
+        if (map) {
+            // fall back to reading everything that is left, into a
+            // fresh mapping as a failed mmap may have unmapped the
+            // range
+            warn("Could not map sparse memory image '%s': %s\n", filepath,
+                 strerror(errno));
+            map = false;
+
+            uint64_t rest = store_size - offset;
+            if (mmap(pmem + offset, rest, PROT_READ | PROT_WRITE,
+                     MAP_ANON | MAP_PRIVATE | MAP_FIXED, -1, 0) ==
+                MAP_FAILED)
+                fatal("Could not remap the backing store for %s\n",
+                      filepath);
+        }
+
+        readAll(fd, pmem + offset, min(len, range.size() - offset),
+                file_offset, filepath);
+    }
+
+    // the mappings keep the file open
+    close(fd);
+}
+
+void
+PhysicalMemory::readChunkedImage(const string& filepath, AddrRange range,
+                                 uint8_t* pmem)
+{
+    // as with gzip images, the chunks that are all zero are left
+    // untouched
+    ChunkedImage::read(filepath, pmem, range.size(), checkpointThreads);
 }
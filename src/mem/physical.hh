@@ -41,6 +41,7 @@
 #define __PHYSICAL_MEMORY_HH__
 
 #include "base/addr_range_map.hh"
+#include "enums/MemoryImageFormat.hh"
 #include "mem/port.hh"
 
 /**
@@ -88,6 +89,13 @@ class PhysicalMemory : public Serializable
     // system
     std::vector<std::pair<AddrRange, uint8_t*> > backingStore;
 
+    // The format used when writing the backing store to checkpoints
+    const Enums::MemoryImageFormat imageFormat;
+
+    // The number of threads compressing chunked images, 0 for one
+    // per host core
+    const unsigned checkpointThreads;
+
     // Prevent copying
     PhysicalMemory(const PhysicalMemory&);
 
@@ -105,13 +113,57 @@ class PhysicalMemory : public Serializable
     void createBackingStore(AddrRange range,
                             const std::vector<AbstractMemory*>& _memories);
 
+    /**
+     * Write a backing store to a gzip compressed file.
+     */
+    void writeGzipImage(const std::string& filename, AddrRange range,
+                        uint8_t* pmem);
+
+    /**
+     * Write only the non-zero pages of a backing store to a file,
+     * preceded by an index of the pages. See unserializeStore() for
+     * the layout of the file.
+     */
+    void writeSparseImage(const std::string& filename, AddrRange range,
+                          uint8_t* pmem);
+
+    /**
+     * Write a backing store to a chunked image, compressing the
+     * chunks in parallel.
+     */
+    void writeChunkedImage(const std::string& filename, AddrRange range,
+                           uint8_t* pmem);
+
+    /**
+     * Read a backing store from a gzip compressed file.
+     */
+    void readGzipImage(const std::string& filename, AddrRange range,
+                       uint8_t* pmem);
+
+    /**
+     * Restore a backing store from a sparse image, mapping the pages
+     * of the file copy-on-write where possible. The whole store is
+     * replaced, so it does not need to be zero beforehand.
+     */
+    void readSparseImage(const std::string& filename, AddrRange range,
+                         uint8_t* pmem);
+
+    /**
+     * Read a backing store from a chunked image, decompressing the
+     * chunks in parallel.
+     */
+    void readChunkedImage(const std::string& filename, AddrRange range,
+                          uint8_t* pmem);
+
   public:
 
     /**
      * Create a physical memory object, wrapping a number of memories.
      */
     PhysicalMemory(const std::string& _name,
-                   const std::vector<AbstractMemory*>& _memories);
+                   const std::vector<AbstractMemory*>& _memories,
+                   Enums::MemoryImageFormat image_format = Enums::sparse,
+                   unsigned checkpoint_threads = 0);
 
     /**
      * Unmap all the backing store we have used.
@@ -213,6 +265,21 @@ class PhysicalMemory : public Serializable
 
     /**
      * Unserialize a specific backing store, identified by a section.
+     *
+     * Sparse images start with a header of the eight characters
+     * "gem5pmem", a uint32 version, a uint32 page size, a uint64
+     * range size and the uint64 number of pages stored, followed by
+     * the uint64 page number of every page stored, in increasing
+     * order. The pages follow at the first multiple of the page size
+     * after the index, in the same order, and the pages missing from
+     * the index are zero. The page size must be a power of two. All
+     * integers are in host byte order. When the page size of the
+     * image is a multiple of the host page size and divides the
+     * backing store rounded up to host pages, runs of consecutive
+     * pages are mapped MAP_PRIVATE over the backing store, so that
+     * they are only read when first touched, and only copied when
+     * written. Otherwise they are read. Chunked images are described
+     * in base/chunked_image.hh.
      */
     void unserializeStore(Checkpoint* cp, const std::string& section);
 
@@ -56,6 +56,7 @@
 
 #include "base/flags.hh"
 #include "base/misc.hh"
+#include "base/pool_alloc.hh"
 #include "base/types.hh"
 #include "sim/core.hh"
 
@@ -82,7 +83,7 @@ class Request;
 typedef Request* RequestPtr;
 typedef uint16_t MasterID;
 
-class Request
+class Request : public PoolAllocated
 {
   public:
     typedef uint32_t FlagsType;
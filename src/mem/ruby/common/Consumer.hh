@@ -77,7 +77,7 @@ class Consumer
     std::set<Tick> m_scheduled_wakeups;
     ClockedObject *em;
 
-    class ConsumerEvent : public Event
+    class ConsumerEvent : public Event, public PooledEvent<ConsumerEvent>
     {
       public:
           ConsumerEvent(Consumer* _consumer)
@@ -87,6 +87,8 @@ class Consumer
 
           void process() { m_consumer_ptr->wakeup(); }
 
+          static const char *poolName() { return "ruby_consumer"; }
+
       private:
           Consumer* m_consumer_ptr;
     };
@@ -34,6 +34,53 @@
 
 using namespace std;
 
+namespace
+{
+
+void
+putVarint(vector<uint8_t>& buf, uint64_t value)
+{
+    while (value >= 0x80) {
+        buf.push_back(uint8_t(value) | 0x80);
+        value >>= 7;
+    }
+    buf.push_back(uint8_t(value));
+}
+
+uint64_t
+getVarint(const uint8_t* buf, uint64_t size, uint64_t& pos)
+{
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= size)
+            fatal("Truncated Ruby cache trace\n");
+        uint8_t byte = buf[pos++];
+        value |= uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+    fatal("Corrupt Ruby cache trace\n");
+}
+
+uint64_t
+zigzag(int64_t value)
+{
+    return (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+}
+
+int64_t
+unzigzag(uint64_t value)
+{
+    return int64_t(value >> 1) ^ -int64_t(value & 1);
+}
+
+//! Request types with a code of their own in the record flags
+const RubyRequestType typeCodes[] = {
+    RubyRequestType_LD, RubyRequestType_IFETCH, RubyRequestType_ST
+};
+
+}
+
 void
 TraceRecord::print(ostream& out) const
 {
@@ -44,7 +91,8 @@ TraceRecord::print(ostream& out) const
 
 CacheRecorder::CacheRecorder()
     : m_uncompressed_trace(NULL),
-      m_uncompressed_trace_size(0)
+      m_uncompressed_trace_size(0),
+      m_records_read(0), m_records_hit(0), m_records_flushed(0)
 {
 }
 
@@ -53,9 +101,20 @@ CacheRecorder::CacheRecorder(uint8_t* uncompressed_trace,
                              std::vector<Sequencer*>& seq_map)
     : m_uncompressed_trace(uncompressed_trace),
       m_uncompressed_trace_size(uncompressed_trace_size),
-      m_seq_map(seq_map),  m_bytes_read(0), m_records_read(0),
-      m_records_flushed(0)
+      m_seq_map(seq_map),
+      m_zero_block(RubySystem::getBlockSizeBytes(), 0),
+      m_records_read(0), m_records_hit(0), m_records_flushed(0)
 {
+    uint32_t magic = 0;
+    if (m_uncompressed_trace_size >= sizeof(magic)) {
+        for (int i = 0; i < sizeof(magic); ++i)
+            magic |= uint32_t(m_uncompressed_trace[i]) << (8 * i);
+    }
+
+    if (magic == traceMagic)
+        readTrace();
+    else
+        readLegacyTrace();
 }
 
 CacheRecorder::~CacheRecorder()
@@ -67,6 +126,109 @@ CacheRecorder::~CacheRecorder()
     m_seq_map.clear();
 }
 
+void
+CacheRecorder::addFetchRecord(int cntrl, const FetchRecord& rec)
+{
+    assert(cntrl >= 0 && cntrl < m_seq_map.size());
+    Sequencer* sequencer = m_seq_map[cntrl];
+    assert(sequencer != NULL);
+
+    // Controllers without a sequencer share the first one
+    int i = 0;
+    while (i < m_fetch_queues.size() &&
+           m_fetch_queues[i].m_sequencer != sequencer) {
+        ++i;
+    }
+
+    if (i == m_fetch_queues.size()) {
+        m_fetch_queues.push_back(FetchQueue());
+        m_fetch_queues.back().m_sequencer = sequencer;
+        m_fetch_queues.back().m_next = 0;
+    }
+
+    m_fetch_queues[i].m_records.push_back(rec);
+}
+
+void
+CacheRecorder::readTrace()
+{
+    const uint8_t* buf = m_uncompressed_trace;
+    const uint64_t size = m_uncompressed_trace_size;
+    const int block_bytes = RubySystem::getBlockSizeBytes();
+    uint64_t pos = sizeof(traceMagic);
+
+    uint64_t block_bits = getVarint(buf, size, pos);
+    if (block_bits != RubySystem::getBlockSizeBits()) {
+        fatal("Ruby cache trace recorded with %d byte blocks, "
+              "but the block size is %d bytes\n",
+              1ULL << block_bits, block_bytes);
+    }
+
+    m5::hash_map<int, physical_address_t> last_block;
+    m5::hash_map<physical_address_t, uint8_t*> last_data;
+    int cntrl = 0;
+    uint64_t records = 0;
+
+    while (pos < size) {
+        uint8_t flags = buf[pos++];
+
+        if (flags & flagNewCntrl)
+            cntrl = getVarint(buf, size, pos);
+
+        FetchRecord rec;
+        int type_code = flags & flagTypeMask;
+        if (type_code < sizeof(typeCodes) / sizeof(typeCodes[0]))
+            rec.m_type = typeCodes[type_code];
+        else
+            rec.m_type = RubyRequestType(getVarint(buf, size, pos));
+
+        physical_address_t& block = last_block[cntrl];
+        block += unzigzag(getVarint(buf, size, pos));
+        rec.m_data_address = block << block_bits;
+
+        if (flags & flagZeroData) {
+            rec.m_data = &m_zero_block[0];
+        } else if (flags & flagSameData) {
+            m5::hash_map<physical_address_t, uint8_t*>::iterator it =
+                last_data.find(rec.m_data_address);
+            if (it == last_data.end())
+                fatal("Corrupt Ruby cache trace\n");
+            rec.m_data = it->second;
+        } else {
+            if (pos + block_bytes > size)
+                fatal("Truncated Ruby cache trace\n");
+            rec.m_data = m_uncompressed_trace + pos;
+            pos += block_bytes;
+        }
+        last_data[rec.m_data_address] = rec.m_data;
+
+        addFetchRecord(cntrl, rec);
+        ++records;
+    }
+
+    DPRINTF(RubyCacheTrace, "Read %d records for %d sequencers\n",
+            records, m_fetch_queues.size());
+}
+
+void
+CacheRecorder::readLegacyTrace()
+{
+    const uint64_t record_size = sizeof(TraceRecord) +
+        RubySystem::getBlockSizeBytes();
+
+    for (uint64_t pos = 0; pos + record_size <= m_uncompressed_trace_size;
+         pos += record_size) {
+        TraceRecord* traceRecord =
+            (TraceRecord*)(m_uncompressed_trace + pos);
+
+        FetchRecord rec;
+        rec.m_data_address = traceRecord->m_data_address;
+        rec.m_type = traceRecord->m_type;
+        rec.m_data = traceRecord->m_data;
+        addFetchRecord(traceRecord->m_cntrl_id, rec);
+    }
+}
+
 void
 CacheRecorder::enqueueNextFlushRequest()
 {
@@ -88,42 +250,81 @@ CacheRecorder::enqueueNextFlushRequest()
 }
 
 void
-CacheRecorder::enqueueNextFetchRequest()
+CacheRecorder::enqueueNextFetchRequest(Sequencer* sequencer)
 {
-    if (m_bytes_read < m_uncompressed_trace_size) {
-        TraceRecord* traceRecord = (TraceRecord*) (m_uncompressed_trace +
-                                                                m_bytes_read);
+    for (int i = 0; i < m_fetch_queues.size(); ++i) {
+        if (sequencer == NULL || m_fetch_queues[i].m_sequencer == sequencer)
+            issueNextFetchRequest(m_fetch_queues[i]);
+    }
+}
 
-        DPRINTF(RubyCacheTrace, "Issuing %s\n", *traceRecord);
+bool
+CacheRecorder::fetchHit(Sequencer* sequencer, const FetchRecord& rec)
+{
+    if (rec.m_type != RubyRequestType_LD &&
+        rec.m_type != RubyRequestType_IFETCH) {
+        return false;
+    }
+
+    CacheMemory* cache = rec.m_type == RubyRequestType_IFETCH ?
+        sequencer->getInstCache() : sequencer->getDataCache();
+    Address address(rec.m_data_address);
+    AbstractCacheEntry* entry = cache->lookup(address);
+    if (entry == NULL ||
+        (entry->m_Permission != AccessPermission_Read_Only &&
+         entry->m_Permission != AccessPermission_Read_Write)) {
+        return false;
+    }
+
+    // The same as the hit callback of the sequencer while warming up
+    entry->getDataBlk().setData(rec.m_data, 0,
+                                RubySystem::getBlockSizeBytes());
+    cache->setMRU(address);
+    return true;
+}
+
+void
+CacheRecorder::issueNextFetchRequest(FetchQueue& queue)
+{
+    while (queue.m_next < queue.m_records.size()) {
+        const FetchRecord& rec = queue.m_records[queue.m_next++];
+        m_records_read++;
+
+        if (fetchHit(queue.m_sequencer, rec)) {
+            m_records_hit++;
+            continue;
+        }
+
+        DPRINTF(RubyCacheTrace, "Issuing %s of %#x on %s\n",
+                RubyRequestType_to_string(rec.m_type), rec.m_data_address,
+                queue.m_sequencer->name());
         Request* req = new Request();
         MemCmd::Command requestType;
 
-        if (traceRecord->m_type == RubyRequestType_LD) {
+        if (rec.m_type == RubyRequestType_LD) {
             requestType = MemCmd::ReadReq;
-            req->setPhys(traceRecord->m_data_address,
+            req->setPhys(rec.m_data_address,
                     RubySystem::getBlockSizeBytes(),0, Request::funcMasterId);
-        }   else if (traceRecord->m_type == RubyRequestType_IFETCH) {
+        }   else if (rec.m_type == RubyRequestType_IFETCH) {
             requestType = MemCmd::ReadReq;
-            req->setPhys(traceRecord->m_data_address,
+            req->setPhys(rec.m_data_address,
                     RubySystem::getBlockSizeBytes(),
                     Request::INST_FETCH, Request::funcMasterId);
         }   else {
             requestType = MemCmd::WriteReq;
-            req->setPhys(traceRecord->m_data_address,
+            req->setPhys(rec.m_data_address,
                     RubySystem::getBlockSizeBytes(),0, Request::funcMasterId);
         }
 
         Packet *pkt = new Packet(req, requestType);
-        pkt->dataStatic(traceRecord->m_data);
-
-        Sequencer* m_sequencer_ptr = m_seq_map[traceRecord->m_cntrl_id];
-        assert(m_sequencer_ptr != NULL);
-        m_sequencer_ptr->makeRequest(pkt);
+        pkt->dataStatic(rec.m_data);
 
-        m_bytes_read += (sizeof(TraceRecord) +
-                RubySystem::getBlockSizeBytes());
-        m_records_read++;
+        queue.m_sequencer->makeRequest(pkt);
+        return;
     }
+
+    DPRINTF(RubyCacheTrace, "%s done, %d of %d records hit\n",
+            queue.m_sequencer->name(), m_records_hit, m_records_read);
 }
 
 void
@@ -149,33 +350,77 @@ CacheRecorder::aggregateRecords(uint8_t** buf, uint64 total_size)
 {
     std::sort(m_records.begin(), m_records.end(), compareTraceRecords);
 
-    int size = m_records.size();
-    uint64 current_size = 0;
-    int record_size = sizeof(TraceRecord) + RubySystem::getBlockSizeBytes();
-
-    for (int i = 0; i < size; ++i) {
-        // Determine if we need to expand the buffer size
-        if (current_size + record_size > total_size) {
-            uint8_t* new_buf = new (nothrow) uint8_t[total_size * 2];
-            if (new_buf == NULL) {
-                fatal("Unable to allocate buffer of size %s\n",
-                      total_size * 2);
-            }
-            total_size = total_size * 2;
-            uint8_t* old_buf = *buf;
-            memcpy(new_buf, old_buf, current_size);
-            *buf = new_buf;
-            delete [] old_buf;
+    const int block_bytes = RubySystem::getBlockSizeBytes();
+    const int block_bits = RubySystem::getBlockSizeBits();
+    vector<uint8_t> trace;
+    trace.reserve(m_records.size() * 4);
+
+    for (int i = 0; i < sizeof(traceMagic); ++i)
+        trace.push_back(uint8_t(traceMagic >> (8 * i)));
+    putVarint(trace, block_bits);
+
+    m5::hash_map<int, physical_address_t> last_block;
+    m5::hash_map<physical_address_t, const uint8_t*> last_data;
+    int cntrl = 0;
+
+    for (int i = 0; i < m_records.size(); ++i) {
+        const TraceRecord* rec = m_records[i];
+        const physical_address_t block = rec->m_data_address >> block_bits;
+
+        uint8_t flags = 0;
+        int type_code = 0;
+        while (type_code < sizeof(typeCodes) / sizeof(typeCodes[0]) &&
+               typeCodes[type_code] != rec->m_type) {
+            ++type_code;
         }
+        flags |= type_code;
 
-        // Copy the current record into the buffer
-        memcpy(&((*buf)[current_size]), m_records[i], record_size);
-        current_size += record_size;
+        if (rec->m_cntrl_id != cntrl)
+            flags |= flagNewCntrl;
 
-        free(m_records[i]);
-        m_records[i] = NULL;
+        bool zero = true;
+        for (int j = 0; j < block_bytes && zero; ++j)
+            zero = rec->m_data[j] == 0;
+
+        m5::hash_map<physical_address_t, const uint8_t*>::iterator it =
+            last_data.find(rec->m_data_address);
+        if (zero) {
+            flags |= flagZeroData;
+        } else if (it != last_data.end() &&
+                   memcmp(it->second, rec->m_data, block_bytes) == 0) {
+            flags |= flagSameData;
+        }
+        last_data[rec->m_data_address] = rec->m_data;
+
+        trace.push_back(flags);
+        if (flags & flagNewCntrl) {
+            cntrl = rec->m_cntrl_id;
+            putVarint(trace, cntrl);
+        }
+        if (type_code == sizeof(typeCodes) / sizeof(typeCodes[0]))
+            putVarint(trace, rec->m_type);
+
+        physical_address_t& last = last_block[cntrl];
+        putVarint(trace, zigzag(int64_t(block - last)));
+        last = block;
+
+        if (!(flags & (flagZeroData | flagSameData)))
+            trace.insert(trace.end(), rec->m_data, rec->m_data + block_bytes);
     }
 
+    for (int i = 0; i < m_records.size(); ++i)
+        free(m_records[i]);
     m_records.clear();
-    return current_size;
+
+    if (trace.size() > total_size) {
+        uint8_t* new_buf = new (nothrow) uint8_t[trace.size()];
+        if (new_buf == NULL) {
+            fatal("Unable to allocate buffer of size %s\n", trace.size());
+        }
+        delete [] *buf;
+        *buf = new_buf;
+    }
+
+    memcpy(*buf, &trace[0], trace.size());
+    return trace.size();
 }
@@ -63,6 +63,33 @@ class TraceRecord {
     void print(std::ostream& out) const;
 };
 
+/*!
+ * Class for recording the contents of the caches in a trace, and for
+ * warming up the caches from such a trace.
+ *
+ * Traces are written in a compact format, which starts with a magic
+ * number (traceMagic) and the log2 of the block size. Each record
+ * then consists of a flags byte, holding the request type in its low
+ * bits, followed by:
+ *  - the controller as a varint, if it differs from the previous
+ *    record's (flagNewCntrl),
+ *  - the request type as a varint, if it is not LD, IFETCH or ST,
+ *  - the difference from the previous block address of the same
+ *    controller, in blocks, as a zigzag varint,
+ *  - the data of the block, unless it is all zeros (flagZeroData) or
+ *    the same as in the previous record for the block
+ *    (flagSameData).
+ * The PC and time of the records are not stored, the records are in
+ * replay order. Traces of the old format, an array of TraceRecords,
+ * are still read.
+ *
+ * The trace is replayed in parallel on all sequencers, with one
+ * request in flight per sequencer, so that the accesses of every
+ * controller keep their order. Loads and instruction fetches that
+ * hit in the L1 of their sequencer don't go through the protocol:
+ * their data is installed in the cache entry and the replacement
+ * state updated, which is exactly what a hit in the protocol does.
+ */
 class CacheRecorder
 {
   public:
@@ -76,6 +103,15 @@ class CacheRecorder
                    const physical_address_t pc_addr,  RubyRequestType type,
                    Time time, DataBlock& data);
 
+    /*!
+     * Sort the records in replay order and encode them in the trace
+     * format.
+     *
+     * @param data Buffer of the given size to write the trace to,
+     * replaced by a larger buffer if needed.
+     * @param size Size of the buffer.
+     * @return Size of the trace.
+     */
     uint64 aggregateRecords(uint8_t** data, uint64 size);
 
     /*!
@@ -91,23 +127,67 @@ class CacheRecorder
     /*!
      * Function for fetching warming up the memory and the caches. It goes
      * through the recorded contents of the caches, as available in the
-     * checkpoint and issues fetch requests. Except for the first one, a
-     * fetch request is issued only after the previous one has completed.
-     * It should be possible to use this with any protocol.
+     * checkpoint and issues fetch requests. Every sequencer has at most
+     * one fetch request in flight, the next one is issued when the
+     * previous one has completed. It should be possible to use this
+     * with any protocol.
+     *
+     * @param sequencer Sequencer whose request has completed, or NULL
+     * to start the replay on all sequencers.
      */
-    void enqueueNextFetchRequest();
+    void enqueueNextFetchRequest(Sequencer* sequencer = NULL);
+
+    //! First bytes of a trace in the compact format
+    static const uint32_t traceMagic = 0xff544352;
 
   private:
     // Private copy constructor and assignment operator
     CacheRecorder(const CacheRecorder& obj);
     CacheRecorder& operator=(const CacheRecorder& obj);
 
+    //! Flags of the records of a compact trace
+    enum {
+        flagTypeMask = 0x3,
+        flagNewCntrl = 0x4,
+        flagSameData = 0x8,
+        flagZeroData = 0x10
+    };
+
+    //! A request to replay
+    struct FetchRecord
+    {
+        physical_address_t m_data_address;
+        RubyRequestType m_type;
+        uint8_t* m_data;
+    };
+
+    //! The requests of a sequencer, in replay order
+    struct FetchQueue
+    {
+        Sequencer* m_sequencer;
+        std::vector<FetchRecord> m_records;
+        uint64_t m_next;
+    };
+
+    void readTrace();
+    void readLegacyTrace();
+    void addFetchRecord(int cntrl, const FetchRecord& rec);
+
+    /*!
+     * Issue the next request of a sequencer, after performing all
+     * loads that hit in its caches directly.
+     */
+    void issueNextFetchRequest(FetchQueue& queue);
+    bool fetchHit(Sequencer* sequencer, const FetchRecord& rec);
+
     std::vector<TraceRecord*> m_records;
     uint8_t* m_uncompressed_trace;
     uint64_t m_uncompressed_trace_size;
     std::vector<Sequencer*> m_seq_map;
-    uint64_t m_bytes_read;
+    std::vector<FetchQueue> m_fetch_queues;
+    std::vector<uint8_t> m_zero_block;
     uint64_t m_records_read;
+    uint64_t m_records_hit;
     uint64_t m_records_flushed;
 };
 
@@ -566,7 +566,7 @@ Sequencer::hitCallback(SequencerRequest* srequest, DataBlock& data,
         assert(pkt->req);
         delete pkt->req;
         delete pkt;
-        g_system_ptr->m_cache_recorder->enqueueNextFetchRequest();
+        g_system_ptr->m_cache_recorder->enqueueNextFetchRequest(this);
     } else if (g_system_ptr->m_cooldown_enabled) {
         delete pkt;
         g_system_ptr->m_cache_recorder->enqueueNextFlushRequest();
@@ -88,6 +88,9 @@ class Sequencer : public RubyPort
     bool empty() const;
     int outstandingCount() const { return m_outstanding_count; }
 
+    CacheMemory* getDataCache() const { return m_dataCache_ptr; }
+    CacheMemory* getInstCache() const { return m_instCache_ptr; }
+
     bool isDeadlockEventScheduled() const
     { return deadlockCheckEvent.scheduled(); }
 
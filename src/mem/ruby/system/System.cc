@@ -305,6 +305,15 @@ RubySystem::unserialize(Checkpoint *cp, const string &section)
     m_warmup_enabled = true;
 
     vector<Sequencer*> sequencer_map;
+    getSequencerMap(sequencer_map);
+
+    m_cache_recorder = new CacheRecorder(uncompressed_trace, cache_trace_size,
+                                         sequencer_map);
+}
+
+void
+RubySystem::getSequencerMap(vector<Sequencer*> &sequencer_map)
+{
     Sequencer* t = NULL;
     for (int cntrl = 0; cntrl < m_abs_cntrl_vec.size(); cntrl++) {
         sequencer_map.push_back(m_abs_cntrl_vec[cntrl]->getSequencer());
@@ -318,9 +327,6 @@ RubySystem::unserialize(Checkpoint *cp, const string &section)
             sequencer_map[cntrl] = t;
         }
     }
-
-    m_cache_recorder = new CacheRecorder(uncompressed_trace, cache_trace_size,
-                                         sequencer_map);
 }
 
 void
@@ -376,6 +382,86 @@ RubySystem::startup()
     resetStats();
 }
 
+void
+RubySystem::warmCaches(CacheWarmer &warmer,
+                       const vector<CacheWarmer::Access> &trace)
+{
+    if (trace.empty())
+        return;
+
+    if (warmer.blockSize() != getBlockSizeBytes())
+        fatal("Ruby block size (%d) differs from the block size of %s (%d)\n",
+              getBlockSizeBytes(), warmer.name(), warmer.blockSize());
+
+    vector<Sequencer*> sequencer_map;
+    getSequencerMap(sequencer_map);
+
+    // The i-th CPU is attached to the i-th controller with a sequencer
+    vector<int> cpu_cntrls;
+    for (int cntrl = 0; cntrl < m_abs_cntrl_vec.size(); cntrl++) {
+        if (m_abs_cntrl_vec[cntrl]->getSequencer() != NULL)
+            cpu_cntrls.push_back(cntrl);
+    }
+
+    // Build a trace in the checkpoint format. Records are replayed in
+    // decreasing order of time, so count down to keep the order of
+    // the accesses.
+    CacheRecorder recorder;
+    vector<uint8_t> blk(getBlockSizeBytes());
+    DataBlock data;
+    for (uint64 i = 0; i < trace.size(); ++i) {
+        const CacheWarmer::Access &access = trace[i];
+
+        int cntrl = access.cpu < cpu_cntrls.size() ?
+            cpu_cntrls[access.cpu] : cpu_cntrls[0];
+
+        RubyRequestType type = RubyRequestType_LD;
+        if (access.type == CacheWarmer::Inst)
+            type = RubyRequestType_IFETCH;
+        else if (access.type == CacheWarmer::Write)
+            type = RubyRequestType_ST;
+
+        // Stores write their data, so it has to be current
+        warmer.readBlock(access.addr, &blk[0]);
+        data.setData(&blk[0], 0, getBlockSizeBytes());
+
+        recorder.addRecord(cntrl, access.addr, 0, type, trace.size() - i,
+                           data);
+    }
+
+    uint8_t *raw_data = new uint8_t[4096];
+    uint64 cache_trace_size = recorder.aggregateRecords(&raw_data, 4096);
+
+    DPRINTF(RubyCacheTrace, "Warming caches with %d accesses\n",
+            trace.size());
+
+    m_cache_recorder = new CacheRecorder(raw_data, cache_trace_size,
+                                         sequencer_map);
+    m_warmup_enabled = true;
+
+    // Replay the trace as when restoring a checkpoint, except that
+    // time keeps going from the current tick.
+    Tick curtick_original = curTick();
+    Event* eventq_head = eventq->replaceHead(NULL);
+
+    enqueueRubyEvent(curTick());
+    simulate();
+
+    delete m_cache_recorder;
+    m_cache_recorder = NULL;
+    m_warmup_enabled = false;
+
+    for (int i = 0; i < m_memory_controller_vec.size(); ++i) {
+        m_memory_controller_vec[i]->reset();
+    }
+
+    eventq_head = eventq->replaceHead(eventq_head);
+    setCurTick(curtick_original);
+    resetClock();
+
+    DPRINTF(RubyCacheTrace, "Cache warming complete\n");
+}
+
 void
 RubySystem::RubyEvent::process()
 {
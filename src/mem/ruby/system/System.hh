@@ -37,6 +37,7 @@
 
 #include "base/callback.hh"
 #include "base/output.hh"
+#include "mem/cache_warmer.hh"
 #include "mem/packet.hh"
 #include "mem/ruby/profiler/Profiler.hh"
 #include "mem/ruby/recorder/CacheRecorder.hh"
@@ -49,7 +50,7 @@
 
 class Network;
 
-class RubySystem : public ClockedObject
+class RubySystem : public ClockedObject, public CacheWarmer::Target
 {
   public:
     class RubyEvent : public Event
@@ -102,6 +103,8 @@ class RubySystem : public ClockedObject
     void unserialize(Checkpoint *cp, const std::string &section);
     void process();
     void startup();
+    void warmCaches(CacheWarmer &warmer,
+                    const std::vector<CacheWarmer::Access> &trace);
     bool functionalRead(Packet *ptr);
     bool functionalWrite(Packet *ptr);
 
@@ -128,6 +131,12 @@ class RubySystem : public ClockedObject
     void writeCompressedTrace(uint8_t *raw_data, std::string file,
                               uint64 uncompressed_trace_size);
 
+    /*!
+     * Map each controller to its sequencer, or to the first sequencer
+     * for controllers without one.
+     */
+    void getSequencerMap(std::vector<Sequencer*> &sequencer_map);
+
   private:
     // configuration parameters
     static int m_random_seed;
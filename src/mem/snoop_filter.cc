@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definition of a snoop filter for the coherent bus.
+ */
+
+#include <cassert>
+
+#include "base/misc.hh"
+#include "base/trace.hh"
+#include "debug/SnoopFilter.hh"
+#include "mem/snoop_filter.hh"
+#include "sim/system.hh"
+
+SnoopFilter::SnoopFilter(const SnoopFilterParams *p)
+    : SimObject(p), overflow(p->overflow_groups, 0), numSnoopPorts(0),
+      allPorts(0), seqNum(0), maxCapacity(p->max_capacity),
+      lineSize(p->system->cacheLineSize())
+{
+    if (overflow.empty())
+        fatal("Snoop filter %s needs at least one overflow group\n",
+              name());
+}
+
+void
+SnoopFilter::setSlavePorts(const std::vector<SlavePort*> &snoop_ports,
+                           size_t num_slave_ports)
+{
+    if (snoop_ports.size() > sizeof(SnoopMask) * 8)
+        fatal("Snoop filter %s supports at most %d snooping masters\n",
+              name(), sizeof(SnoopMask) * 8);
+
+    portBits.assign(num_slave_ports, 0);
+    allPorts = 0;
+    for (int i = 0; i < snoop_ports.size(); ++i) {
+        portBits[snoop_ports[i]->getId()] = SnoopMask(1) << i;
+        allPorts |= SnoopMask(1) << i;
+    }
+
+    numSnoopPorts = snoop_ports.size();
+    overflowCount.assign(overflow.size() * numSnoopPorts, 0);
+}
+
+void
+SnoopFilter::addOverflow(Addr line, SnoopMask holders)
+{
+    unsigned group = overflowGroup(line);
+    unsigned *count = &overflowCount[group * numSnoopPorts];
+
+    evicted[line] = holders;
+    for (SnoopMask h = holders; h; h &= h - 1)
+        ++count[__builtin_ctzll(h)];
+    overflow[group] |= holders;
+}
+
+SnoopFilter::SnoopMask
+SnoopFilter::removeOverflow(Addr line)
+{
+    EvictedMap::iterator e = evicted.find(line);
+    if (e == evicted.end())
+        return 0;
+
+    SnoopMask holders = e->second;
+    evicted.erase(e);
+
+    unsigned group = overflowGroup(line);
+    unsigned *count = &overflowCount[group * numSnoopPorts];
+    for (SnoopMask h = holders; h; h &= h - 1) {
+        int port = __builtin_ctzll(h);
+        assert(count[port] > 0);
+        if (--count[port] == 0)
+            overflow[group] &= ~(SnoopMask(1) << port);
+    }
+
+    return holders;
+}
+
+SnoopFilter::SnoopItem &
+SnoopFilter::allocate(Addr line)
+{
+    SnoopMap::iterator i = lines.find(line);
+    if (i != lines.end())
+        return i->second;
+
+    // make room by moving the oldest line still tracked to its
+    // overflow group, skipping lines that were already removed
+    while (lines.size() >= maxCapacity && !allocOrder.empty()) {
+        std::pair<Addr, uint64_t> victim = allocOrder.front();
+        allocOrder.pop_front();
+
+        SnoopMap::iterator v = lines.find(victim.first);
+        if (v != lines.end() && v->second.seq == victim.second) {
+            DPRINTF(SnoopFilter, "Evicting line %#x holders %#x\n",
+                    victim.first, v->second.holders);
+            addOverflow(victim.first, v->second.holders);
+            lines.erase(v);
+            ++overflowEvictions;
+        }
+    }
+
+    // entries removed early leave stale allocation records behind,
+    // drop them once they outnumber the live ones
+    if (allocOrder.size() > 2 * maxCapacity + 64) {
+        std::deque<std::pair<Addr, uint64_t> > live;
+        for (auto a = allocOrder.begin(); a != allocOrder.end(); ++a) {
+            SnoopMap::iterator v = lines.find(a->first);
+            if (v != lines.end() && v->second.seq == a->second)
+                live.push_back(*a);
+        }
+        allocOrder.swap(live);
+    }
+
+    SnoopItem &item = lines[line];
+    item.holders = 0;
+    item.seq = seqNum++;
+    allocOrder.push_back(std::make_pair(line, item.seq));
+    return item;
+}
+
+void
+SnoopFilter::countSnoops(SnoopMask targets, SnoopMask candidates)
+{
+    int sent = __builtin_popcountll(targets);
+    snoopsSent += sent;
+    snoopsFiltered += __builtin_popcountll(candidates) - sent;
+}
+
+SnoopFilter::SnoopMask
+SnoopFilter::lookupRequest(const Packet *pkt, PortID slave_port_id)
+{
+    Addr line = lineKey(pkt);
+    SnoopMask self = portBits[slave_port_id];
+
+    SnoopMap::iterator i = lines.find(line);
+    SnoopMask holders = i != lines.end() ? i->second.holders : 0;
+    SnoopMask targets = (holders | overflowMask(line)) & ~self;
+
+    ++totRequests;
+    countSnoops(targets, allPorts & ~self);
+
+    // a line that overflowed is tracked individually again, so that
+    // its group stops being snooped for it
+    if (!evicted.empty())
+        holders |= removeOverflow(line);
+
+    // every other copy is invalidated by the snoops, whereas the
+    // requester will hold the line unless this is an express snoop
+    // on its way down, or a writeback of a line it evicted
+    if (pkt->isInvalidate())
+        holders &= self;
+    if (!pkt->isExpressSnoop() && pkt->cmd != MemCmd::Writeback)
+        holders |= self;
+
+    if (holders) {
+        if (i == lines.end())
+            allocate(line).holders = holders;
+        else
+            i->second.holders = holders;
+    } else if (i != lines.end()) {
+        lines.erase(i);
+    }
+
+    DPRINTF(SnoopFilter, "%s %s line %#x targets %#x holders %#x\n",
+            __func__, pkt->cmdString(), line, targets, holders);
+
+    return targets;
+}
+
+SnoopFilter::SnoopMask
+SnoopFilter::lookupSnoop(const Packet *pkt)
+{
+    Addr line = lineKey(pkt);
+
+    SnoopMap::iterator i = lines.find(line);
+    SnoopMask holders = i != lines.end() ? i->second.holders : 0;
+    SnoopMask targets = holders | overflowMask(line);
+
+    ++totSnoops;
+    countSnoops(targets, allPorts);
+
+    // the snoop is forwarded upwards by the caches, so after an
+    // invalidation nothing above the bus holds the line any longer
+    if (pkt->isInvalidate()) {
+        if (i != lines.end())
+            lines.erase(i);
+        else if (!evicted.empty())
+            removeOverflow(line);
+    }
+
+    DPRINTF(SnoopFilter, "%s %s line %#x targets %#x\n",
+            __func__, pkt->cmdString(), line, targets);
+
+    return targets;
+}
+
+void
+SnoopFilter::regStats()
+{
+    SimObject::regStats();
+
+    totRequests
+        .name(name() + ".tot_requests")
+        .desc("Total number of requests looked up")
+        ;
+
+    totSnoops
+        .name(name() + ".tot_snoops")
+        .desc("Total number of snoops from below looked up")
+        ;
+
+    snoopsSent
+        .name(name() + ".snoops_sent")
+        .desc("Number of snoops forwarded to snooping masters")
+        ;
+
+    snoopsFiltered
+        .name(name() + ".snoops_filtered")
+        .desc("Number of snoops a broadcast would have sent in addition")
+        ;
+
+    overflowEvictions
+        .name(name() + ".overflow_evictions")
+        .desc("Number of lines moved to the overflow groups")
+        ;
+}
+
+SnoopFilter *
+SnoopFilterParams::create()
+{
+    return new SnoopFilter(this);
+}
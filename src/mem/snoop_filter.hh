@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a snoop filter for the coherent bus.
+ */
+
+#ifndef __MEM_SNOOP_FILTER_HH__
+#define __MEM_SNOOP_FILTER_HH__
+
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "base/hashmap.hh"
+#include "base/statistics.hh"
+#include "mem/packet.hh"
+#include "mem/port.hh"
+#include "params/SnoopFilter.hh"
+#include "sim/sim_object.hh"
+
+class System;
+
+/**
+ * A snoop filter keeps track of which of the snooping masters of a
+ * coherent bus may hold a copy of a line, so that the bus only has to
+ * forward snoops to those masters rather than broadcast them. It only
+ * sees the traffic going through the bus, and the caches evict clean
+ * lines silently, so a master is considered to hold a line from the
+ * moment it requests it until a request or snoop that invalidates all
+ * other copies passes through the bus. Every master that may hold a
+ * line is thus always snooped, and the filter never changes the
+ * outcome of a simulation compared to broadcasting.
+ *
+ * At most max_capacity lines are tracked individually. When a line
+ * has to be evicted to make room, rather than being invalidated in
+ * the caches, it is moved to one of a number of overflow groups, and
+ * all the lines of the group are snooped as if held by every holder
+ * of any of them. The group counts, per snoop port, the lines it
+ * holds, so that a port stops being snooped for the group once all
+ * of them are invalidated or tracked individually again. The holders
+ * of every line in the groups are kept to make that possible.
+ */
+class SnoopFilter : public SimObject
+{
+  public:
+    /** Bit mask of snooping masters, one bit per snoop port. */
+    typedef uint64_t SnoopMask;
+
+    SnoopFilter(const SnoopFilterParams *p);
+
+    /**
+     * Set the snooping masters of the bus. The bit of a master in a
+     * SnoopMask is its position in the vector.
+     *
+     * @param snoop_ports Slave ports connected to snooping masters
+     * @param num_slave_ports Total number of slave ports of the bus
+     */
+    void setSlavePorts(const std::vector<SlavePort*> &snoop_ports,
+                       size_t num_slave_ports);
+
+    /**
+     * Look up a request from one of the masters of the bus and
+     * update the holders of the line accordingly.
+     *
+     * @param pkt Request about to be forwarded to the snoopers
+     * @param slave_port_id Port the request was received on
+     * @return The snoop ports that need to see the request
+     */
+    SnoopMask lookupRequest(const Packet *pkt, PortID slave_port_id);
+
+    /**
+     * Look up a snoop received from below the bus and update the
+     * holders of the line accordingly.
+     *
+     * @param pkt Snoop about to be forwarded to the snoopers
+     * @return The snoop ports that need to see the snoop
+     */
+    SnoopMask lookupSnoop(const Packet *pkt);
+
+    virtual void regStats();
+
+  private:
+    /** Holders of a line tracked individually. */
+    struct SnoopItem
+    {
+        SnoopMask holders;
+        /** Allocation number, to find the entry in the FIFO. */
+        uint64_t seq;
+    };
+
+    typedef m5::hash_map<Addr, SnoopItem> SnoopMap;
+
+    /** Lines tracked individually, indexed by line address. */
+    SnoopMap lines;
+
+    /** Allocation order of the lines, oldest first. */
+    std::deque<std::pair<Addr, uint64_t> > allocOrder;
+
+    typedef m5::hash_map<Addr, SnoopMask> EvictedMap;
+
+    /** Holders of the lines evicted from lines. */
+    EvictedMap evicted;
+
+    /** Holders of the evicted lines of each group. */
+    std::vector<SnoopMask> overflow;
+
+    /**
+     * Number of evicted lines of each group held by each snoop port,
+     * indexed by group * numSnoopPorts + snoop port.
+     */
+    std::vector<unsigned> overflowCount;
+
+    /** Number of snoop ports. */
+    unsigned numSnoopPorts;
+
+    /** Bit of every slave port, 0 for non-snooping ports. */
+    std::vector<SnoopMask> portBits;
+
+    /** All snoop ports. */
+    SnoopMask allPorts;
+
+    /** Number of allocations so far. */
+    uint64_t seqNum;
+
+    const unsigned maxCapacity;
+    const unsigned lineSize;
+
+    /** Key of the line a packet targets. */
+    Addr
+    lineKey(const Packet *pkt) const
+    {
+        // lines are aligned, so the secure bit fits in the offset
+        return (pkt->getAddr() & ~Addr(lineSize - 1)) |
+            (pkt->isSecure() ? 1 : 0);
+    }
+
+    /** Overflow group of a line. */
+    unsigned
+    overflowGroup(Addr line) const
+    {
+        return (line / lineSize) % overflow.size();
+    }
+
+    SnoopMask overflowMask(Addr line) const
+    { return overflow[overflowGroup(line)]; }
+
+    /** Move a line that is not tracked individually to its group. */
+    void addOverflow(Addr line, SnoopMask holders);
+
+    /**
+     * Take a line out of its overflow group.
+     * @return The holders of the line, 0 if it was not in the group
+     */
+    SnoopMask removeOverflow(Addr line);
+
+    /** Find the entry of a line, allocating it if needed. */
+    SnoopItem &allocate(Addr line);
+
+    /** Count the snoops sent and avoided for a lookup. */
+    void countSnoops(SnoopMask targets, SnoopMask candidates);
+
+    Stats::Scalar totRequests;
+    Stats::Scalar totSnoops;
+    Stats::Scalar snoopsSent;
+    Stats::Scalar snoopsFiltered;
+    Stats::Scalar overflowEvictions;
+};
+
+#endif // __MEM_SNOOP_FILTER_HH__
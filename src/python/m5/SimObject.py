@@ -619,6 +619,7 @@ class SimObject(object):
     void regProbePoints();
     void regProbeListeners();
     void startup();
+    void notifyFork();
 ''')
 
     # Initialize new instance.  For objects with SimObject-valued
@@ -45,6 +45,7 @@ if internal:
     import core
     import objects
     import params
+    import sampling
     import stats
     import util
 
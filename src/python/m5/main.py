@@ -82,11 +82,22 @@ def parse_options():
     group("Statistics Options")
     option("--stats-file", metavar="FILE", default="stats.txt",
         help="Sets the output file for statistics [Default: %default]")
+    option("--stats-binary-file", metavar="FILE", default="",
+        help="Also write statistics in binary form to FILE, see "
+        "m5/stats/binary.py for a reader")
+    option("--stats-incremental", action="store_true", default=False,
+        help="Only dump the stats that changed since the previous dump, "
+        "and only reset the stats that changed since the previous reset")
 
     # Configuration Options
     group("Configuration Options")
     option("--dump-config", metavar="FILE", default="config.ini",
         help="Dump configuration output file [Default: %default]")
+    option("--checkpoint-format", metavar="FORMAT", default="binary",
+        choices=["binary", "ini"],
+        help="Write checkpoints in FORMAT, binary or ini, both of which "
+        "can be restored; util/cpt_upgrader.py converts between them "
+        "[Default: %default]")
     option("--json-config", metavar="FILE", default="config.json",
         help="Create JSON output of the configuration [Default: %default]")
     option("--dot-config", metavar="FILE", default="config.dot",
@@ -307,12 +318,17 @@ def main(*args):
 
     # tell C++ about output directory
     core.setOutputDir(options.outdir)
+    core.setCheckpointFormat(options.checkpoint_format)
 
     # update the system path with elements from the -p option
     sys.path[0:0] = options.path
 
     # set stats options
     stats.initText(options.stats_file)
+    if options.stats_binary_file:
+        stats.initBinary(options.stats_binary_file)
+    if options.stats_incremental:
+        stats.setIncremental(True)
 
     # set debugging options
     debug.setRemoteGDBPort(options.remote_gdb_port)
@@ -0,0 +1,227 @@
+# Copyright (c) 2014 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import math
+import os
+
+import internal
+import stats
+from simulate import MaxTick, curTick, simulate, switchCpus
+from util import fatal
+
+# Must match SamplingController::exitCause
+sample_cause = "sample complete"
+
+def zscore(confidence):
+    '''Two sided quantile of the standard normal distribution for the
+    given confidence level.'''
+    lo, hi = 0.0, 10.0
+    for i in xrange(64):
+        mid = (lo + hi) / 2
+        if math.erf(mid / math.sqrt(2)) < confidence:
+            lo = mid
+        else:
+            hi = mid
+    return (lo + hi) / 2
+
+class SampleStat(object):
+    '''Values a statistic took in the samples.'''
+    def __init__(self, name):
+        self.name = name
+        self.values = []
+        self.weights = []
+
+    def add(self, value, weight=1.0):
+        self.values.append(value)
+        self.weights.append(weight)
+
+    def __len__(self):
+        return len(self.values)
+
+    def weighted(self):
+        return any(w != 1.0 for w in self.weights)
+
+    def mean(self):
+        total = sum(self.weights)
+        if not total:
+            return float('nan')
+        return sum(v * w for v, w in zip(self.values, self.weights)) / total
+
+    def stdev(self):
+        n = len(self.values)
+        if n < 2:
+            return float('nan')
+        mean = self.mean()
+        return math.sqrt(sum((v - mean) ** 2 for v in self.values) / (n - 1))
+
+    def interval(self, confidence):
+        '''Half width of the confidence interval of the mean, None for
+        weighted (SimPoint) samples, which are not random.'''
+        if self.weighted():
+            return None
+        return zscore(confidence) * self.stdev() / math.sqrt(len(self))
+
+def _value(stat):
+    if isinstance(stat, internal.stats.ScalarInfo):
+        return stat.result()
+    return stat.total()
+
+class Sampler(object):
+    '''Takes the samples of a SamplingController and aggregates the
+    statistics of the samples.
+
+    The functional CPUs of the controller must be switched in and
+    the detailed CPUs switched out when run() is first called.'''
+
+    def __init__(self, controller, verbose=True):
+        for cpu in controller.functional_cpus:
+            if cpu.memory_mode() not in ('atomic', 'atomic_noncaching'):
+                fatal("%s: functional CPU %s must use atomic memory mode",
+                      controller, cpu)
+        for cpu in controller.detailed_cpus:
+            if cpu.memory_mode() != 'timing' or not cpu.support_take_over():
+                fatal("%s: detailed CPU %s must use timing memory mode and "
+                      "support take over", controller, cpu)
+        if controller.weights and \
+                len(controller.weights) != len(controller.start_insts):
+            fatal("%s: needs one weight per sample", controller)
+
+        self.controller = controller
+        self.verbose = verbose
+
+        names = list(controller.sample_stats)
+        if not names:
+            for cpu in controller.detailed_cpus:
+                name = cpu.path() + '.ipc'
+                if name not in stats.stats_dict:
+                    name = cpu.path() + '.numCycles'
+                names.append(name)
+
+        self.infos = []
+        for name in names:
+            if name not in stats.stats_dict:
+                fatal("%s: no statistic named %s", controller, name)
+            info = stats.stats_dict[name]
+            if not isinstance(info, (internal.stats.ScalarInfo,
+                                     internal.stats.VectorInfo)):
+                fatal("%s: %s is not a scalar, vector or formula",
+                      controller, name)
+            self.infos.append(info)
+        self.stats = [ SampleStat(name) for name in names ]
+
+    def collect(self):
+        weights = self.controller.weights
+        sample = self.controller.samples()
+        weight = weights[sample - 1] if weights else 1.0
+
+        stats.prepare(self.infos)
+        for stat, info in zip(self.stats, self.infos):
+            stat.add(_value(info), weight)
+
+        if self.verbose:
+            print "sample %d @ tick %d: %s" % (sample, curTick(),
+                ", ".join("%s %g" % (s.name, s.values[-1])
+                          for s in self.stats))
+
+        if self.controller.dump_samples:
+            stats.dump()
+
+    def converged(self):
+        target = self.controller.target_error
+        if not target or not self.stats:
+            return False
+
+        stat = self.stats[0]
+        if len(stat) < self.controller.min_samples:
+            return False
+
+        interval = stat.interval(self.controller.confidence)
+        mean = stat.mean()
+        return interval is not None and mean != 0 and \
+            interval / abs(mean) <= target
+
+    def run(self, max_tick=MaxTick):
+        '''Take samples until the controller is done, the target error
+        is reached or max_tick. The detailed CPUs are left running
+        after the last sample.
+
+        Returns the exit event if the simulation stopped for another
+        reason, None otherwise.'''
+
+        controller = self.controller
+        cpu_list = zip(controller.detailed_cpus, controller.functional_cpus)
+        first = controller.samples() == 0 and \
+            not controller.functional_cpus[0].switchedOut()
+
+        while not controller.done():
+            if not first:
+                switchCpus(controller.system, cpu_list, verbose=False)
+            first = False
+
+            controller.startFunctional()
+            exit_event = simulate(max_tick - curTick())
+            if exit_event.getCause() != sample_cause:
+                return exit_event
+
+            self.collect()
+            if self.converged():
+                break
+
+        return None
+
+    def report(self, filename='sampling.txt'):
+        '''Print the aggregated statistics, and write them to a file in
+        the output directory.'''
+        from m5 import options
+
+        confidence = self.controller.confidence
+        lines = [ "%-40s %14s %14s %14s %8s" %
+                  ("statistic", "mean", "stdev",
+                   "+/-%g%%" % (confidence * 100), "samples") ]
+        for stat in self.stats:
+            interval = stat.interval(confidence)
+            lines.append("%-40s %14g %14g %14s %8d" %
+                         (stat.name, stat.mean(), stat.stdev(),
+                          "-" if interval is None else "%g" % interval,
+                          len(stat)))
+
+        for line in lines:
+            print line
+
+        if filename:
+            f = file(os.path.join(options.outdir, filename), 'w')
+            for line in lines:
+                print >>f, line
+            f.close()
+
+def run(controller, max_tick=MaxTick):
+    '''Take the samples of a SamplingController and report the
+    aggregated statistics. Returns the exit event if the simulation
+    stopped before sampling was done, None otherwise.'''
+    sampler = Sampler(controller)
+    exit_event = sampler.run(max_tick)
+    sampler.report()
+    return exit_event
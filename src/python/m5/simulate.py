@@ -314,4 +314,94 @@ def switchCpus(system, cpuList, do_drain=True, verbose=True):
     if do_drain:
         resume(system)
 
+def _redirectForked(stream, parent_outdir, outdir, filename, size):
+    # Start the file of the child with the first size bytes the parent
+    # had written to its file, such as the banner printed at startup
+    parent_file = open(os.path.join(parent_outdir, filename), 'rb')
+    preamble = parent_file.read(size)
+    parent_file.close()
+
+    redir_fd = os.open(os.path.join(outdir, filename),
+                       os.O_WRONLY | os.O_CREAT | os.O_TRUNC)
+    while preamble:
+        preamble = preamble[os.write(redir_fd, preamble):]
+    os.dup2(redir_fd, stream.fileno())
+    os.close(redir_fd)
+
+fork_count = 0
+def fork(simout="%(parent)s.f%(fork_seq)i"):
+    """Fork the simulator.
+
+    The child continues from the current state of the simulation, so
+    that a checkpoint only has to be restored, or a workload fast
+    forwarded, once to simulate several regions from it in parallel.
+    The simulated memory is shared with the parent copy-on-write. The
+    output of the child goes to a new output directory, by default
+    the output directory of the parent with ".fN" added, where N is
+    the fork sequence number.
+
+    Listeners must have been disabled, and any KVM CPU switched out.
+    Output files, e.g. the stats file, must be in the output directory,
+    and must not be compressed.
+
+    Output directory formatting dictionary:
+      parent -- Output directory of the parent.
+      fork_seq -- Fork sequence number.
+      pid -- PID of the child.
+
+    Keyword Arguments:
+      simout -- Output directory of the child.
+
+    Return Value:
+      PID of the child in the parent, 0 in the child.
+    """
+    from m5 import options
+    global fork_count
+
+    if not internal.core.listenersDisabled():
+        raise RuntimeError, "Can't fork a simulator with listeners enabled"
+
+    # Don't let the child write out what the parent has buffered
+    sys.stdout.flush()
+    sys.stderr.flush()
+    internal.core.prepareFork()
+
+    parent_outdir = options.outdir
+    stdout_size = os.fstat(sys.stdout.fileno()).st_size
+    stderr_size = os.fstat(sys.stderr.fileno()).st_size
+
+    pid = os.fork()
+    if pid != 0:
+        fork_count += 1
+        return pid
+
+    options.outdir = simout % {
+        "parent" : options.outdir,
+        "fork_seq" : fork_count,
+        "pid" : os.getpid(),
+        }
+    fork_count = 0
+
+    if not os.path.isdir(options.outdir):
+        os.makedirs(options.outdir)
+
+    if options.redirect_stdout:
+        _redirectForked(sys.stdout, parent_outdir, options.outdir,
+                        options.stdout_file, stdout_size)
+        if not options.redirect_stderr:
+            os.dup2(sys.stdout.fileno(), sys.stderr.fileno())
+
+    if options.redirect_stderr:
+        _redirectForked(sys.stderr, parent_outdir, options.outdir,
+                        options.stderr_file, stderr_size)
+
+    internal.core.forkedChild(options.outdir)
+    stats.forked()
+
+    root = objects.Root.getInstance()
+    if root:
+        for obj in root.descendants(): obj.notifyFork()
+
+    return 0
+
 from internal.core import disableAllListeners
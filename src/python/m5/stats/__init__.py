@@ -39,9 +39,21 @@ def initText(filename, desc=True):
     output = internal.stats.initText(filename, desc)
     outputList.append(output)
 
+def initBinary(filename):
+    output = internal.stats.initBinary(filename)
+    outputList.append(output)
+
 def initSimStats():
     internal.stats.initSimStats()
 
+incremental = False
+def setIncremental(enable):
+    '''Only dump the stats that changed since the previous dump, and
+    only reset the stats that changed since the previous reset. A stat
+    missing from a dump has the value it had in the dump before.'''
+    global incremental
+    incremental = enable
+
 names = []
 stats_dict = {}
 stats_list = []
@@ -84,20 +96,31 @@ def enable():
 
     internal.stats.enable();
 
-def prepare():
+def prepare(stats=None):
     '''Prepare all stats for data access.  This must be done before
     dumping and serialization.'''
 
-    for stat in stats_list:
+    if stats is None:
+        stats = stats_list
+
+    for stat in stats:
         stat.prepare()
 
+fullDumpPending = False
+def forked():
+    '''Called in a forked child, whose output files start out empty.
+    The next dump is a full one, even in incremental mode, as the
+    stats missing from it would have no earlier value.'''
+    global fullDumpPending
+    fullDumpPending = True
+
 lastDump = 0
 def dump():
     '''Dump all statistics data to the registered outputs'''
 
     curTick = m5.curTick()
 
-    global lastDump
+    global lastDump, fullDumpPending
     assert lastDump <= curTick
     if lastDump == curTick:
         return
@@ -105,15 +128,23 @@ def dump():
 
     internal.stats.processDumpQueue()
 
-    prepare()
+    if incremental and not fullDumpPending:
+        stats = [ stat for stat in stats_list if stat.changed() ]
+    else:
+        stats = stats_list
+    fullDumpPending = False
+
+    prepare(stats)
 
     for output in outputList:
         if output.valid():
             output.begin()
-            for stat in stats_list:
+            for stat in stats:
                 output.visit(stat)
             output.end()
 
+    internal.stats.markDumped()
+
 def reset():
     '''Reset all statistics to the base state'''
 
@@ -123,8 +154,11 @@ def reset():
         for obj in root.descendants(): obj.resetStats()
 
     # call any other registered stats reset callbacks
-    for stat in stats_list:
-        stat.reset()
+    if incremental:
+        internal.stats.resetChanged()
+    else:
+        for stat in stats_list:
+            stat.reset()
 
     internal.stats.processResetQueue()
 
@@ -0,0 +1,272 @@
+# Copyright (c) 2014 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""Reader for the binary statistics written by Stats::Binary
+(src/base/stats/binary.cc), e.g. with --stats-binary-file.
+
+The module does not depend on the rest of m5, so it can be used for
+post-processing outside of gem5:
+
+    from binary import Reader
+    for dump in Reader('m5out/stats.bin'):
+        print dump.tick, dump['sim_insts']
+
+or from the command line, to print the dumps as text:
+
+    python binary.py m5out/stats.bin [stat names...]
+
+File layout (all numbers little endian):
+
+    header:  'gem5stat', uint32 version
+    records: uint8 type, uint64 length, length bytes of payload
+
+A schema record (type 'S') holds a uint32 number of stats, each with:
+
+    uint8 kind, uint16 flags, int32 precision, string name,
+    string desc, uint32 number of values, followed by
+      vector, formula: a subname for each value
+      vector dist:     uint32 size, a subname for each element
+      vector 2d:       uint32 x, uint32 y, x subnames, y subnames
+
+where a string is a uint32 length followed by the characters. A dump
+record (type 'D') holds a uint64 tick, a uint32 number of values and
+the values of all stats in the order of the last schema, as doubles.
+A distribution is stored as type, min, max, bucket size, min value,
+max value, underflow, overflow, sum, sum of squares, sum of logs and
+samples followed by the buckets, and a sparse histogram as samples
+followed by (value, count) pairs.
+"""
+
+import struct
+import sys
+from array import array
+
+SCALAR, VECTOR, DIST, VECTOR_DIST, VECTOR_2D, FORMULA, SPARSE_HIST = range(7)
+KIND_NAMES = ('scalar', 'vector', 'dist', 'vector_dist', 'vector_2d',
+              'formula', 'sparse_hist')
+
+DIST_FIELDS = ('type', 'min', 'max', 'bucket_size', 'min_val', 'max_val',
+               'underflow', 'overflow', 'sum', 'squares', 'logs', 'samples')
+DIST_TYPES = ('deviation', 'dist', 'hist')
+
+class FormatError(Exception):
+    pass
+
+class _Buffer(object):
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def unpack(self, fmt):
+        values = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += struct.calcsize(fmt)
+        return values
+
+    def int(self, fmt):
+        return self.unpack(fmt)[0]
+
+    def string(self):
+        length = self.int('<I')
+        s = self.data[self.pos:self.pos + length]
+        self.pos += length
+        return s.decode('utf-8') if not isinstance(s, str) else s
+
+    def strings(self, count):
+        return [ self.string() for i in range(count) ]
+
+def _dist(values):
+    d = dict(zip(DIST_FIELDS, values[:len(DIST_FIELDS)]))
+    d['type'] = DIST_TYPES[int(d['type'])]
+    d['buckets'] = list(values[len(DIST_FIELDS):])
+    return d
+
+class Stat(object):
+    """Description of a stat, as given by a schema record."""
+
+    def __init__(self, buf):
+        self.kind, self.flags, self.precision = buf.unpack('<BHi')
+        self.name = buf.string()
+        self.desc = buf.string()
+        self.num_values = buf.int('<I')
+        self.subnames = []
+        self.y_subnames = []
+        self.x = self.y = self.size = None
+
+        if self.kind in (VECTOR, FORMULA):
+            self.subnames = buf.strings(self.num_values)
+        elif self.kind == VECTOR_DIST:
+            self.size = buf.int('<I')
+            self.subnames = buf.strings(self.size)
+        elif self.kind == VECTOR_2D:
+            self.x, self.y = buf.unpack('<II')
+            self.subnames = buf.strings(self.x)
+            self.y_subnames = buf.strings(self.y)
+        elif self.kind >= len(KIND_NAMES):
+            raise FormatError("unknown kind %d of stat %s" %
+                              (self.kind, self.name))
+
+    @property
+    def kind_name(self):
+        return KIND_NAMES[self.kind]
+
+    def decode(self, values):
+        """Turn the raw values of the stat into a float (scalars), a
+        list of floats (vectors and formulas), a list of lists (2d
+        vectors), a dict (distributions, with the buckets under
+        'buckets'), a list of dicts (vector distributions) or a dict
+        with the samples and a list of (value, count) pairs (sparse
+        histograms)."""
+
+        if self.kind == SCALAR:
+            return values[0]
+        if self.kind in (VECTOR, FORMULA):
+            return list(values)
+        if self.kind == DIST:
+            return _dist(values)
+        if self.kind == VECTOR_DIST:
+            n = len(values) // self.size if self.size else 0
+            return [ _dist(values[i * n:(i + 1) * n])
+                     for i in range(self.size) ]
+        if self.kind == VECTOR_2D:
+            return [ list(values[i * self.y:(i + 1) * self.y])
+                     for i in range(self.x) ]
+        if self.kind == SPARSE_HIST:
+            return { 'samples' : values[0],
+                     'values' : list(zip(values[1::2], values[2::2])) }
+
+    def __repr__(self):
+        return '<%s %s>' % (self.kind_name, self.name)
+
+class Dump(object):
+    """The values of all stats at one dump."""
+
+    def __init__(self, tick, schema, values):
+        self.tick = tick
+        self.schema = schema
+        self.values = values
+
+    def raw(self, name):
+        """The raw values of a stat, as an array of doubles."""
+        offset, stat = self.schema.index[name]
+        return self.values[offset:offset + stat.num_values]
+
+    def __getitem__(self, name):
+        offset, stat = self.schema.index[name]
+        return stat.decode(self.values[offset:offset + stat.num_values])
+
+    def __contains__(self, name):
+        return name in self.schema.index
+
+    def names(self):
+        return [ stat.name for stat in self.schema.stats ]
+
+    def items(self):
+        for stat in self.schema.stats:
+            yield stat.name, self[stat.name]
+
+class Schema(object):
+    def __init__(self, buf):
+        num_stats = buf.int('<I')
+        self.stats = [ Stat(buf) for i in range(num_stats) ]
+        self.index = {}
+        self.num_values = 0
+        for stat in self.stats:
+            self.index[stat.name] = (self.num_values, stat)
+            self.num_values += stat.num_values
+
+class Reader(object):
+    """Iterate over the dumps in a binary stats file."""
+
+    def __init__(self, f):
+        if isinstance(f, str):
+            f = open(f, 'rb')
+        self.file = f
+
+        magic = f.read(8)
+        if magic != b'gem5stat':
+            raise FormatError("not a gem5 binary stats file")
+        self.version, = struct.unpack('<I', f.read(4))
+        if self.version != 1:
+            raise FormatError("unsupported version %d" % self.version)
+        self.start = f.tell()
+        self.schema = None
+
+    def __iter__(self):
+        self.file.seek(self.start)
+        self.schema = None
+        while True:
+            header = self.file.read(9)
+            if not header:
+                return
+            if len(header) < 9:
+                raise FormatError("truncated record")
+
+            rtype, length = struct.unpack('<cQ', header)
+            if rtype == b'S':
+                self.schema = Schema(_Buffer(self.file.read(length)))
+            elif rtype == b'D':
+                yield self._dump(length)
+            else:
+                # skip records we do not know about
+                self.file.seek(length, 1)
+
+    def _dump(self, length):
+        if self.schema is None:
+            raise FormatError("dump before schema")
+
+        tick, count = struct.unpack('<QI', self.file.read(12))
+        if count != self.schema.num_values or length != 12 + 8 * count:
+            raise FormatError("dump does not match schema")
+
+        values = array('d')
+        data = self.file.read(8 * count)
+        if hasattr(values, 'frombytes'):
+            values.frombytes(data)
+        else:
+            values.fromstring(data)
+        if sys.byteorder == 'big':
+            values.byteswap()
+
+        return Dump(tick, self.schema, values)
+
+    def series(self, name):
+        """The (tick, value) pairs of a stat over all dumps."""
+        return [ (dump.tick, dump[name]) for dump in self
+                 if name in dump ]
+
+def main(args):
+    if not args:
+        print("usage: binary.py <stats file> [stat names...]")
+        return 2
+
+    for dump in Reader(args[0]):
+        print("---------- Dump at tick %d ----------" % dump.tick)
+        for name in (args[1:] or dump.names()):
+            print("%-40s %s" % (name, dump[name]))
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
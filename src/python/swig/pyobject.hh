@@ -53,6 +53,12 @@ serializeAll(const std::string &cpt_dir)
     Serializable::serializeAll(cpt_dir);
 }
 
+inline void
+setCheckpointFormat(const std::string &format)
+{
+    Checkpoint::setFormat(format);
+}
+
 inline Checkpoint *
 getCheckpoint(const std::string &cpt_dir)
 {
@@ -36,6 +36,7 @@
 %include <stdint.i>
 
 %{
+#include "base/stats/binary.hh"
 #include "base/stats/text.hh"
 #include "base/stats/types.hh"
 #include "base/callback.hh"
@@ -149,6 +150,7 @@ template <class T> T cast_info(Info *info);
 
 void initSimStats();
 Output *initText(const std::string &filename, bool desc);
+Output *initBinary(const std::string &filename);
 
 void schedStatEvent(bool dump, bool reset,
                     Tick when = curTick(), Tick repeat = 0);
@@ -161,6 +163,8 @@ void processResetQueue();
 void processDumpQueue();
 void enable();
 bool enabled();
+void markDumped();
+void resetChanged();
 
 std::list<Info *> &statsList();
 
@@ -33,6 +33,11 @@ from m5.defines import buildEnv
 from m5.params import *
 from m5.util import fatal
 
+# Data structure used by an event queue to keep its events sorted. The
+# sorted list has linear insertion cost, whereas the calendar queue is
+# O(1) amortized and pays off with many outstanding events.
+class EventQueueBackend(Enum): vals = ['sorted_list', 'calendar']
+
 class Root(SimObject):
 
     _the_instance = None
@@ -68,9 +73,26 @@ class Root(SimObject):
     # Simulation Quantum for multiple main event queue simulation.
     # Needs to be set explicitly for a multi-eventq simulation.
     sim_quantum = Param.Tick(0, "simulation quantum")
+    # Let a quantum last longer than sim_quantum when all event queues
+    # are idle until later. sim_quantum must still be a lower bound on
+    # the latency of events crossing queues.
+    sim_quantum_adaptive = Param.Bool(False,
+        "stretch the simulation quantum over idle periods")
+
+    # Event queue implementation, optionally overridden per main event
+    # queue (indexed by eventq_index).
+    eventq_backend = Param.EventQueueBackend('sorted_list',
+                                             "event queue implementation")
+    eventq_backends = VectorParam.EventQueueBackend([],
+        "per-queue event queue implementation, indexed by eventq_index")
 
     full_system = Param.Bool("if this is a full system simulation")
 
+    # Decode caches are shared by all CPUs; make them thread-safe so
+    # that CPUs can be simulated by different event queue threads.
+    shared_decode_cache = Param.Bool(False,
+        "share decoded instructions through a thread-safe cache")
+
     # Time syncing prevents the simulation from running faster than real time.
     time_sync_enable = Param.Bool(False, "whether time syncing is enabled")
     time_sync_period = Param.Clock("100ms", "how often to sync with real time")
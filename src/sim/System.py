@@ -35,6 +35,11 @@ from m5.proxy import *
 
 from SimpleMemory import *
 
+# Formats of the memory images in checkpoints: gzip compresses the
+# whole backing store, while sparse only stores the non-zero pages,
+# uncompressed, so that they can be mapped on restore
+class MemoryImageFormat(Enum): vals = ['gzip', 'sparse', 'chunked']
+
 class MemoryMode(Enum): vals = ['invalid', 'atomic', 'timing',
                                 'atomic_noncaching']
 
@@ -57,6 +62,10 @@ class System(MemObject):
     memories = VectorParam.AbstractMemory(Self.all,
                                           "All memories in the system")
     mem_mode = Param.MemoryMode('atomic', "The mode the memory system is in")
+    memory_image_format = Param.MemoryImageFormat('sparse',
+        "Format of the memory images written to checkpoints")
+    checkpoint_threads = Param.Unsigned(0,
+        "Threads compressing chunked memory images, 0 for one per host core")
 
     # The memory ranges are to be populated when creating the system
     # such that these can be passed from the I/O subsystem through an
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/intmath.hh"
+#include "base/misc.hh"
+#include "sim/async_event_ring.hh"
+
+AsyncEventRing::AsyncEventRing(unsigned size)
+    : mask(size - 1), slots(new Slot[size]), enqueuePos(0), dequeuePos(0),
+      overflow(NULL), overflowPending(0), _drained(0), _overflows(0),
+      _retries(0)
+{
+    if (!isPowerOf2(size))
+        fatal("Async event ring size %d is not a power of 2\n", size);
+
+    for (unsigned i = 0; i < size; ++i)
+        slots[i].seq.store(i, std::memory_order_relaxed);
+}
+
+AsyncEventRing::~AsyncEventRing()
+{
+    delete [] slots;
+}
+
+Event *
+AsyncEventRing::takeOverflow(uint64_t &count)
+{
+    Event *top = overflow.exchange(NULL, std::memory_order_acquire);
+
+    // The stack holds the most recent event first, so reverse it
+    Event *oldest = NULL;
+    count = 0;
+    while (top) {
+        Event *next = top->nextBin;
+        top->nextBin = oldest;
+        oldest = top;
+        top = next;
+        ++count;
+    }
+
+    return oldest;
+}
+
+void
+AsyncEventRing::resetCounters()
+{
+    _drained = 0;
+    _overflows.store(0);
+    _retries.store(0);
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Lock-free queue of events scheduled on an event queue by other threads
+ */
+
+#ifndef __SIM_ASYNC_EVENT_RING_HH__
+#define __SIM_ASYNC_EVENT_RING_HH__
+
+#include <atomic>
+#include <cassert>
+
+#include "base/types.hh"
+#include "sim/eventq.hh"
+
+/**
+ * Multiple-producer, single-consumer queue of the events that other
+ * threads schedule on an event queue. Producers never lock or
+ * allocate: events go into a bounded ring of slots (D. Vyukov's
+ * bounded queue), and when the ring is full they are pushed onto an
+ * intrusive lock-free stack linked through Event::nextBin, which is
+ * unused until the event is inserted into its queue.
+ *
+ * The consumer sees the events in the order they were pushed, as far
+ * as that order is defined, which is needed to keep global events in
+ * a total order. To keep the ring and the overflow stack from
+ * reordering events, producers keep using the stack as long as the
+ * consumer has not inserted everything pushed onto it, and the
+ * consumer drains the ring up to the point where it took the stack.
+ */
+class AsyncEventRing
+{
+  private:
+    struct Slot
+    {
+        /** Position this slot is ready for, see push() and pop(). */
+        std::atomic<uint64_t> seq;
+        Event *event;
+    };
+
+    const uint64_t mask;
+    Slot *slots;
+
+    /** Next position producers will claim. */
+    std::atomic<uint64_t> enqueuePos;
+
+    /** Next position the consumer will read, only used by it. */
+    uint64_t dequeuePos;
+
+    /** Events that did not fit in the ring, most recent first. */
+    std::atomic<Event *> overflow;
+
+    /** Events pushed onto the overflow stack but not yet inserted. */
+    std::atomic<uint64_t> overflowPending;
+
+    /** Number of events the consumer has taken out of the queue. */
+    Counter _drained;
+
+    /** Number of events that had to use the overflow stack. */
+    std::atomic<Counter> _overflows;
+
+    /** Number of failed attempts to claim a slot or push the stack. */
+    std::atomic<Counter> _retries;
+
+    AsyncEventRing(const AsyncEventRing &);
+    AsyncEventRing &operator=(const AsyncEventRing &);
+
+  public:
+    /** @param size Number of slots in the ring, a power of two. */
+    AsyncEventRing(unsigned size);
+    ~AsyncEventRing();
+
+    /** Add an event. Safe to call from any thread. */
+    void
+    push(Event *event)
+    {
+        if (overflowPending.load(std::memory_order_acquire) == 0) {
+            uint64_t pos = enqueuePos.load(std::memory_order_relaxed);
+            while (true) {
+                Slot &slot = slots[pos & mask];
+                uint64_t seq = slot.seq.load(std::memory_order_acquire);
+                int64_t diff = (int64_t)(seq - pos);
+
+                if (diff == 0) {
+                    if (enqueuePos.compare_exchange_weak(
+                            pos, pos + 1, std::memory_order_relaxed)) {
+                        slot.event = event;
+                        slot.seq.store(pos + 1, std::memory_order_release);
+                        return;
+                    }
+                    _retries.fetch_add(1, std::memory_order_relaxed);
+                } else if (diff < 0) {
+                    // The ring is full
+                    break;
+                } else {
+                    // Another producer claimed this slot first
+                    _retries.fetch_add(1, std::memory_order_relaxed);
+                    pos = enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        overflowPending.fetch_add(1);
+        _overflows.fetch_add(1, std::memory_order_relaxed);
+
+        Event *top = overflow.load(std::memory_order_relaxed);
+        do {
+            event->nextBin = top;
+            if (overflow.compare_exchange_weak(top, event,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed))
+                break;
+            _retries.fetch_add(1, std::memory_order_relaxed);
+        } while (true);
+    }
+
+    /**
+     * Take all events off the overflow stack, oldest first. Only the
+     * consumer may call this, and must call overflowInserted() once
+     * the events are inserted into the event queue.
+     * @param count Set to the number of events returned.
+     * @return List of events linked through Event::nextBin.
+     */
+    Event *takeOverflow(uint64_t &count);
+
+    /** Let producers go back to the ring. */
+    void
+    overflowInserted(uint64_t count)
+    {
+        _drained += count;
+        overflowPending.fetch_sub(count);
+    }
+
+    /**
+     * Position up to which pop() will return events. Only the
+     * consumer may call this.
+     */
+    uint64_t
+    end() const
+    {
+        return enqueuePos.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Remove the oldest event in the ring, waiting for producers
+     * that claimed a slot but did not yet fill it. Only the consumer
+     * may call this.
+     * @param end Position obtained from end().
+     * @return The event, or NULL if all events up to end are taken.
+     */
+    Event *
+    pop(uint64_t end)
+    {
+        if (dequeuePos == end)
+            return NULL;
+
+        Slot &slot = slots[dequeuePos & mask];
+        while (slot.seq.load(std::memory_order_acquire) != dequeuePos + 1)
+            ;
+
+        Event *event = slot.event;
+        slot.seq.store(dequeuePos + mask + 1, std::memory_order_release);
+        ++dequeuePos;
+        ++_drained;
+
+        return event;
+    }
+
+    Counter drained() const { return _drained; }
+    Counter overflows() const { return _overflows.load(); }
+    Counter retries() const { return _retries.load(); }
+
+    /** Clear the counters. Only call when no thread is pushing. */
+    void resetCounters();
+};
+
+#endif // __SIM_ASYNC_EVENT_RING_HH__
@@ -0,0 +1,379 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <fstream>
+#include <sstream>
+
+#include "base/misc.hh"
+#include "sim/binary_checkpoint.hh"
+
+using namespace std;
+
+namespace BinaryCheckpoint
+{
+
+namespace
+{
+
+const char magic[8] = { 'g', 'e', 'm', '5', 'b', 'c', 'p', 't' };
+const uint32_t version = 1;
+
+struct Header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+};
+
+struct EntryHeader
+{
+    uint8_t type;
+    uint8_t flags;
+    uint16_t nameLength;
+    uint32_t reserved;
+    uint64_t count;
+    uint64_t size;
+};
+
+struct Trailer
+{
+    uint64_t indexOffset;
+    uint64_t numSections;
+};
+
+template <class T>
+T
+load(const char *p)
+{
+    T value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+/** Check that an array of strings fills exactly size bytes. */
+bool
+validStrings(const char *p, uint64_t size, uint64_t count)
+{
+    for (uint64_t i = 0; i < count; ++i) {
+        if (size < sizeof(uint32_t))
+            return false;
+        uint64_t len = load<uint32_t>(p);
+        size -= sizeof(uint32_t);
+        if (size < len)
+            return false;
+        p += sizeof(uint32_t) + len;
+        size -= len;
+    }
+    return size == 0;
+}
+
+}
+
+const unsigned typeSizes[NumTypes] = {
+    1, 1, 2, 2, 4, 4, 8, 8, 1, sizeof(float), sizeof(double), 0
+};
+
+int
+Writer::streamIndex()
+{
+    static int index = ios_base::xalloc();
+    return index;
+}
+
+Writer::Writer(ostream &_os)
+    : os(_os), offset(0)
+{
+    Header header;
+    memcpy(header.magic, magic, sizeof(header.magic));
+    header.version = version;
+    header.reserved = 0;
+    write(&header, sizeof(header));
+
+    os.pword(streamIndex()) = this;
+}
+
+Writer::~Writer()
+{
+    os.pword(streamIndex()) = NULL;
+}
+
+void
+Writer::write(const void *data, size_t len)
+{
+    os.write((const char *)data, len);
+    offset += len;
+}
+
+void
+Writer::section(const string &name)
+{
+    sections.push_back(Section(name, offset));
+}
+
+void
+Writer::writeEntry(const string &name, Type type, uint8_t flags,
+                   uint64_t count, const void *data, uint64_t size)
+{
+    // entries before the first section go into an unnamed one
+    if (sections.empty())
+        section("");
+
+    if (name.size() > numeric_limits<uint16_t>::max())
+        panic("Checkpoint entry name '%s' is too long\n", name);
+
+    EntryHeader header;
+    header.type = type;
+    header.flags = flags;
+    header.nameLength = name.size();
+    header.reserved = 0;
+    header.count = count;
+    header.size = size;
+    write(&header, sizeof(header));
+    write(name.data(), name.size());
+    if (size)
+        write(data, size);
+
+    ++sections.back().entries;
+}
+
+void
+Writer::finish()
+{
+    Trailer trailer;
+    trailer.indexOffset = offset;
+    trailer.numSections = sections.size();
+
+    for (size_t i = 0; i < sections.size(); ++i) {
+        const Section &s = sections[i];
+        uint64_t end = i + 1 < sections.size() ?
+            sections[i + 1].offset : trailer.indexOffset;
+        uint16_t name_length = s.name.size();
+        uint64_t size = end - s.offset;
+
+        write(&name_length, sizeof(name_length));
+        write(s.name.data(), s.name.size());
+        write(&s.offset, sizeof(s.offset));
+        write(&size, sizeof(size));
+        write(&s.entries, sizeof(s.entries));
+    }
+
+    write(&trailer, sizeof(trailer));
+    os.flush();
+}
+
+void
+Entry::print(ostream &os, uint64_t i) const
+{
+    switch (type) {
+      case Int8:
+      case Int16:
+      case Int32:
+      case Int64:
+        os << value<int64_t>(i);
+        break;
+      case UInt8:
+      case UInt16:
+      case UInt32:
+      case UInt64:
+        os << value<uint64_t>(i);
+        break;
+      case Bool:
+        os << (value<bool>(i) ? "true" : "false");
+        break;
+      case Float:
+        os << value<float>(i);
+        break;
+      case Double:
+        os << value<double>(i);
+        break;
+      default:
+        panic("Can't print checkpoint entry of type %d\n", type);
+    }
+}
+
+template <>
+string
+Entry::value<string>(uint64_t i) const
+{
+    if (type != String) {
+        ostringstream os;
+        print(os, i);
+        return os.str();
+    }
+
+    const char *p = data;
+    for (uint64_t n = 0; n < i; ++n)
+        p += sizeof(uint32_t) + load<uint32_t>(p);
+    return string(p + sizeof(uint32_t), load<uint32_t>(p));
+}
+
+string
+Entry::text() const
+{
+    ostringstream os;
+    const char *p = data;
+    for (uint64_t i = 0; i < count; ++i) {
+        if (i)
+            os << " ";
+
+        if (type == String) {
+            uint32_t len = load<uint32_t>(p);
+            os.write(p + sizeof(len), len);
+            p += sizeof(len) + len;
+        } else {
+            print(os, i);
+        }
+    }
+    return os.str();
+}
+
+Reader::Reader(const string &_filename)
+    : filename(_filename)
+{
+    ifstream is(filename.c_str(), ios::binary);
+    if (!is.is_open())
+        fatal("Can't open checkpoint file '%s'\n", filename);
+
+    is.seekg(0, ios::end);
+    file.resize(is.tellg());
+    is.seekg(0, ios::beg);
+    if (!file.empty())
+        is.read(&file[0], file.size());
+    if (!is)
+        fatal("Can't read checkpoint file '%s'\n", filename);
+
+    if (file.size() < sizeof(Header) + sizeof(Trailer))
+        fatal("Checkpoint file '%s' is truncated\n", filename);
+
+    Header header = load<Header>(&file[0]);
+    if (memcmp(header.magic, magic, sizeof(header.magic)) != 0)
+        fatal("'%s' is not a binary checkpoint\n", filename);
+    if (header.version != version)
+        fatal("Binary checkpoint '%s' has version %d, expected %d\n",
+              filename, header.version, version);
+
+    Trailer trailer = load<Trailer>(&file[file.size() - sizeof(Trailer)]);
+    uint64_t index_end = file.size() - sizeof(Trailer);
+    if (trailer.indexOffset > index_end)
+        fatal("Binary checkpoint '%s' has a corrupt index\n", filename);
+
+    const char *p = &file[trailer.indexOffset];
+    const char *end = &file[0] + index_end;
+    for (uint64_t i = 0; i < trailer.numSections; ++i) {
+        if (end - p < sizeof(uint16_t))
+            fatal("Binary checkpoint '%s' has a corrupt index\n", filename);
+        uint16_t name_length = load<uint16_t>(p);
+        p += sizeof(name_length);
+        if (end - p < name_length + 3 * sizeof(uint64_t))
+            fatal("Binary checkpoint '%s' has a corrupt index\n", filename);
+
+        string name(p, name_length);
+        p += name_length;
+        uint64_t offset = load<uint64_t>(p);
+        uint64_t size = load<uint64_t>(p + sizeof(uint64_t));
+        p += 3 * sizeof(uint64_t);
+
+        if (offset < sizeof(Header) || offset > trailer.indexOffset ||
+            size > trailer.indexOffset - offset)
+            fatal("Binary checkpoint '%s' has a corrupt index\n", filename);
+
+        sections[name].parts.push_back(make_pair(offset, size));
+    }
+}
+
+void
+Reader::decode(Section &section)
+{
+    for (size_t i = 0; i < section.parts.size(); ++i) {
+        const char *p = &file[section.parts[i].first];
+        const char *end = p + section.parts[i].second;
+        while (p < end) {
+            if (end - p < sizeof(EntryHeader))
+                fatal("Binary checkpoint '%s' has a corrupt entry\n",
+                      filename);
+            EntryHeader header = load<EntryHeader>(p);
+            p += sizeof(header);
+            if (header.type >= NumTypes ||
+                end - p < header.nameLength ||
+                end - p - header.nameLength < header.size ||
+                (typeSizes[header.type] &&
+                 header.size != header.count * typeSizes[header.type]))
+                fatal("Binary checkpoint '%s' has a corrupt entry\n",
+                      filename);
+
+            string name(p, header.nameLength);
+            p += header.nameLength;
+            if (header.type == String &&
+                !validStrings(p, header.size, header.count))
+                fatal("Binary checkpoint '%s' has a corrupt entry\n",
+                      filename);
+
+            Entry &entry = section.entries[name];
+            entry.type = (Type)header.type;
+            entry.flags = header.flags;
+            entry.count = header.count;
+            entry.data = p;
+            entry.size = header.size;
+            p += header.size;
+        }
+    }
+
+    section.decoded = true;
+}
+
+const Entry *
+Reader::find(const string &section_name, const string &name)
+{
+    SectionTable::iterator s = sections.find(section_name);
+    if (s == sections.end())
+        return NULL;
+
+    Section &section = s->second;
+    if (!section.decoded)
+        decode(section);
+
+    EntryTable::const_iterator e = section.entries.find(name);
+    return e == section.entries.end() ? NULL : &e->second;
+}
+
+bool
+Reader::sectionExists(const string &section) const
+{
+    return sections.find(section) != sections.end();
+}
+
+bool
+Reader::isBinary(const string &filename)
+{
+    ifstream is(filename.c_str(), ios::binary);
+    char buf[sizeof(magic)];
+    return is.read(buf, sizeof(buf)) &&
+        memcmp(buf, magic, sizeof(magic)) == 0;
+}
+
+} // namespace BinaryCheckpoint
@@ -0,0 +1,393 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Binary, typed checkpoint format
+ */
+
+#ifndef __SIM_BINARY_CHECKPOINT_HH__
+#define __SIM_BINARY_CHECKPOINT_HH__
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/hashmap.hh"
+#include "base/types.hh"
+
+/**
+ * A binary checkpoint holds the same sections and entries as the ini
+ * file it replaces, but with every value stored in its native type,
+ * so that large arrays are written and restored without formatting
+ * and parsing text.
+ *
+ * The file starts with the eight characters "gem5bcpt", a uint32
+ * version and a uint32 of zero. The entries follow, each made of a
+ * uint8 type, a uint8 of flags (1 for arrays), the uint16 length of
+ * its name, a uint32 of zero, the uint64 number of values and the
+ * uint64 number of bytes of values, then the name and the values.
+ * Bools are stored as uint8, and strings as a uint32 length followed
+ * by the characters. The section index comes next, giving for each
+ * section the uint16 length of its name, the name, and the uint64
+ * offset, uint64 size and uint64 number of entries of the section.
+ * The file ends with the uint64 offset of the index and the uint64
+ * number of sections. Sections may appear more than once, in which
+ * case later entries replace earlier ones, as with ini files. All
+ * integers are in host byte order.
+ */
+namespace BinaryCheckpoint
+{
+
+enum Type {
+    Int8, UInt8, Int16, UInt16, Int32, UInt32, Int64, UInt64,
+    Bool, Float, Double, String, NumTypes
+};
+
+/** Size of a value of a type, 0 for strings. */
+extern const unsigned typeSizes[NumTypes];
+
+/** The type a C++ type is stored as. */
+template <class T>
+struct TypeOf
+{
+    static const Type value = std::numeric_limits<T>::is_integer ?
+        (std::numeric_limits<T>::is_signed ?
+         (sizeof(T) == 1 ? Int8 : sizeof(T) == 2 ? Int16 :
+          sizeof(T) == 4 ? Int32 : Int64) :
+         (sizeof(T) == 1 ? UInt8 : sizeof(T) == 2 ? UInt16 :
+          sizeof(T) == 4 ? UInt32 : UInt64)) :
+        (sizeof(T) == sizeof(float) ? Float : Double);
+};
+
+template <>
+struct TypeOf<bool>
+{
+    static const Type value = Bool;
+};
+
+template <>
+struct TypeOf<std::string>
+{
+    static const Type value = String;
+};
+
+/** Flags of an entry. */
+enum Flags {
+    IsArray = 1
+};
+
+/**
+ * Writes the sections and entries of a checkpoint to a stream. While
+ * it exists, the writer is attached to the stream, so that paramOut()
+ * and friends, which only see the stream, can find it with get().
+ */
+class Writer
+{
+  private:
+    struct Section
+    {
+        Section(const std::string &_name, uint64_t _offset)
+            : name(_name), offset(_offset), entries(0)
+        { }
+
+        std::string name;
+        uint64_t offset;
+        uint64_t entries;
+    };
+
+    std::ostream &os;
+
+    /** Bytes written so far. */
+    uint64_t offset;
+
+    std::vector<Section> sections;
+
+    /** Values of the entry being written. */
+    std::vector<char> buf;
+
+    Writer(const Writer &);
+    Writer &operator=(const Writer &);
+
+    /** Stream word pointing to the writer attached to a stream. */
+    static int streamIndex();
+
+    void write(const void *data, size_t len);
+
+    void writeEntry(const std::string &name, Type type, uint8_t flags,
+                    uint64_t count, const void *data, uint64_t size);
+
+    void
+    put(const std::string &value)
+    {
+        uint32_t len = value.size();
+        buf.insert(buf.end(), (const char *)&len,
+                   (const char *)&len + sizeof(len));
+        buf.insert(buf.end(), value.begin(), value.end());
+    }
+
+    void
+    put(bool value)
+    {
+        buf.push_back(value ? 1 : 0);
+    }
+
+    template <class T>
+    void
+    put(const T &value)
+    {
+        buf.insert(buf.end(), (const char *)&value,
+                   (const char *)&value + sizeof(value));
+    }
+
+  public:
+    /** Start a checkpoint and attach to the stream. */
+    Writer(std::ostream &os);
+
+    /** Detach from the stream. */
+    ~Writer();
+
+    /** @return The writer attached to a stream, or NULL. */
+    static Writer *
+    get(std::ostream &os)
+    {
+        return (Writer *)os.pword(streamIndex());
+    }
+
+    /** Start a new section, which the following entries go into. */
+    void section(const std::string &name);
+
+    template <class T>
+    void
+    scalar(const std::string &name, const T &value)
+    {
+        buf.clear();
+        put(value);
+        writeEntry(name, TypeOf<T>::value, 0, 1, &buf[0], buf.size());
+    }
+
+    /** Write an array given by a pair of iterators. */
+    template <class Iter>
+    void
+    array(const std::string &name, Iter begin, Iter end)
+    {
+        typedef typename std::iterator_traits<Iter>::value_type T;
+        buf.clear();
+        uint64_t count = 0;
+        for (Iter i = begin; i != end; ++i, ++count)
+            put((T)*i);
+        writeEntry(name, TypeOf<T>::value, IsArray, count,
+                   buf.empty() ? NULL : &buf[0], buf.size());
+    }
+
+    /** Write an array of numbers, straight from memory. */
+    template <class T>
+    void
+    array(const std::string &name, const T *values, unsigned count)
+    {
+        if (TypeOf<T>::value == Bool || TypeOf<T>::value == String) {
+            array(name, values, values + count);
+            return;
+        }
+        writeEntry(name, TypeOf<T>::value, IsArray, count, values,
+                   count * sizeof(T));
+    }
+
+    /** Write the section index and the end of the checkpoint. */
+    void finish();
+};
+
+/** An entry of a checkpoint that was read, pointing at its values. */
+struct Entry
+{
+    Type type;
+    uint8_t flags;
+    uint64_t count;
+    const char *data;
+    uint64_t size;
+
+    bool isArray() const { return flags & IsArray; }
+
+    /**
+     * @return Value i converted to a number or a bool, or to a string
+     * in the form used by text(). Strings are never converted to
+     * numbers.
+     */
+    template <class T>
+    T
+    value(uint64_t i) const
+    {
+        const char *p = data + i * typeSizes[type];
+        switch (type) {
+          case Int8: return (T)load<int8_t>(p);
+          case UInt8: return (T)load<uint8_t>(p);
+          case Int16: return (T)load<int16_t>(p);
+          case UInt16: return (T)load<uint16_t>(p);
+          case Int32: return (T)load<int32_t>(p);
+          case UInt32: return (T)load<uint32_t>(p);
+          case Int64: return (T)load<int64_t>(p);
+          case UInt64: return (T)load<uint64_t>(p);
+          case Bool: return (T)(load<uint8_t>(p) != 0);
+          case Float: return (T)load<float>(p);
+          case Double: return (T)load<double>(p);
+          default: return T();
+        }
+    }
+
+    /**
+     * @return true if value i, which must not be a string, converts
+     * to a T without changing it, which is when parsing its text form
+     * from an ini file would succeed. Numbers converted to bools must
+     * be 0 or 1, and numbers converted to integers must be whole and
+     * in range.
+     */
+    template <class T>
+    bool
+    fits(uint64_t i) const
+    {
+        const char *p = data + i * typeSizes[type];
+        switch (type) {
+          case Int8: return fitsInt<T>(load<int8_t>(p));
+          case UInt8: return fitsInt<T>(load<uint8_t>(p));
+          case Int16: return fitsInt<T>(load<int16_t>(p));
+          case UInt16: return fitsInt<T>(load<uint16_t>(p));
+          case Int32: return fitsInt<T>(load<int32_t>(p));
+          case UInt32: return fitsInt<T>(load<uint32_t>(p));
+          case Int64: return fitsInt<T>(load<int64_t>(p));
+          case UInt64: return fitsInt<T>(load<uint64_t>(p));
+          case Bool: return true;
+          case Float: return fitsFloat<T>(load<float>(p));
+          case Double: return fitsFloat<T>(load<double>(p));
+          default: return false;
+        }
+    }
+
+    /** The values as they would appear in an ini file. */
+    std::string text() const;
+
+  private:
+    template <class T, class V>
+    static bool
+    fitsInt(V v)
+    {
+        typedef std::numeric_limits<T> Limits;
+        if (TypeOf<T>::value == Bool)
+            return v == 0 || v == 1;
+        if (!Limits::is_integer)
+            return true;
+        if (std::numeric_limits<V>::is_signed && (int64_t)v < 0)
+            return Limits::is_signed && (int64_t)v >= (int64_t)Limits::min();
+        return (uint64_t)v <= (uint64_t)Limits::max();
+    }
+
+    template <class T, class V>
+    static bool
+    fitsFloat(V v)
+    {
+        typedef std::numeric_limits<T> Limits;
+        if (TypeOf<T>::value == Bool)
+            return v == 0 || v == 1;
+        if (!Limits::is_integer)
+            return true;
+        // Limits::max() + 1 is a power of two, so it is exact
+        return std::floor(v) == v && v >= (V)Limits::min() &&
+            v < (V)(Limits::max() / 2 + 1) * 2;
+    }
+
+    /** Write value i, which must not be a string, as text. */
+    void print(std::ostream &os, uint64_t i) const;
+
+    template <class T>
+    static T
+    load(const char *p)
+    {
+        T value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+};
+
+template <>
+std::string Entry::value<std::string>(uint64_t i) const;
+
+/** Numbers are never converted to strings. */
+template <>
+inline bool
+Entry::fits<std::string>(uint64_t i) const
+{
+    return false;
+}
+
+/**
+ * A checkpoint read into memory. Only the section index is decoded
+ * up front, and the entries of a section when it is first used.
+ */
+class Reader
+{
+  private:
+    typedef m5::hash_map<std::string, Entry> EntryTable;
+
+    struct Section
+    {
+        Section() : decoded(false) { }
+
+        /** Offset and size of every part of the section. */
+        std::vector<std::pair<uint64_t, uint64_t> > parts;
+
+        bool decoded;
+        EntryTable entries;
+    };
+
+    typedef m5::hash_map<std::string, Section> SectionTable;
+
+    std::string filename;
+    std::vector<char> file;
+    SectionTable sections;
+
+    void decode(Section &section);
+
+  public:
+    /** Read a checkpoint, calling fatal() if it is not valid. */
+    Reader(const std::string &filename);
+
+    /** @return The entry, or NULL if there is no such entry. */
+    const Entry *find(const std::string &section, const std::string &name);
+
+    bool sectionExists(const std::string &section) const;
+
+    /** @return true if a file starts as a binary checkpoint. */
+    static bool isBinary(const std::string &filename);
+};
+
+} // namespace BinaryCheckpoint
+
+#endif // __SIM_BINARY_CHECKPOINT_HH__
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cassert>
+
+#include "base/intmath.hh"
+#include "base/misc.hh"
+#include "sim/calendar_queue.hh"
+#include "sim/eventq.hh"
+
+using namespace std;
+
+namespace
+{
+
+/** Order bins on time and priority for std::sort. */
+bool
+binLess(const Event *l, const Event *r)
+{
+    return *l < *r;
+}
+
+}
+
+CalendarQueue::CalendarQueue()
+    : buckets(minBuckets, (Event *)NULL), bucketMask(minBuckets - 1),
+      widthBits(10), numBins(0), minBin(NULL), curBucket(0),
+      curBucketEnd((1ULL << widthBits) - 1)
+{
+}
+
+void
+CalendarQueue::setMin(Event *bin)
+{
+    minBin = bin;
+    if (bin) {
+        curBucket = bucketOf(bin->when());
+        curBucketEnd = bin->when() | ((1ULL << widthBits) - 1);
+    }
+}
+
+Event *
+CalendarQueue::findMin()
+{
+    if (numBins == 0)
+        return NULL;
+
+    // Walk the buckets from the cursor, looking for a bin that falls
+    // within the part of the current year covered by each bucket. All
+    // remaining bins are later than the cursor, so the first such bin
+    // is the earliest one.
+    const Tick width = 1ULL << widthBits;
+    unsigned bucket = curBucket;
+    Tick bucket_end = curBucketEnd;
+    for (unsigned i = 0; i < buckets.size(); ++i) {
+        Event *bin = buckets[bucket];
+        if (bin && bin->when() <= bucket_end) {
+            curBucket = bucket;
+            curBucketEnd = bucket_end;
+            return bin;
+        }
+
+        if (bucket_end > MaxTick - width)
+            break;
+
+        bucket = (bucket + 1) & bucketMask;
+        bucket_end += width;
+    }
+
+    // Nothing within a year of the cursor, so fall back to a direct
+    // search of the bucket heads.
+    Event *earliest = NULL;
+    for (unsigned i = 0; i < buckets.size(); ++i) {
+        Event *bin = buckets[i];
+        if (bin && (!earliest || *bin < *earliest))
+            earliest = bin;
+    }
+
+    assert(earliest);
+    setMin(earliest);
+    return earliest;
+}
+
+void
+CalendarQueue::insert(Event *event)
+{
+    Event **link = &buckets[bucketOf(event->when())];
+    Event *curr = *link;
+    while (curr && *curr < *event) {
+        link = &curr->nextBin;
+        curr = curr->nextBin;
+    }
+
+    bool new_bin = !curr || *event < *curr;
+    *link = Event::insertBefore(event, curr);
+
+    if (!new_bin) {
+        // The event is now the top of an existing bin
+        if (curr == minBin)
+            minBin = event;
+        return;
+    }
+
+    ++numBins;
+    if (!minBin || *event < *minBin)
+        setMin(event);
+
+    if (numBins > 2 * buckets.size())
+        resize(2 * buckets.size());
+}
+
+void
+CalendarQueue::remove(Event *event)
+{
+    Event **link = &buckets[bucketOf(event->when())];
+    Event *curr = *link;
+    while (curr && *curr < *event) {
+        link = &curr->nextBin;
+        curr = curr->nextBin;
+    }
+
+    if (!curr || *curr != *event)
+        panic("event not found!");
+
+    bool bin_empty = event == curr && !curr->nextInBin;
+    *link = Event::removeItem(event, curr);
+
+    if (!bin_empty) {
+        // The bin may have a new top
+        if (curr == minBin)
+            minBin = *link;
+        return;
+    }
+
+    --numBins;
+    if (curr == minBin)
+        minBin = findMin();
+
+    if (buckets.size() > minBuckets && numBins < buckets.size() / 2)
+        resize(buckets.size() / 2);
+}
+
+void
+CalendarQueue::collectBins(vector<Event *> &bins) const
+{
+    bins.reserve(bins.size() + numBins);
+    for (unsigned i = 0; i < buckets.size(); ++i) {
+        for (Event *bin = buckets[i]; bin; bin = bin->nextBin)
+            bins.push_back(bin);
+    }
+}
+
+void
+CalendarQueue::resize(unsigned num_buckets)
+{
+    vector<Event *> bins;
+    collectBins(bins);
+    sort(bins.begin(), bins.end(), binLess);
+    rehash(num_buckets, bins);
+}
+
+void
+CalendarQueue::rehash(unsigned num_buckets, const vector<Event *> &bins)
+{
+    // Size the buckets after the average separation of the earliest
+    // bins, as those are the ones that will be dequeued next. Three
+    // times the separation keeps a few bins per bucket while
+    // avoiding long searches through empty buckets.
+    const size_t samples = min<size_t>(bins.size(), 64);
+    Tick width = 1;
+    if (samples > 1) {
+        Tick separation = (bins[samples - 1]->when() - bins[0]->when()) /
+            (samples - 1);
+        width = separation < MaxTick / 3 ? 3 * separation : MaxTick;
+    }
+    widthBits = width > 1 ? ceilLog2(width) : 0;
+    if (widthBits > maxWidthBits)
+        widthBits = maxWidthBits;
+
+    buckets.assign(num_buckets, (Event *)NULL);
+    bucketMask = num_buckets - 1;
+    numBins = bins.size();
+
+    // Insert in reverse order so that every bin ends up at the head
+    // of its bucket without searching.
+    for (vector<Event *>::const_reverse_iterator i = bins.rbegin();
+         i != bins.rend(); ++i) {
+        Event **bucket = &buckets[bucketOf((*i)->when())];
+        (*i)->nextBin = *bucket;
+        *bucket = *i;
+    }
+
+    setMin(bins.empty() ? NULL : bins.front());
+}
+
+void
+CalendarQueue::getBins(vector<Event *> &bins) const
+{
+    bins.clear();
+    collectBins(bins);
+    sort(bins.begin(), bins.end(), binLess);
+}
+
+void
+CalendarQueue::adopt(Event *head)
+{
+    assert(empty());
+
+    vector<Event *> bins;
+    for (Event *bin = head; bin; bin = bin->nextBin)
+        bins.push_back(bin);
+
+    unsigned num_buckets = minBuckets;
+    while (bins.size() > 2 * num_buckets)
+        num_buckets *= 2;
+    rehash(num_buckets, bins);
+}
+
+Event *
+CalendarQueue::release()
+{
+    vector<Event *> bins;
+    getBins(bins);
+
+    for (size_t i = 0; i < bins.size(); ++i)
+        bins[i]->nextBin = i + 1 < bins.size() ? bins[i + 1] : NULL;
+
+    buckets.assign(buckets.size(), (Event *)NULL);
+    numBins = 0;
+    minBin = NULL;
+
+    return bins.empty() ? NULL : bins.front();
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Calendar queue used to index the bins of an EventQueue
+ */
+
+#ifndef __SIM_CALENDAR_QUEUE_HH__
+#define __SIM_CALENDAR_QUEUE_HH__
+
+#include <vector>
+
+#include "base/types.hh"
+
+class Event;
+
+/**
+ * A calendar queue (R. Brown, CACM 1988) holding the bins of an
+ * event queue. A bin is the set of events with the same time and
+ * priority, and is represented, exactly as in the sorted list used
+ * by default, by its top event with the remaining events of the bin
+ * stacked behind it through Event::nextInBin. This keeps the LIFO
+ * order within a bin identical to the sorted list.
+ *
+ * The bins are hashed on their time into a power-of-two number of
+ * buckets, each covering a power-of-two number of ticks. Every bucket
+ * is a short list of bins sorted on time and priority and chained
+ * through Event::nextBin, so insertion and removal are O(1) on
+ * average as long as the bucket width matches the spacing of the
+ * events. The number of buckets and their width are recomputed
+ * whenever the number of bins doubles or halves.
+ */
+class CalendarQueue
+{
+  private:
+    /** Buckets, each a sorted list of bins chained by nextBin. */
+    std::vector<Event *> buckets;
+
+    /** Mask to turn a bucket number into an index into buckets. */
+    unsigned bucketMask;
+
+    /** Log2 of the number of ticks covered by a bucket. */
+    unsigned widthBits;
+
+    /** Number of bins currently held. */
+    size_t numBins;
+
+    /** The earliest bin, NULL if the queue is empty. */
+    Event *minBin;
+
+    /** Bucket where the search for the next earliest bin starts. */
+    unsigned curBucket;
+
+    /** Last tick covered by curBucket in the current year. */
+    Tick curBucketEnd;
+
+    /** Smallest number of buckets the queue will shrink to. */
+    static const unsigned minBuckets = 16;
+
+    /** Upper bound on widthBits, to keep the tick arithmetic sane. */
+    static const unsigned maxWidthBits = 48;
+
+    unsigned
+    bucketOf(Tick when) const
+    {
+        return (when >> widthBits) & bucketMask;
+    }
+
+    /** Move the search cursor to the bucket holding the given bin. */
+    void setMin(Event *bin);
+
+    /** Locate the earliest bin, starting at the search cursor. */
+    Event *findMin();
+
+    /** Rehash all bins into the given number of buckets. */
+    void resize(unsigned num_buckets);
+
+    /**
+     * Rebuild the buckets from a sorted vector of bins, choosing a
+     * bucket width that suits their spacing.
+     */
+    void rehash(unsigned num_buckets, const std::vector<Event *> &bins);
+
+    /** Gather the top event of every bin, in no particular order. */
+    void collectBins(std::vector<Event *> &bins) const;
+
+    CalendarQueue(const CalendarQueue &);
+    CalendarQueue &operator=(const CalendarQueue &);
+
+  public:
+    CalendarQueue();
+
+    /** Return true if no bins are held. */
+    bool empty() const { return numBins == 0; }
+
+    /** The top event of the earliest bin. */
+    Event *head() const { return minBin; }
+
+    /**
+     * Add an event, either as the new top of the bin with the same
+     * time and priority, or as a new bin.
+     */
+    void insert(Event *event);
+
+    /** Remove an event from the bin it is in. */
+    void remove(Event *event);
+
+    /**
+     * Fill in the top event of every bin, in time and priority
+     * order.
+     */
+    void getBins(std::vector<Event *> &bins) const;
+
+    /**
+     * Take over the bins of a sorted list (as used by EventQueue by
+     * default) starting at head. The queue must be empty.
+     */
+    void adopt(Event *head);
+
+    /**
+     * Empty the calendar, handing back all bins as a sorted list
+     * chained by nextBin.
+     * @return The first bin of the list.
+     */
+    Event *release();
+};
+
+#endif // __SIM_CALENDAR_QUEUE_HH__
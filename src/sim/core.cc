@@ -31,13 +31,16 @@
  *          Steve Reinhardt
  */
 
+#include <cstdio>
 #include <iostream>
 #include <string>
 
 #include "base/callback.hh"
+#include "base/misc.hh"
 #include "base/output.hh"
 #include "sim/core.hh"
 #include "sim/eventq.hh"
+#include "sim/simulate.hh"
 
 using namespace std;
 
@@ -98,6 +101,29 @@ setOutputDir(const string &dir)
     simout.setDirectory(dir);
 }
 
+void
+prepareFork()
+{
+    if (simout.compressedFiles())
+        fatal("Can't fork the simulator with compressed output files "
+              "open\n");
+    if (simout.filesOutsideDirectory())
+        fatal("Can't fork the simulator with output files open outside "
+              "of the output directory\n");
+
+    simout.flush();
+    cout.flush();
+    cerr.flush();
+    fflush(NULL);
+}
+
+void
+forkedChild(const string &dir)
+{
+    simout.relocate(dir);
+    forgetSimThreads();
+}
+
 /**
  * Queue of C++ callbacks to invoke on simulator exit.
  */
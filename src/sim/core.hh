@@ -95,6 +95,19 @@ void setClockFrequency(Tick ticksPerSecond);
 
 void setOutputDir(const std::string &dir);
 
+/**
+ * Get ready for the simulator to fork: flush all output, so that the
+ * child doesn't inherit output the parent has buffered.
+ */
+void prepareFork();
+
+/**
+ * Called in the child after the simulator forked. Moves the output
+ * files to the given directory and forgets about the simulation
+ * threads of the parent.
+ */
+void forkedChild(const std::string &dir);
+
 class Callback;
 void registerExitCallback(Callback *callback);
 void doExitCleanup();
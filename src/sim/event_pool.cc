@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/event_pool.hh"
+#include "sim/eventq.hh"
+
+using namespace std;
+
+namespace EventPool
+{
+
+static vector<string> &
+names()
+{
+    // Types register themselves during static initialization, so
+    // avoid depending on the initialization order of a global.
+    static vector<string> _names;
+    return _names;
+}
+
+int
+registerType(const string &name)
+{
+    vector<string> &n = names();
+    for (int i = 0; i < n.size(); ++i) {
+        if (n[i] == name)
+            return i;
+    }
+
+    n.push_back(name);
+    return n.size() - 1;
+}
+
+const vector<string> &
+typeNames()
+{
+    return names();
+}
+
+void *
+allocate(int type, size_t size)
+{
+    EventQueue *q = curEventQueue();
+    if (!q)
+        return ::operator new(size);
+    return q->eventFreeLists().allocate(type, size);
+}
+
+void
+release(int type, void *p, size_t size)
+{
+    EventQueue *q = curEventQueue();
+    if (!q) {
+        ::operator delete(p);
+        return;
+    }
+    q->eventFreeLists().release(type, p, size);
+}
+
+Counter
+allocated(int type)
+{
+    Counter total = 0;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        total += mainEventQueue[i]->eventFreeLists().allocated(type);
+    return total;
+}
+
+Counter
+reused(int type)
+{
+    Counter total = 0;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        total += mainEventQueue[i]->eventFreeLists().reused(type);
+    return total;
+}
+
+} // namespace EventPool
+
+EventFreeLists::~EventFreeLists()
+{
+    for (int i = 0; i < lists.size(); ++i) {
+        while (lists[i].head) {
+            void *p = lists[i].head;
+            lists[i].head = *(void **)p;
+            ::operator delete(p);
+        }
+    }
+}
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Recycling of transient (AutoDelete) events
+ */
+
+#ifndef __SIM_EVENT_POOL_HH__
+#define __SIM_EVENT_POOL_HH__
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "base/types.hh"
+
+namespace EventPool
+{
+
+/**
+ * Register a type of pooled event.
+ * @param name Name used for the statistics of the type. Types
+ * registered under the same name share their free lists.
+ * @return Index identifying the type.
+ */
+int registerType(const std::string &name);
+
+/** Names of the registered types, indexed by type. */
+const std::vector<std::string> &typeNames();
+
+/**
+ * Allocate memory for an event of the given type from the free
+ * lists of the event queue of the running thread.
+ */
+void *allocate(int type, size_t size);
+
+/**
+ * Return the memory of an event of the given type to the free lists
+ * of the event queue of the running thread.
+ */
+void release(int type, void *p, size_t size);
+
+/** Events of a type that had to be allocated, over all queues. */
+Counter allocated(int type);
+
+/** Events of a type that were recycled, over all queues. */
+Counter reused(int type);
+
+} // namespace EventPool
+
+/**
+ * Per event queue free lists of event memory, one per type of pooled
+ * event. Every block is allocated on its own with ::operator new, so
+ * that events may be freed on a different queue (or outside of any
+ * queue) than the one they were allocated on. Each queue is only
+ * used by the thread running it, so no locking is needed.
+ */
+class EventFreeLists
+{
+  private:
+    struct FreeList
+    {
+        FreeList() : head(NULL), size(0), allocated(0), reused(0) { }
+
+        /** Free blocks, linked through their first word. */
+        void *head;
+
+        /** Size of the blocks on the list, 0 until first used. */
+        size_t size;
+
+        Counter allocated;
+        Counter reused;
+    };
+
+    std::vector<FreeList> lists;
+
+    FreeList &
+    list(int type)
+    {
+        if (type >= lists.size())
+            lists.resize(type + 1);
+        return lists[type];
+    }
+
+    EventFreeLists(const EventFreeLists &);
+    EventFreeLists &operator=(const EventFreeLists &);
+
+  public:
+    EventFreeLists() { }
+    ~EventFreeLists();
+
+    void *
+    allocate(int type, size_t size)
+    {
+        FreeList &l = list(type);
+        if (l.head && l.size == size) {
+            void *p = l.head;
+            l.head = *(void **)p;
+            ++l.reused;
+            return p;
+        }
+
+        if (!l.size)
+            l.size = size;
+        ++l.allocated;
+        return ::operator new(size);
+    }
+
+    void
+    release(int type, void *p, size_t size)
+    {
+        FreeList &l = list(type);
+        if (!l.size)
+            l.size = size;
+
+        if (l.size != size) {
+            // Derived from a pooled type, but of a different size
+            ::operator delete(p);
+            return;
+        }
+
+        *(void **)p = l.head;
+        l.head = p;
+    }
+
+    Counter
+    allocated(int type) const
+    {
+        return type < lists.size() ? lists[type].allocated : 0;
+    }
+
+    Counter
+    reused(int type) const
+    {
+        return type < lists.size() ? lists[type].reused : 0;
+    }
+};
+
+/**
+ * Mix-in that makes an event class recycle its memory through the
+ * free lists of the event queues, for events that are created and
+ * AutoDelete'd at a high rate. The event class T must provide a
+ * static poolName() giving the name its statistics are reported
+ * under, e.g.:
+ *
+ * class MyEvent : public Event, public PooledEvent<MyEvent>
+ * {
+ *   public:
+ *     static const char *poolName() { return "my_event"; }
+ *     ...
+ * };
+ */
+template <class T>
+class PooledEvent
+{
+  private:
+    static const int poolType;
+
+  public:
+    static void *
+    operator new(size_t size)
+    {
+        return EventPool::allocate(poolType, size);
+    }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        EventPool::release(poolType, p, size);
+    }
+};
+
+template <class T>
+const int PooledEvent<T>::poolType = EventPool::registerType(T::poolName());
+
+#endif // __SIM_EVENT_POOL_HH__
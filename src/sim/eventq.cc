@@ -42,12 +42,15 @@
 #include "base/trace.hh"
 #include "cpu/smt.hh"
 #include "debug/Config.hh"
+#include "sim/async_event_ring.hh"
+#include "sim/calendar_queue.hh"
 #include "sim/core.hh"
 #include "sim/eventq_impl.hh"
 
 using namespace std;
 
 Tick simQuantum = 0;
+bool simQuantumAdaptive = false;
 
 //
 // Main Event Queues
@@ -60,13 +63,25 @@ vector<EventQueue *> mainEventQueue;
 __thread EventQueue *_curEventQueue = NULL;
 bool inParallelMode = false;
 
+EventQueue::Backend defaultEventQueueBackend = EventQueue::SortedList;
+vector<EventQueue::Backend> mainEventQueueBackends;
+
+EventQueue::Backend
+mainEventQueueBackend(uint32_t index)
+{
+    if (index < mainEventQueueBackends.size())
+        return mainEventQueueBackends[index];
+    return defaultEventQueueBackend;
+}
+
 EventQueue *
 getEventQueue(uint32_t index)
 {
     while (numMainEventQueues <= index) {
-        numMainEventQueues++;
         mainEventQueue.push_back(
-            new EventQueue(csprintf("MainEventQueue-%d", index)));
+            new EventQueue(csprintf("MainEventQueue-%d", numMainEventQueues),
+                           mainEventQueueBackend(numMainEventQueues)));
+        numMainEventQueues++;
     }
 
     return mainEventQueue[index];
@@ -117,6 +132,12 @@ Event::insertBefore(Event *event, Event *curr)
 void
 EventQueue::insert(Event *event)
 {
+    if (calendar) {
+        calendar->insert(event);
+        head = calendar->head();
+        return;
+    }
+
     // Deal with the head case
     if (!head || *event <= *head) {
         head = Event::insertBefore(event, head);
@@ -176,6 +197,12 @@ EventQueue::remove(Event *event)
 
     assert(event->queue == this);
 
+    if (calendar) {
+        calendar->remove(event);
+        head = calendar->head();
+        return;
+    }
+
     // deal with an event on the head's 'in bin' list (event has the same
     // time as the head)
     if (*head == *event) {
@@ -207,7 +234,10 @@ EventQueue::serviceOne()
     Event *next = head->nextInBin;
     event->flags.clear(Event::Scheduled);
 
-    if (next) {
+    if (calendar) {
+        calendar->remove(event);
+        head = calendar->head();
+    } else if (next) {
         // update the next bin pointer since it could be stale
         next->nextBin = head->nextBin;
 
@@ -292,11 +322,12 @@ void
 EventQueue::serialize(ostream &os)
 {
     std::list<Event *> eventPtrs;
+    std::vector<Event *> bins;
+    getBins(bins);
 
     int numEvents = 0;
-    Event *nextBin = head;
-    while (nextBin) {
-        Event *nextInBin = nextBin;
+    for (size_t i = 0; i < bins.size(); ++i) {
+        Event *nextInBin = bins[i];
 
         while (nextInBin) {
             if (nextInBin->flags.isSet(Event::AutoSerialize)) {
@@ -306,8 +337,6 @@ EventQueue::serialize(ostream &os)
             }
             nextInBin = nextInBin->nextInBin;
         }
-
-        nextBin = nextBin->nextBin;
     }
 
     SERIALIZE_SCALAR(numEvents);
@@ -345,15 +374,14 @@ EventQueue::dump() const
     if (empty())
         cprintf("<No Events>\n");
     else {
-        Event *nextBin = head;
-        while (nextBin) {
-            Event *nextInBin = nextBin;
+        std::vector<Event *> bins;
+        getBins(bins);
+        for (size_t i = 0; i < bins.size(); ++i) {
+            Event *nextInBin = bins[i];
             while (nextInBin) {
                 nextInBin->dump();
                 nextInBin = nextInBin->nextInBin;
             }
-
-            nextBin = nextBin->nextBin;
         }
     }
 
@@ -368,9 +396,15 @@ EventQueue::debugVerify() const
     Tick time = 0;
     short priority = 0;
 
-    Event *nextBin = head;
-    while (nextBin) {
-        Event *nextInBin = nextBin;
+    if (calendar && head != calendar->head()) {
+        cprintf("head is not the earliest bin!");
+        return false;
+    }
+
+    std::vector<Event *> bins;
+    getBins(bins);
+    for (size_t i = 0; i < bins.size(); ++i) {
+        Event *nextInBin = bins[i];
         while (nextInBin) {
             if (nextInBin->when() < time) {
                 cprintf("time goes backwards!");
@@ -395,21 +429,65 @@ EventQueue::debugVerify() const
 
             nextInBin = nextInBin->nextInBin;
         }
-
-        nextBin = nextBin->nextBin;
     }
 
     return true;
 }
 
+void
+EventQueue::getBins(std::vector<Event *> &bins) const
+{
+    if (calendar) {
+        calendar->getBins(bins);
+        return;
+    }
+
+    bins.clear();
+    for (Event *nextBin = head; nextBin; nextBin = nextBin->nextBin)
+        bins.push_back(nextBin);
+}
+
 Event*
 EventQueue::replaceHead(Event* s)
 {
+    if (calendar) {
+        // Hand out the bins as a sorted list, so that the caller can
+        // treat the result the same way regardless of the backend.
+        Event *t = calendar->release();
+        calendar->adopt(s);
+        head = calendar->head();
+        return t;
+    }
+
     Event* t = head;
     head = s;
     return t;
 }
 
+void
+EventQueue::setBackend(Backend backend)
+{
+    if (backend == this->backend())
+        return;
+
+    switch (backend) {
+      case SortedList:
+        head = calendar->release();
+        delete calendar;
+        calendar = NULL;
+        break;
+
+      case Calendar:
+        calendar = new CalendarQueue();
+        calendar->adopt(head);
+        head = calendar->head();
+        break;
+
+      default:
+        panic("Unknown event queue backend %d\n", backend);
+    }
+}
+
 void
 dumpMainQueue()
 {
@@ -458,30 +536,76 @@ Event::dump() const
     }
 }
 
-EventQueue::EventQueue(const string &n)
-    : objName(n), head(NULL), _curTick(0),
-    async_queue_mutex(new std::mutex())
+//! Number of slots in the lock-free ring of each event queue. Events
+//! scheduled from other threads beyond this number within a quantum
+//! spill over into a slower (but still lock-free) stack.
+static const unsigned asyncRingSize = 4096;
+
+EventQueue::EventQueue(const string &n, Backend backend)
+    : objName(n), head(NULL), _curTick(0), calendar(NULL),
+    asyncRing(new AsyncEventRing(asyncRingSize)),
+    freeLists(new EventFreeLists()), asyncSent(MaxTick)
+{
+    setBackend(backend);
+}
+
+EventQueue::~EventQueue()
 {
+    delete calendar;
+    delete asyncRing;
+    delete freeLists;
 }
 
 void
 EventQueue::asyncInsert(Event *event)
 {
-    async_queue_mutex->lock();
-    async_queue.push_back(event);
-    async_queue_mutex->unlock();
+    asyncRing->push(event);
 }
 
 void
 EventQueue::handleAsyncInsertions()
 {
     assert(this == curEventQueue());
-    async_queue_mutex->lock();
 
-    while (!async_queue.empty()) {
-        insert(async_queue.front());
-        async_queue.pop_front();
+    // Take the overflow events before draining the ring, so that
+    // everything that was added to the ring ahead of them is
+    // inserted first.
+    uint64_t num_overflow;
+    Event *overflow = asyncRing->takeOverflow(num_overflow);
+
+    uint64_t end = asyncRing->end();
+    while (Event *event = asyncRing->pop(end))
+        insert(event);
+
+    while (overflow) {
+        Event *next = overflow->nextBin;
+        insert(overflow);
+        overflow = next;
     }
 
-    async_queue_mutex->unlock();
+    asyncRing->overflowInserted(num_overflow);
+}
+
+Counter
+EventQueue::asyncInsertions() const
+{
+    return asyncRing->drained();
+}
+
+Counter
+EventQueue::asyncOverflows() const
+{
+    return asyncRing->overflows();
+}
+
+Counter
+EventQueue::asyncRetries() const
+{
+    return asyncRing->retries();
+}
+
+void
+EventQueue::resetAsyncCounters()
+{
+    asyncRing->resetCounters();
 }
@@ -44,15 +44,19 @@
 #include <iosfwd>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "base/flags.hh"
 #include "base/misc.hh"
 #include "base/types.hh"
 #include "debug/Event.hh"
+#include "sim/event_pool.hh"
 #include "sim/serialize.hh"
 
 class EventQueue;       // forward declaration
+class AsyncEventRing;
 class BaseGlobalEvent;
+class CalendarQueue;
 
 //! Simulation Quantum for multiple eventq simulation.
 //! The quantum value is the period length after which the queues
@@ -61,6 +65,13 @@ class BaseGlobalEvent;
 //! Queue B should be at least simQuantum ticks away in future.
 extern Tick simQuantum;
 
+//! Stretch the simulation quantum over periods in which none of the
+//! queues have events. No queue can send events to another before it
+//! processes its next event, so a quantum can end simQuantum ticks
+//! after the earliest next event of all queues rather than simQuantum
+//! ticks after it starts.
+extern bool simQuantumAdaptive;
+
 //! Current number of allocated main event queues.
 extern uint32_t numMainEventQueues;
 
@@ -177,7 +188,9 @@ class EventBase
  */
 class Event : public EventBase, public Serializable
 {
+    friend class AsyncEventRing;
     friend class EventQueue;
+    friend class CalendarQueue;
 
   private:
     // The event queue is now a linked list of linked lists.  The
@@ -403,16 +416,32 @@ operator!=(const Event &l, const Event &r)
  */
 class EventQueue : public Serializable
 {
+  public:
+    /** Data structures available for keeping the bins sorted. */
+    enum Backend {
+        SortedList,     //!< linked list of bins, linear insertion
+        Calendar        //!< calendar queue, O(1) amortized insertion
+    };
+
   private:
     std::string objName;
     Event *head;
     Tick _curTick;
 
-    //! Mutex to protect async queue.
-    std::mutex *async_queue_mutex;
+    //! Calendar queue indexing the bins when using the Calendar
+    //! backend, NULL when the bins are kept in a sorted list. In
+    //! both cases head points to the earliest bin.
+    CalendarQueue *calendar;
 
-    //! List of events added by other threads to this event queue.
-    std::list<Event*> async_queue;
+    //! Events added by other threads to this event queue.
+    AsyncEventRing *asyncRing;
+
+    //! Recycled memory of pooled events freed by this queue's thread.
+    EventFreeLists *freeLists;
+
+    //! Earliest event this queue's thread scheduled through the async
+    //! queue of any queue since resetAsyncSent(), MaxTick if none.
+    Tick asyncSent;
 
     //! Insert / remove event from the queue. Should only be called
     //! by thread operating this queue.
@@ -424,14 +453,23 @@ class EventQueue : public Serializable
     //! owning thread, should call this function instead of insert().
     void asyncInsert(Event *event);
 
+    //! Fill in the top event of every bin in time and priority order.
+    void getBins(std::vector<Event *> &bins) const;
+
     EventQueue(const EventQueue &);
 
   public:
-    EventQueue(const std::string &n);
+    EventQueue(const std::string &n, Backend backend = SortedList);
+    ~EventQueue();
 
     virtual const std::string name() const { return objName; }
     void name(const std::string &st) { objName = st; }
 
+    //! Switch the data structure used to keep the bins sorted. Any
+    //! scheduled events are moved over with their order preserved.
+    void setBackend(Backend backend);
+    Backend backend() const { return calendar ? Calendar : SortedList; }
+
     //! Schedule the given event on this queue. Safe to call from any
     //! thread.
     void schedule(Event *event, Tick when, bool global = false);
@@ -478,9 +516,28 @@ class EventQueue : public Serializable
 
     bool debugVerify() const;
 
-    //! Function for moving events from the async_queue to the main queue.
+    //! Function for moving events from the async queue to the main queue.
     void handleAsyncInsertions();
 
+    //! Earliest event this queue's thread has scheduled through an
+    //! async queue since the last resetAsyncSent(), or MaxTick. It
+    //! may not be inserted yet, so it is not in nextTick().
+    Tick earliestAsyncSent() const { return asyncSent; }
+    void resetAsyncSent() { asyncSent = MaxTick; }
+
+    //! Number of events inserted from the async queue.
+    Counter asyncInsertions() const;
+    //! Number of async events that did not fit in the lock-free ring.
+    Counter asyncOverflows() const;
+    //! Number of times threads adding async events contended.
+    Counter asyncRetries() const;
+    //! Clear the async queue counters.
+    void resetAsyncCounters();
+
+    //! Free lists used for pooled events by the thread running this
+    //! queue.
+    EventFreeLists &eventFreeLists() { return *freeLists; }
+
     /**
      *  function for replacing the head of the event queue, so that a
      *  different set of events can run without disturbing events that have
@@ -499,6 +556,19 @@ class EventQueue : public Serializable
 
 void dumpMainQueue();
 
+#ifndef SWIG
+//! Backend used by main event queues that have no entry in
+//! mainEventQueueBackends. Set from Root.
+extern EventQueue::Backend defaultEventQueueBackend;
+
+//! Per-queue backend of the main event queues, indexed by queue
+//! index. Set from Root.
+extern std::vector<EventQueue::Backend> mainEventQueueBackends;
+
+//! Backend that the main event queue with the given index uses.
+EventQueue::Backend mainEventQueueBackend(uint32_t index);
+#endif
+
 #ifndef SWIG
 class EventManager
 {
@@ -560,7 +630,7 @@ template <class T, void (T::* F)()>
 void
 DelayFunction(EventQueue *eventq, Tick when, T *object)
 {
-    class DelayEvent : public Event
+    class DelayEvent : public Event, public PooledEvent<DelayEvent>
     {
       private:
         T *object;
@@ -571,18 +641,22 @@ DelayFunction(EventQueue *eventq, Tick when, T *object)
         { }
         void process() { (object->*F)(); }
         const char *description() const { return "delay"; }
+        static const char *poolName() { return "delay"; }
     };
 
     eventq->schedule(new DelayEvent(object), when);
 }
 
 template <class T, void (T::* F)()>
-class EventWrapper : public Event
+class EventWrapper : public Event,
+                     public PooledEvent<EventWrapper<T, F> >
 {
   private:
     T *object;
 
   public:
+    static const char *poolName() { return "wrapped_event"; }
+
     EventWrapper(T *obj, bool del = false, Priority p = Default_Pri)
         : Event(p), object(obj)
     {
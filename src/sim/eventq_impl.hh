@@ -47,6 +47,10 @@ EventQueue::schedule(Event *event, Tick when, bool global)
 
     event->setWhen(when, this);
 
+    // Mark the event as scheduled before it is handed to another
+    // thread through the asyncq, which may insert it right away.
+    event->flags.set(Event::Scheduled);
+
     // The check below is to make sure of two things
     // a. a thread schedules local events on other queues through the asyncq
     // b. a thread schedules global events on the asyncq, whether or not
@@ -54,11 +58,13 @@ EventQueue::schedule(Event *event, Tick when, bool global)
     //    a total order amongst the global events. See global_event.{cc,hh}
     //    for more explanation.
     if (inParallelMode && (this != curEventQueue() || global)) {
+        EventQueue *sender = curEventQueue();
+        if (when < sender->asyncSent)
+            sender->asyncSent = when;
         asyncInsert(event);
     } else {
         insert(event);
     }
-    event->flags.set(Event::Scheduled);
 
     if (DTRACE(Event))
         event->trace("scheduled");
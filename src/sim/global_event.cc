@@ -148,6 +148,7 @@ GlobalSyncEvent::BarrierEvent::process()
     // second barrier to force all queues to wait for event processing
     // to finish before continuing
     globalBarrier();
+    curEventQueue()->resetAsyncSent();
     curEventQueue()->handleAsyncInsertions();
 }
 
@@ -155,7 +156,30 @@ void
 GlobalSyncEvent::process()
 {
     if (repeat) {
-        schedule(curTick() + repeat);
+        Tick next = curTick() + repeat;
+
+        if (simQuantumAdaptive) {
+            // Nothing can be sent between queues before the earliest
+            // event on any of them, so the quantum can run until a
+            // full repeat period after it. All the other queues are
+            // waiting at the barrier, so their state can be read
+            // here. Events they sent each other are still in the
+            // async queues, but each sender keeps the earliest one.
+            Tick earliest = MaxTick;
+            for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+                EventQueue *q = mainEventQueue[i];
+                if (!q->empty())
+                    earliest = std::min(earliest, q->nextTick());
+                earliest = std::min(earliest, q->earliestAsyncSent());
+            }
+
+            if (earliest > MaxTick - repeat)
+                next = MaxTick;
+            else
+                next = std::max(next, earliest + repeat);
+        }
+
+        schedule(next);
     }
 }
 
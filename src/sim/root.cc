@@ -34,6 +34,9 @@
 #include "base/misc.hh"
 #include "base/trace.hh"
 #include "config/the_isa.hh"
+#if THE_ISA != NULL_ISA
+#include "cpu/decode_cache.hh"
+#endif
 #include "debug/TimeSync.hh"
 #include "sim/full_system.hh"
 #include "sim/root.hh"
@@ -114,6 +117,36 @@ Root::Root(RootParams *p) : SimObject(p), _enabled(false),
     lastTime.setTimer();
 
     simQuantum = p->sim_quantum;
+    simQuantumAdaptive = p->sim_quantum_adaptive;
+
+    defaultEventQueueBackend = eventQueueBackend(p->eventq_backend);
+    mainEventQueueBackends.clear();
+    for (size_t i = 0; i < p->eventq_backends.size(); ++i)
+        mainEventQueueBackends.push_back(
+            eventQueueBackend(p->eventq_backends[i]));
+
+#if THE_ISA != NULL_ISA
+    DecodeCache::shared = p->shared_decode_cache;
+#endif
+
+    // Queues created before Root (e.g., by Python) still use the
+    // default, so convert them now. Later ones pick up their backend
+    // when created.
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        mainEventQueue[i]->setBackend(mainEventQueueBackend(i));
+}
+
+EventQueue::Backend
+Root::eventQueueBackend(Enums::EventQueueBackend backend)
+{
+    switch (backend) {
+      case Enums::sorted_list:
+        return EventQueue::SortedList;
+      case Enums::calendar:
+        return EventQueue::Calendar;
+      default:
+        fatal("Unknown event queue backend %d\n", backend);
+    }
 }
 
 void
@@ -63,6 +63,10 @@ class Root : public SimObject
     EventWrapper<Root, &Root::timeSync> syncEvent;
     friend class EventWrapper<Root, &Root::timeSync>;
 
+    /** Map the configured backend onto the one used by EventQueue. */
+    static EventQueue::Backend
+    eventQueueBackend(Enums::EventQueueBackend backend);
+
   public:
     /**
      * Use this function to get a pointer to the single Root object in the
@@ -47,6 +47,7 @@
 #include "base/output.hh"
 #include "base/str.hh"
 #include "base/trace.hh"
+#include "sim/binary_checkpoint.hh"
 #include "sim/eventq.hh"
 #include "sim/serialize.hh"
 #include "sim/sim_events.hh"
@@ -163,6 +164,99 @@ parseParam(const string &s, string &value)
     return true;
 }
 
+//
+// Entries of binary checkpoints holding numbers are converted
+// straight to the type asked for, while anything else goes through
+// the same text form as ini files.
+//
+template <class T>
+bool
+numericEntry(const BinaryCheckpoint::Entry &entry)
+{
+    return entry.type != BinaryCheckpoint::String &&
+        BinaryCheckpoint::TypeOf<T>::value != BinaryCheckpoint::String;
+}
+
+// Values that do not fit the type asked for are rejected, as
+// to_number() rejects them when parsing an ini file
+template <class T>
+void
+checkNumbers(const BinaryCheckpoint::Entry &entry, const string &section,
+             const string &name)
+{
+    if (entry.type == BinaryCheckpoint::TypeOf<T>::value)
+        return;
+
+    for (uint64_t i = 0; i < entry.count; ++i) {
+        if (!entry.fits<T>(i))
+            fatal("Can't unserialize '%s:%s', value %d is out of range\n",
+                  section, name, i);
+    }
+}
+
+template <class T>
+void
+copyNumbers(const BinaryCheckpoint::Entry &entry, T *values)
+{
+    if (entry.type == BinaryCheckpoint::TypeOf<T>::value &&
+        entry.type != BinaryCheckpoint::Bool) {
+        memcpy(values, entry.data, entry.size);
+        return;
+    }
+
+    for (uint64_t i = 0; i < entry.count; ++i)
+        values[i] = entry.value<T>(i);
+}
+
+template <class T>
+void
+copyNumbers(const BinaryCheckpoint::Entry &entry, vector<T> &values)
+{
+    values.resize(entry.count);
+    if (!values.empty())
+        copyNumbers(entry, &values[0]);
+}
+
+void
+copyNumbers(const BinaryCheckpoint::Entry &entry, vector<bool> &values)
+{
+    values.resize(entry.count);
+    for (uint64_t i = 0; i < entry.count; ++i)
+        values[i] = entry.value<bool>(i);
+}
+
+template <class T>
+void
+writeArray(BinaryCheckpoint::Writer *writer, const string &name,
+           const vector<T> &values)
+{
+    writer->array(name, values.empty() ? NULL : &values[0], values.size());
+}
+
+void
+writeArray(BinaryCheckpoint::Writer *writer, const string &name,
+           const vector<bool> &values)
+{
+    writer->array(name, values.begin(), values.end());
+}
+
+template <class T>
+bool
+findParam(Checkpoint *cp, const string &section, const string &name,
+          T &param)
+{
+    const BinaryCheckpoint::Entry *entry = cp->findEntry(section, name);
+    if (entry && entry->count == 1 && numericEntry<T>(*entry)) {
+        if (!entry->fits<T>(0))
+            return false;
+        param = entry->value<T>(0);
+        return true;
+    }
+
+    string str;
+    return cp->find(section, name, str) && parseParam(str, param);
+}
+
 int Serializable::ckptMaxCount = 0;
 int Serializable::ckptCount = 0;
 int Serializable::ckptPrevCount = -1;
@@ -170,19 +264,29 @@ int Serializable::ckptPrevCount = -1;
 void
 Serializable::nameOut(ostream &os)
 {
-    os << "\n[" << name() << "]\n";
+    nameOut(os, name());
 }
 
 void
 Serializable::nameOut(ostream &os, const string &_name)
 {
-    os << "\n[" << _name << "]\n";
+    BinaryCheckpoint::Writer *writer = BinaryCheckpoint::Writer::get(os);
+    if (writer)
+        writer->section(_name);
+    else
+        os << "\n[" << _name << "]\n";
 }
 
 template <class T>
 void
 paramOut(ostream &os, const string &name, const T &param)
 {
+    BinaryCheckpoint::Writer *writer = BinaryCheckpoint::Writer::get(os);
+    if (writer) {
+        writer->scalar(name, param);
+        return;
+    }
+
     os << name << "=";
     showParam(os, param);
     os << "\n";
@@ -192,6 +296,12 @@ template <class T>
 void
 arrayParamOut(ostream &os, const string &name, const vector<T> &param)
 {
+    BinaryCheckpoint::Writer *writer = BinaryCheckpoint::Writer::get(os);
+    if (writer) {
+        writeArray(writer, name, param);
+        return;
+    }
+
     typename vector<T>::size_type size = param.size();
     os << name << "=";
     if (size > 0)
@@ -207,6 +317,12 @@ template <class T>
 void
 arrayParamOut(ostream &os, const string &name, const list<T> &param)
 {
+    BinaryCheckpoint::Writer *writer = BinaryCheckpoint::Writer::get(os);
+    if (writer) {
+        writer->array(name, param.begin(), param.end());
+        return;
+    }
+
     typename list<T>::const_iterator it = param.begin();
 
     os << name << "=";
@@ -225,8 +341,7 @@ template <class T>
 void
 paramIn(Checkpoint *cp, const string &section, const string &name, T &param)
 {
-    string str;
-    if (!cp->find(section, name, str) || !parseParam(str, param)) {
+    if (!findParam(cp, section, name, param)) {
         fatal("Can't unserialize '%s:%s'\n", section, name);
     }
 }
@@ -235,8 +350,7 @@ template <class T>
 bool
 optParamIn(Checkpoint *cp, const string &section, const string &name, T &param)
 {
-    string str;
-    if (!cp->find(section, name, str) || !parseParam(str, param)) {
+    if (!findParam(cp, section, name, param)) {
         warn("optional parameter %s:%s not present\n", section, name);
         return false;
     } else {
@@ -248,6 +362,12 @@ template <class T>
 void
 arrayParamOut(ostream &os, const string &name, const T *param, unsigned size)
 {
+    BinaryCheckpoint::Writer *writer = BinaryCheckpoint::Writer::get(os);
+    if (writer) {
+        writer->array(name, param, size);
+        return;
+    }
+
     os << name << "=";
     if (size > 0)
         showParam(os, param[0]);
@@ -264,6 +384,15 @@ void
 arrayParamIn(Checkpoint *cp, const string &section, const string &name,
              T *param, unsigned size)
 {
+    const BinaryCheckpoint::Entry *entry = cp->findEntry(section, name);
+    if (entry && numericEntry<T>(*entry)) {
+        if (entry->count != size)
+            fatal("Array size mismatch on %s:%s'\n", section, name);
+        checkNumbers<T>(*entry, section, name);
+        copyNumbers(*entry, param);
+        return;
+    }
+
     string str;
     if (!cp->find(section, name, str)) {
         fatal("Can't unserialize '%s:%s'\n", section, name);
@@ -288,7 +417,7 @@ arrayParamIn(Checkpoint *cp, const string &section, const string &name,
         // for which operator[] returns a special reference class
         // that's not the same as 'bool&', (since it's a packed
         // vector)
-        T scalar_value = 0;
+        T scalar_value = T();
         if (!parseParam(tokens[i], scalar_value)) {
             string err("could not parse \"");
 
@@ -308,6 +437,13 @@ void
 arrayParamIn(Checkpoint *cp, const string &section,
              const string &name, vector<T> &param)
 {
+    const BinaryCheckpoint::Entry *entry = cp->findEntry(section, name);
+    if (entry && numericEntry<T>(*entry)) {
+        checkNumbers<T>(*entry, section, name);
+        copyNumbers(*entry, param);
+        return;
+    }
+
     string str;
     if (!cp->find(section, name, str)) {
         fatal("Can't unserialize '%s:%s'\n", section, name);
@@ -330,7 +466,7 @@ arrayParamIn(Checkpoint *cp, const string &section,
         // for which operator[] returns a special reference class
         // that's not the same as 'bool&', (since it's a packed
         // vector)
-        T scalar_value = 0;
+        T scalar_value = T();
         if (!parseParam(tokens[i], scalar_value)) {
             string err("could not parse \"");
 
@@ -350,6 +486,15 @@ void
 arrayParamIn(Checkpoint *cp, const string &section,
              const string &name, list<T> &param)
 {
+    const BinaryCheckpoint::Entry *entry = cp->findEntry(section, name);
+    if (entry && numericEntry<T>(*entry)) {
+        checkNumbers<T>(*entry, section, name);
+        param.clear();
+        for (uint64_t i = 0; i < entry->count; ++i)
+            param.push_back(entry->value<T>(i));
+        return;
+    }
+
     string str;
     if (!cp->find(section, name, str)) {
         fatal("Can't unserialize '%s:%s'\n", section, name);
@@ -360,7 +505,7 @@ arrayParamIn(Checkpoint *cp, const string &section,
     tokenize(tokens, str, ' ');
 
     for (vector<string>::size_type i = 0; i < tokens.size(); i++) {
-        T scalar_value = 0;
+        T scalar_value = T();
         if (!parseParam(tokens[i], scalar_value)) {
             string err("could not parse \"");
 
@@ -505,14 +650,26 @@ Serializable::serializeAll(const string &cpt_dir)
             fatal("couldn't mkdir %s\n", dir);
 
     string cpt_file = dir + Checkpoint::baseFilename;
-    ofstream outstream(cpt_file.c_str());
-    time_t t = time(NULL);
+    ofstream outstream(cpt_file.c_str(), ios::binary);
     if (!outstream.is_open())
         fatal("Unable to open file %s for writing\n", cpt_file.c_str());
-    outstream << "## checkpoint generated: " << ctime(&t);
 
+    if (!Checkpoint::writeBinary()) {
+        time_t t = time(NULL);
+        outstream << "## checkpoint generated: " << ctime(&t);
+
+        globals.serialize(outstream);
+        SimObject::serializeAll(outstream);
+        return;
+    }
+
+    BinaryCheckpoint::Writer writer(outstream);
     globals.serialize(outstream);
     SimObject::serializeAll(outstream);
+    writer.finish();
+
+    if (!outstream)
+        fatal("Write failed on checkpoint file %s\n", cpt_file.c_str());
 }
 
 void
@@ -593,6 +750,18 @@ Serializable::create(Checkpoint *cp, const string &section)
 const char *Checkpoint::baseFilename = "m5.cpt";
 
 string Checkpoint::currentDirectory;
+bool Checkpoint::binaryFormat = true;
+
+void
+Checkpoint::setFormat(const string &format)
+{
+    if (format == "binary")
+        binaryFormat = true;
+    else if (format == "ini")
+        binaryFormat = false;
+    else
+        fatal("Unknown checkpoint format '%s'\n", format);
+}
 
 string
 Checkpoint::setDir(const string &name)
@@ -614,9 +783,15 @@ Checkpoint::dir()
 
 
 Checkpoint::Checkpoint(const string &cpt_dir)
-    : db(new IniFile), cptDir(setDir(cpt_dir))
+    : db(NULL), binary(NULL), cptDir(setDir(cpt_dir))
 {
     string filename = cptDir + "/" + Checkpoint::baseFilename;
+    if (BinaryCheckpoint::Reader::isBinary(filename)) {
+        binary = new BinaryCheckpoint::Reader(filename);
+        return;
+    }
+
+    db = new IniFile;
     if (!db->load(filename)) {
         fatal("Can't load checkpoint file '%s'\n", filename);
     }
@@ -625,12 +800,27 @@ Checkpoint::Checkpoint(const string &cpt_dir)
 Checkpoint::~Checkpoint()
 {
     delete db;
+    delete binary;
 }
 
 bool
 Checkpoint::find(const string &section, const string &entry, string &value)
 {
-    return db->find(section, entry, value);
+    if (!binary)
+        return db->find(section, entry, value);
+
+    const BinaryCheckpoint::Entry *e = binary->find(section, entry);
+    if (!e)
+        return false;
+
+    value = e->text();
+    return true;
+}
+
+const BinaryCheckpoint::Entry *
+Checkpoint::findEntry(const string &section, const string &entry)
+{
+    return binary ? binary->find(section, entry) : NULL;
 }
 
 
@@ -640,7 +830,7 @@ Checkpoint::findObj(const string &section, const string &entry,
 {
     string path;
 
-    if (!db->find(section, entry, path))
+    if (!find(section, entry, path))
         return false;
 
     value = resolveSimObject(path);
@@ -651,5 +841,6 @@ Checkpoint::findObj(const string &section, const string &entry,
 bool
 Checkpoint::sectionExists(const string &section)
 {
-    return db->sectionExists(section);
+    return binary ? binary->sectionExists(section) :
+        db->sectionExists(section);
 }
@@ -47,6 +47,13 @@
 
 class IniFile;
 class Serializable;
+
+namespace BinaryCheckpoint
+{
+class Reader;
+struct Entry;
+}
+
 class Checkpoint;
 class SimObject;
 class EventQueue;
@@ -158,9 +165,11 @@ class Serializable
 {
   protected:
     void nameOut(std::ostream &os);
-    void nameOut(std::ostream &os, const std::string &_name);
 
   public:
+    /** Start a new section of the checkpoint. */
+    static void nameOut(std::ostream &os, const std::string &_name);
+
     Serializable();
     virtual ~Serializable();
 
@@ -259,17 +268,33 @@ class Checkpoint
 {
   private:
 
+    /** The checkpoint if it is an ini file, or NULL. */
     IniFile *db;
 
+    /** The checkpoint if it is in the binary format, or NULL. */
+    BinaryCheckpoint::Reader *binary;
+
   public:
     Checkpoint(const std::string &cpt_dir);
     ~Checkpoint();
 
     const std::string cptDir;
 
+    /**
+     * Find an entry in its text form. Entries of binary checkpoints
+     * are converted to the text they would have in an ini file.
+     */
     bool find(const std::string &section, const std::string &entry,
               std::string &value);
 
+    /**
+     * Find an entry of a binary checkpoint.
+     * @return The entry, or NULL if there is no such entry or the
+     * checkpoint is an ini file.
+     */
+    const BinaryCheckpoint::Entry *findEntry(const std::string &section,
+                                             const std::string &entry);
+
     bool findObj(const std::string &section, const std::string &entry,
                  SimObject *&value);
 
@@ -286,6 +311,9 @@ class Checkpoint
     // current directory we're serializing into.
     static std::string currentDirectory;
 
+    // write checkpoints in the binary format rather than as ini files
+    static bool binaryFormat;
+
   public:
     // Set the current directory.  This function takes care of
     // inserting curTick() if there's a '%d' in the argument, and
@@ -300,6 +328,11 @@ class Checkpoint
 
     // Filename for base checkpoint file within directory.
     static const char *baseFilename;
+
+    // Select the format of the checkpoints written, "binary" (the
+    // default) or "ini". Both formats are read.
+    static void setFormat(const std::string &format);
+    static bool writeBinary() { return binaryFormat; }
 };
 
 #endif // __SERIALIZE_HH__
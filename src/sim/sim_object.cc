@@ -96,6 +96,11 @@ SimObject::startup()
 {
 }
 
+void
+SimObject::notifyFork()
+{
+}
+
 //
 // no default statistics, so nothing to do in base implementation
 //
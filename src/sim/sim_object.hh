@@ -168,6 +168,14 @@ class SimObject : public EventManager, public Serializable, public Drainable
      */
     virtual void startup();
 
+    /**
+     * notifyFork() is called on each SimObject in the child process
+     * after the simulator has forked (see m5.fork()). Objects holding
+     * host resources that can't be shared with the parent should
+     * release or reopen them here.
+     */
+    virtual void notifyFork();
+
     /**
      * Provide a default implementation of the drain interface that
      * simply returns 0 (draining completed) and sets the drain state
@@ -33,6 +33,7 @@
 
 #include <mutex>
 #include <thread>
+#include <vector>
 
 #include "base/misc.hh"
 #include "base/pollevent.hh"
@@ -51,6 +52,10 @@ std::mutex asyncEventMutex;
 //! simulation loop.
 Barrier *threadBarrier;
 
+//! Subordinate threads, created the first time simulate() is called.
+static std::vector<std::thread *> threads;
+static bool threads_initialized = false;
+
 //! forward declaration
 Event *doSimLoop(EventQueue *);
 
@@ -82,9 +87,6 @@ simulate(Tick num_cycles)
     // The first time simulate() is called from the Python code, we need to
     // create a thread for each of event queues referenced by the
     // instantiated sim objects.
-    static bool threads_initialized = false;
-    static std::vector<std::thread *> threads;
-
     if (!threads_initialized) {
         threadBarrier = new Barrier(numMainEventQueues);
 
@@ -183,6 +185,7 @@ doSimLoop(EventQueue *eventq)
 {
     // set the per thread current eventq pointer
     curEventQueue(eventq);
+    eventq->resetAsyncSent();
     eventq->handleAsyncInsertions();
 
     while (1) {
@@ -224,3 +227,13 @@ doSimLoop(EventQueue *eventq)
 
     // not reached... only exit is return on SimLoopExitEvent
 }
+
+void
+forgetSimThreads()
+{
+    // The threads and the barrier they wait on only exist in the
+    // parent, so leak them rather than touching them.
+    threads.clear();
+    threadBarrier = NULL;
+    threads_initialized = false;
+}
@@ -33,3 +33,10 @@
 #include "sim/sim_events.hh"
 
 GlobalSimLoopExitEvent *simulate(Tick num_cycles = MaxTick);
+
+/**
+ * Forget about the subordinate simulation threads. Used in a child
+ * forked by the simulator, which only has the thread that called
+ * fork(); the next call to simulate() starts new threads.
+ */
+void forgetSimThreads();
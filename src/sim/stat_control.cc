@@ -55,6 +55,7 @@
 #include "base/statistics.hh"
 #include "base/time.hh"
 #include "cpu/base.hh"
+#include "sim/event_pool.hh"
 #include "sim/global_event.hh"
 #include "sim/stat_control.hh"
 
@@ -105,6 +106,61 @@ statFinalTick()
 
 SimTicksReset simTicksReset;
 
+Counter
+statAsyncInsertions()
+{
+    Counter total = 0;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        total += mainEventQueue[i]->asyncInsertions();
+    return total;
+}
+
+Counter
+statAsyncOverflows()
+{
+    Counter total = 0;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        total += mainEventQueue[i]->asyncOverflows();
+    return total;
+}
+
+Counter
+statAsyncRetries()
+{
+    Counter total = 0;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        total += mainEventQueue[i]->asyncRetries();
+    return total;
+}
+
+struct AsyncEventsReset : public Callback
+{
+    void process()
+    {
+        for (uint32_t i = 0; i < numMainEventQueues; ++i)
+            mainEventQueue[i]->resetAsyncCounters();
+    }
+};
+
+AsyncEventsReset asyncEventsReset;
+
+/** Functor reporting the allocation counters of a pooled event type. */
+struct EventPoolCounter
+{
+    int type;
+    bool reused;
+
+    EventPoolCounter(int _type, bool _reused)
+        : type(_type), reused(_reused)
+    {}
+
+    Counter
+    operator()() const
+    {
+        return reused ? EventPool::reused(type) : EventPool::allocated(type);
+    }
+};
+
 struct Global
 {
     Stats::Formula hostInstRate;
@@ -116,6 +172,13 @@ struct Global
     Stats::Value simInsts;
     Stats::Value simOps;
 
+    Stats::Value asyncInsertions;
+    Stats::Value asyncOverflows;
+    Stats::Value asyncRetries;
+
+    std::vector<EventPoolCounter *> eventPoolCounters;
+    std::vector<Stats::Value *> eventPoolStats;
+
     Global();
 };
 
@@ -195,12 +258,59 @@ Global::Global()
         .precision(0)
         ;
 
+    asyncInsertions
+        .functor(statAsyncInsertions)
+        .name("sim_async_insertions")
+        .desc("Number of events scheduled across event queues")
+        .prereq(asyncInsertions)
+        ;
+
+    asyncOverflows
+        .functor(statAsyncOverflows)
+        .name("sim_async_overflows")
+        .desc("Number of cross-queue events that overflowed the async ring")
+        .prereq(asyncOverflows)
+        ;
+
+    asyncRetries
+        .functor(statAsyncRetries)
+        .name("sim_async_retries")
+        .desc("Number of contended attempts to schedule cross-queue events")
+        .prereq(asyncRetries)
+        ;
+
+    const vector<string> &pool_names = EventPool::typeNames();
+    for (int i = 0; i < pool_names.size(); ++i) {
+        EventPoolCounter *allocated = new EventPoolCounter(i, false);
+        EventPoolCounter *reused = new EventPoolCounter(i, true);
+        eventPoolCounters.push_back(allocated);
+        eventPoolCounters.push_back(reused);
+
+        Stats::Value *allocs = new Stats::Value();
+        allocs->functor(*allocated)
+            .name("sim_event_pool." + pool_names[i] + ".allocs")
+            .desc("Number of pooled events that had to be allocated")
+            .prereq(*allocs)
+            ;
+
+        Stats::Value *avoided = new Stats::Value();
+        avoided->functor(*reused)
+            .name("sim_event_pool." + pool_names[i] + ".allocs_avoided")
+            .desc("Number of pooled events that reused freed memory")
+            .prereq(*allocs)
+            ;
+
+        eventPoolStats.push_back(allocs);
+        eventPoolStats.push_back(avoided);
+    }
+
     simSeconds = simTicks / simFreq;
     hostInstRate = simInsts / hostSeconds;
     hostOpRate = simOps / hostSeconds;
     hostTickRate = simTicks / hostSeconds;
 
     registerResetCallback(&simTicksReset);
+    registerResetCallback(&asyncEventsReset);
 }
 
 void
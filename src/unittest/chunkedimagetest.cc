@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Checks that chunked images read back the data they were written
+ * from, for sizes around the chunk size and for different numbers of
+ * threads writing and reading.
+ */
+
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "base/chunked_image.hh"
+#include "base/cprintf.hh"
+#include "base/random.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+using UnitTest::setCase;
+
+namespace {
+
+/**
+ * Fill data with chunks that are all zero, sparse and dense, in a
+ * pattern that does not line up with the chunks.
+ */
+void
+fill(vector<uint8_t> &data)
+{
+    Random rng(1);
+    const uint64_t block_size = 1 << 20;
+
+    for (uint64_t offset = 0; offset < data.size(); offset += block_size) {
+        uint64_t end = min<uint64_t>(offset + block_size, data.size());
+        switch (offset / block_size % 3) {
+          case 0:
+            break;
+          case 1:
+            for (int i = 0; i < 16; ++i)
+                data[rng.random<uint64_t>(offset, end - 1)] =
+                    rng.random<uint8_t>(1, 255);
+            break;
+          case 2:
+            for (uint64_t i = offset; i < end; ++i)
+                data[i] = rng.random<uint8_t>(0, 3);
+            break;
+        }
+    }
+}
+
+} // anonymous namespace
+
+int
+main()
+{
+    const uint64_t chunk = ChunkedImage::defaultChunkSize;
+    const uint64_t sizes[] = {
+        0, 100, chunk - 1, chunk, chunk + 1, 5 * chunk + 123
+    };
+    const unsigned threads[][2] = { { 1, 1 }, { 3, 1 }, { 1, 4 }, { 4, 3 } };
+    string filename = csprintf("/tmp/chunkedimagetest.%d", getpid());
+
+    setCase("round trip");
+    for (int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        vector<uint8_t> data(sizes[s]);
+        fill(data);
+
+        for (int t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t) {
+            vector<uint8_t> restored(sizes[s]);
+            ChunkedImage::write(filename, sizes[s] ? &data[0] : NULL,
+                                sizes[s], threads[t][0]);
+            ChunkedImage::read(filename, sizes[s] ? &restored[0] : NULL,
+                               sizes[s], threads[t][1]);
+            EXPECT_TRUE(restored == data);
+        }
+    }
+
+    setCase("zero chunks are left untouched");
+    {
+        // The first chunk is zero, the second is not
+        vector<uint8_t> data(2 * chunk);
+        data[chunk + 5] = 42;
+        ChunkedImage::write(filename, &data[0], data.size());
+
+        vector<uint8_t> restored(data.size(), 0xff);
+        ChunkedImage::read(filename, &restored[0], restored.size());
+        EXPECT_EQ(restored[0], 0xff);
+        EXPECT_EQ(restored[chunk - 1], 0xff);
+        EXPECT_EQ(restored[chunk], 0);
+        EXPECT_EQ(restored[chunk + 5], 42);
+    }
+
+    unlink(filename.c_str());
+
+    return UnitTest::printResults();
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Checkpoint compression benchmark. A memory store of a few GB, with
+ * a mix of untouched, lightly used and densely used pages, is written
+ * as a single gzip stream the way memory images used to be, and as a
+ * chunked image with an increasing number of threads. Every chunked
+ * image is also timed being read back; that it reads back the store
+ * is checked by chunkedimagetest.
+ */
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include "base/chunked_image.hh"
+#include "base/cprintf.hh"
+#include "base/misc.hh"
+#include "base/random.hh"
+#include "base/time.hh"
+
+using namespace std;
+
+uint8_t *
+allocate(uint64_t size)
+{
+    void *p = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                   MAP_ANON | MAP_PRIVATE | MAP_NORESERVE, -1, 0);
+    if (p == MAP_FAILED)
+        fatal("Could not allocate %d bytes\n", size);
+    return (uint8_t *)p;
+}
+
+/**
+ * Fill the store like a booted system would: half of the pages are
+ * never touched, a quarter hold a few words of data structures and
+ * the rest hold code and data that compresses about 3:1.
+ */
+void
+fill(uint8_t *store, uint64_t size)
+{
+    const uint64_t page_size = 4096;
+    Random rng(1);
+
+    for (uint64_t offset = 0; offset + page_size <= size;
+         offset += page_size) {
+        uint64_t *page = (uint64_t *)(store + offset);
+        uint32_t kind = rng.random<uint32_t>(0, 3);
+        if (kind < 2)
+            continue;
+
+        if (kind == 2) {
+            for (int i = 0; i < 8; ++i)
+                page[rng.random<uint32_t>(0, 511)] = rng.random<uint64_t>();
+            continue;
+        }
+
+        for (int i = 0; i < 512; ++i) {
+            if (rng.random<uint32_t>(0, 1))
+                page[i] = rng.random<uint64_t>() & 0xff;
+            else
+                page[i] = (uint64_t)i << 32;
+        }
+    }
+}
+
+double
+writeGzip(const string &filename, const uint8_t *store, uint64_t size)
+{
+    Time start, end;
+    start.setTimer();
+
+    gzFile file = gzopen(filename.c_str(), "wb");
+    if (!file)
+        fatal("Can't open '%s'\n", filename);
+
+    // gzwrite takes an int length
+    const uint64_t pass_size = 1 << 30;
+    for (uint64_t written = 0; written < size; written += pass_size) {
+        unsigned len = min(pass_size, size - written);
+        if (gzwrite(file, store + written, len) != (int)len)
+            fatal("Write failed on '%s'\n", filename);
+    }
+
+    if (gzclose(file))
+        fatal("Close failed on '%s'\n", filename);
+
+    end.setTimer();
+    return end - start;
+}
+
+uint64_t
+fileSize(const string &filename)
+{
+    FILE *f = fopen(filename.c_str(), "r");
+    if (!f)
+        fatal("Can't open '%s'\n", filename);
+    fseek(f, 0, SEEK_END);
+    uint64_t size = ftell(f);
+    fclose(f);
+    return size;
+}
+
+int
+main(int argc, char *argv[])
+{
+    uint64_t size = argc > 1 ? strtoull(argv[1], NULL, 0) : 4ULL << 30;
+    string dir = argc > 2 ? argv[2] : "/tmp";
+    unsigned max_threads = thread::hardware_concurrency();
+    if (max_threads == 0)
+        max_threads = 1;
+
+    string filename = csprintf("%s/chunkedimagetime.%d", dir, getpid());
+    double mb = size / (1024.0 * 1024.0);
+
+    uint8_t *store = allocate(size);
+    fill(store, size);
+
+    double secs = writeGzip(filename, store, size);
+    cprintf("%-16s %.0fMB in %.3fs, %.0fMB/s, %dMB written\n", "gzip",
+            mb, secs, mb / secs, fileSize(filename) >> 20);
+
+    uint8_t *restored = allocate(size);
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        Time start, end;
+        start.setTimer();
+        ChunkedImage::write(filename, store, size, threads);
+        end.setTimer();
+        double write_secs = end - start;
+
+        start.setTimer();
+        ChunkedImage::read(filename, restored, size, threads);
+        end.setTimer();
+        double read_secs = end - start;
+
+        cprintf("chunked %2d thr   %.0fMB in %.3fs, %.0fMB/s, %dMB written, "
+                "read in %.3fs, %.1fx gzip\n", threads, mb, write_secs,
+                mb / write_secs, fileSize(filename) >> 20, read_secs,
+                secs / write_secs);
+
+        // start from a clean slate, as only non-zero chunks are read
+        munmap(restored, size);
+        restored = allocate(size);
+    }
+
+    unlink(filename.c_str());
+    munmap(store, size);
+    munmap(restored, size);
+
+    return 0;
+}
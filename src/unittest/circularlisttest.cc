@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Checks CircularList against std::list, and the cases that are
+ * particular to its circular buffer: holes left by erasing from the
+ * middle, growing the buffer and wrapping around it.
+ */
+
+#include <list>
+#include <vector>
+
+#include "base/circular_list.hh"
+#include "base/random.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+using UnitTest::setCase;
+
+namespace {
+
+typedef CircularList<int> IntList;
+
+bool
+matches(const IntList &c, const list<int> &l)
+{
+    if (c.size() != l.size())
+        return false;
+
+    IntList::const_iterator ci = c.begin();
+    list<int>::const_iterator li = l.begin();
+    for (; li != l.end(); ++ci, ++li) {
+        if (ci == c.end() || *ci != *li)
+            return false;
+    }
+    if (ci != c.end())
+        return false;
+
+    // and backwards, from end() to begin()
+    li = l.end();
+    while (li != l.begin()) {
+        --ci;
+        --li;
+        if (*ci != *li)
+            return false;
+    }
+    return ci == c.begin();
+}
+
+} // anonymous namespace
+
+int
+main()
+{
+    setCase("erase from the middle and the head");
+    {
+        IntList c(8);
+        list<int> l;
+        for (int i = 0; i < 8; ++i) {
+            c.push_back(i);
+            l.push_back(i);
+        }
+
+        IntList::iterator it = c.begin();
+        for (int i = 0; i < 3; ++i)
+            ++it;
+        it = c.erase(it);
+        l.remove(3);
+        EXPECT_EQ(*it, 4);
+        EXPECT_TRUE(matches(c, l));
+
+        it = c.erase(c.begin());
+        l.pop_front();
+        EXPECT_EQ(*it, 1);
+        EXPECT_EQ(c.front(), 1);
+        EXPECT_TRUE(matches(c, l));
+
+        // erasing next to a hole moves the head past it
+        ++it;
+        c.erase(it);
+        c.erase(c.begin());
+        l.remove(1);
+        l.remove(2);
+        EXPECT_EQ(c.front(), 4);
+        EXPECT_TRUE(matches(c, l));
+    }
+
+    setCase("pop_back over holes");
+    {
+        IntList c(8);
+        vector<IntList::iterator> its;
+        for (int i = 0; i < 6; ++i) {
+            c.push_back(i);
+            its.push_back(--c.end());
+        }
+
+        c.erase(its[4]);
+        c.erase(its[2]);
+        c.pop_back();
+        EXPECT_EQ(c.back(), 3);
+        c.pop_back();
+        EXPECT_EQ(c.back(), 1);
+        EXPECT_EQ(c.size(), 2);
+
+        c.pop_back();
+        c.pop_back();
+        EXPECT_TRUE(c.empty());
+        EXPECT_TRUE(c.begin() == c.end());
+
+        // the positions of an emptied list are reused without growing
+        for (int i = 0; i < 8; ++i)
+            c.push_back(i);
+        EXPECT_EQ(c.capacity(), 8);
+        EXPECT_EQ(c.front(), 0);
+        EXPECT_EQ(c.back(), 7);
+    }
+
+    setCase("iterators stay valid when the buffer grows");
+    {
+        IntList c(4);
+        vector<IntList::iterator> its;
+        for (int i = 0; i < 4; ++i) {
+            c.push_back(i);
+            its.push_back(--c.end());
+        }
+
+        // a hole near the head makes the span exceed the elements
+        c.erase(its[1]);
+        for (int i = 4; i < 100; ++i) {
+            c.push_back(i);
+            its.push_back(--c.end());
+        }
+        EXPECT_TRUE(c.capacity() >= 128);
+
+        bool valid = true;
+        for (int i = 0; i < 100; ++i) {
+            if (i != 1 && *its[i] != i)
+                valid = false;
+        }
+        EXPECT_TRUE(valid);
+        EXPECT_EQ(c.size(), 99);
+
+        IntList::iterator next = its[0];
+        ++next;
+        EXPECT_EQ(*next, 2);
+    }
+
+    setCase("begin() and end() wrap around");
+    {
+        IntList c(4);
+        EXPECT_TRUE(c.begin() == c.end());
+        EXPECT_TRUE(--c.end() == c.end());
+
+        // go around the buffer a few times, always one element short
+        // of full, so that it never grows
+        list<int> l;
+        for (int i = 0; i < 3; ++i) {
+            c.push_back(i);
+            l.push_back(i);
+        }
+        bool ok = true;
+        for (int i = 3; i < 20; ++i) {
+            c.pop_front();
+            l.pop_front();
+            c.push_back(i);
+            l.push_back(i);
+            ok = ok && matches(c, l);
+        }
+        EXPECT_TRUE(ok);
+        EXPECT_EQ(c.capacity(), 4);
+
+        IntList::iterator it = c.begin();
+        EXPECT_TRUE(--it == c.end());
+        EXPECT_TRUE(++it == c.begin());
+        it = c.end();
+        EXPECT_TRUE(++it == c.begin());
+        it = c.end();
+        EXPECT_EQ(*--it, 19);
+    }
+
+    setCase("random operations match std::list");
+    {
+        Random rng(1);
+        bool ok = true;
+        for (int round = 0; round < 50 && ok; ++round) {
+            IntList c(rng.random<int>(0, 7));
+            list<int> l;
+            vector<IntList::iterator> cits;
+            vector<list<int>::iterator> lits;
+
+            for (int op = 0; op < 2000 && ok; ++op) {
+                int r = rng.random<int>(0, 9);
+                if (r < 4) {
+                    c.push_back(op);
+                    l.push_back(op);
+                    cits.push_back(--c.end());
+                    lits.push_back(--l.end());
+                } else if (!l.empty()) {
+                    // erase the oldest element, or one at random
+                    int k = r < 6 ? 0 : rng.random<int>(0, cits.size() - 1);
+                    IntList::iterator cn = c.erase(cits[k]);
+                    list<int>::iterator ln = l.erase(lits[k]);
+                    ok = (cn == c.end()) == (ln == l.end()) &&
+                        (ln == l.end() || *cn == *ln);
+                    cits.erase(cits.begin() + k);
+                    lits.erase(lits.begin() + k);
+                }
+                ok = ok && matches(c, l);
+            }
+        }
+        EXPECT_TRUE(ok);
+    }
+
+    return UnitTest::printResults();
+}
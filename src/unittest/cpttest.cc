@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Checks that values written to ini and binary checkpoints are
+ * restored unchanged, and that binary entries are only converted to
+ * other types when the values fit, as when parsing ini files.
+ */
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "base/cprintf.hh"
+#include "base/misc.hh"
+#include "base/random.hh"
+#include "sim/binary_checkpoint.hh"
+#include "sim/serialize.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+using BinaryCheckpoint::Entry;
+using UnitTest::setCase;
+
+namespace {
+
+class State : public Serializable
+{
+  public:
+    uint64_t count;
+    int8_t small;
+    double ratio;
+    bool valid;
+    string label;
+    vector<uint64_t> tags;
+    vector<uint32_t> flags;
+    vector<bool> dirty;
+    list<int> pending;
+    vector<string> names;
+
+    State() : count(0), small(0), ratio(0), valid(false) { }
+
+    State(size_t size)
+        : count(size), small(-5), ratio(1.0 / 3.0), valid(true),
+          label("state")
+    {
+        Random rng(1);
+        for (size_t i = 0; i < size; ++i) {
+            tags.push_back(rng.random<uint64_t>());
+            flags.push_back(rng.random<uint32_t>(0, 15));
+            dirty.push_back(rng.random<uint32_t>(0, 1));
+        }
+        for (int i = 0; i < 64; ++i) {
+            pending.push_back(-i);
+            names.push_back(csprintf("name%d", i));
+        }
+    }
+
+    const string name() const { return "state"; }
+
+    void
+    serialize(ostream &os)
+    {
+        nameOut(os);
+        SERIALIZE_SCALAR(count);
+        SERIALIZE_SCALAR(small);
+        SERIALIZE_SCALAR(ratio);
+        SERIALIZE_SCALAR(valid);
+        SERIALIZE_SCALAR(label);
+        arrayParamOut(os, "tags", tags);
+        arrayParamOut(os, "flags", flags);
+        arrayParamOut(os, "dirty", dirty);
+        arrayParamOut(os, "pending", pending);
+        arrayParamOut(os, "names", names);
+    }
+
+    void
+    unserialize(Checkpoint *cp, const string &section)
+    {
+        UNSERIALIZE_SCALAR(count);
+        UNSERIALIZE_SCALAR(small);
+        UNSERIALIZE_SCALAR(ratio);
+        UNSERIALIZE_SCALAR(valid);
+        UNSERIALIZE_SCALAR(label);
+        arrayParamIn(cp, section, "tags", tags);
+        arrayParamIn(cp, section, "flags", flags);
+        arrayParamIn(cp, section, "dirty", dirty);
+        arrayParamIn(cp, section, "pending", pending);
+        arrayParamIn(cp, section, "names", names);
+    }
+};
+
+/** An entry holding a single value of type T. */
+template <class T>
+Entry
+makeEntry(const T &value, BinaryCheckpoint::Type type)
+{
+    Entry entry;
+    entry.type = type;
+    entry.flags = 0;
+    entry.count = 1;
+    entry.data = (const char *)&value;
+    entry.size = sizeof(value);
+    return entry;
+}
+
+} // anonymous namespace
+
+int
+main()
+{
+    using namespace BinaryCheckpoint;
+
+    string dir = csprintf("/tmp/cpttest.%d", getpid());
+    if (mkdir(dir.c_str(), 0775) != 0)
+        fatal("Can't create %s\n", dir);
+    string filename = dir + "/" + Checkpoint::baseFilename;
+
+    State state(1000);
+
+    setCase("ini round trip");
+    {
+        ofstream os(filename.c_str(), ios::binary);
+        state.serialize(os);
+    }
+    {
+        State restored;
+        Checkpoint cp(dir);
+        restored.unserialize(&cp, state.name());
+        EXPECT_EQ(restored.count, state.count);
+        EXPECT_EQ(restored.small, state.small);
+        // the ini format only keeps 6 digits of doubles
+        EXPECT_TRUE(restored.ratio - state.ratio < 1e-6 &&
+                    state.ratio - restored.ratio < 1e-6);
+        EXPECT_EQ(restored.valid, state.valid);
+        EXPECT_TRUE(restored.label == state.label);
+        EXPECT_TRUE(restored.tags == state.tags);
+        EXPECT_TRUE(restored.flags == state.flags);
+        EXPECT_TRUE(restored.dirty == state.dirty);
+        EXPECT_TRUE(restored.pending == state.pending);
+        EXPECT_TRUE(restored.names == state.names);
+    }
+
+    setCase("binary round trip");
+    {
+        ofstream os(filename.c_str(), ios::binary);
+        BinaryCheckpoint::Writer writer(os);
+        state.serialize(os);
+        writer.finish();
+    }
+    {
+        State restored;
+        Checkpoint cp(dir);
+        restored.unserialize(&cp, state.name());
+        EXPECT_EQ(restored.count, state.count);
+        EXPECT_EQ(restored.small, state.small);
+        EXPECT_EQ(restored.ratio, state.ratio);
+        EXPECT_EQ(restored.valid, state.valid);
+        EXPECT_TRUE(restored.label == state.label);
+        EXPECT_TRUE(restored.tags == state.tags);
+        EXPECT_TRUE(restored.flags == state.flags);
+        EXPECT_TRUE(restored.dirty == state.dirty);
+        EXPECT_TRUE(restored.pending == state.pending);
+        EXPECT_TRUE(restored.names == state.names);
+
+        // Values are converted to other types only if they fit
+        uint8_t narrow;
+        int64_t wide;
+        EXPECT_FALSE(optParamIn(&cp, state.name(), "count", narrow));
+        EXPECT_TRUE(optParamIn(&cp, state.name(), "count", wide));
+        EXPECT_EQ(wide, 1000);
+        EXPECT_FALSE(optParamIn(&cp, state.name(), "small", narrow));
+        EXPECT_TRUE(optParamIn(&cp, state.name(), "small", wide));
+        EXPECT_EQ(wide, -5);
+    }
+
+    setCase("conversion range checks");
+    {
+        int64_t big = 300, negative = -1, one = 1, two = 2;
+        uint64_t huge = numeric_limits<uint64_t>::max();
+        double half = 2.5, whole = 3.0, large = 1e19;
+
+        EXPECT_FALSE(makeEntry(big, Int64).fits<uint8_t>(0));
+        EXPECT_TRUE(makeEntry(big, Int64).fits<int16_t>(0));
+        EXPECT_FALSE(makeEntry(negative, Int64).fits<unsigned>(0));
+        EXPECT_TRUE(makeEntry(negative, Int64).fits<int8_t>(0));
+        EXPECT_FALSE(makeEntry(huge, UInt64).fits<int64_t>(0));
+        EXPECT_TRUE(makeEntry(huge, UInt64).fits<uint64_t>(0));
+        EXPECT_TRUE(makeEntry(huge, UInt64).fits<double>(0));
+        EXPECT_TRUE(makeEntry(one, Int64).fits<bool>(0));
+        EXPECT_FALSE(makeEntry(two, Int64).fits<bool>(0));
+        EXPECT_FALSE(makeEntry(half, Double).fits<int>(0));
+        EXPECT_TRUE(makeEntry(whole, Double).fits<int>(0));
+        EXPECT_FALSE(makeEntry(large, Double).fits<int64_t>(0));
+        EXPECT_TRUE(makeEntry(large, Double).fits<uint64_t>(0));
+        EXPECT_TRUE(makeEntry(large, Double).fits<float>(0));
+    }
+
+    unlink(filename.c_str());
+    rmdir(dir.c_str());
+
+    return UnitTest::printResults();
+}
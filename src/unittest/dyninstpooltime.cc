@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*
+ * Dynamic instruction pool microbenchmark. Objects the size of an O3
+ * instruction are created and freed the way the O3 CPU does, with a
+ * fixed number in flight that are retired in a scrambled order, once
+ * with new and delete and once through a DynInstPool.
+ */
+
+#include <cstdlib>
+
+#include "base/cprintf.hh"
+#include "base/time.hh"
+#include "cpu/o3/dyn_inst_pool.hh"
+
+using namespace std;
+
+namespace {
+
+const int maxInFlight = 256;
+
+/** Allocated with new and delete. */
+struct PlainInst
+{
+    virtual ~PlainInst() {}
+    char body[512];
+};
+
+/** Allocated the way BaseO3DynInst is. */
+struct PooledInst
+{
+    virtual ~PooledInst() {}
+    char body[512];
+
+    static void *
+    operator new(size_t size, DynInstPool &pool)
+    {
+        return pool.allocate(size);
+    }
+
+    static void *
+    operator new(size_t size)
+    {
+        return DynInstPool::allocateUnpooled(size);
+    }
+
+    static void operator delete(void *p) { DynInstPool::release(p); }
+
+    static void
+    operator delete(void *p, DynInstPool &pool)
+    {
+        DynInstPool::release(p);
+    }
+};
+
+PlainInst *plainInsts[maxInFlight];
+PooledInst *pooledInsts[maxInFlight];
+
+} // anonymous namespace
+
+int
+main(int argc, char *argv[])
+{
+    uint64_t num_insts =
+        argc > 1 ? strtoull(argv[1], NULL, 0) : 50000000;
+
+    DynInstPool pool("pool", maxInFlight, false);
+
+    Time start, end;
+    start.setTimer();
+    for (uint64_t i = 0; i < num_insts; ++i) {
+        PlainInst *&slot = plainInsts[(i * 37) % maxInFlight];
+        delete slot;
+        slot = new PlainInst;
+        slot->body[0] = i;
+    }
+    end.setTimer();
+    double plain_secs = end - start;
+
+    start.setTimer();
+    for (uint64_t i = 0; i < num_insts; ++i) {
+        PooledInst *&slot = pooledInsts[(i * 37) % maxInFlight];
+        delete slot;
+        slot = new (pool) PooledInst;
+        slot->body[0] = i;
+    }
+    end.setTimer();
+    double pooled_secs = end - start;
+
+    for (int i = 0; i < maxInFlight; ++i) {
+        delete plainInsts[i];
+        delete pooledInsts[i];
+    }
+
+    cprintf("%d instructions\n", num_insts);
+    cprintf("new/delete: %.3fs\n", plain_secs);
+    cprintf("pool:       %.3fs\n", pooled_secs);
+
+    return 0;
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Checks that the sorted list and calendar queue backends of
+ * EventQueue service events in exactly the same order, including
+ * events with the same time and priority, and that switching backends
+ * with events pending keeps that order.
+ */
+
+#include <vector>
+
+#include "base/random.hh"
+#include "sim/eventq_impl.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+using UnitTest::setCase;
+
+namespace {
+
+class TestEvent : public Event
+{
+  private:
+    vector<int> *log;
+    int id;
+
+  public:
+    TestEvent(vector<int> *_log, int _id, Priority pri)
+        : Event(pri), log(_log), id(_id)
+    { }
+
+    void process() { log->push_back(id); }
+    const char *description() const { return "test"; }
+};
+
+/**
+ * Schedule a fixed pseudo-random mix of events, reschedule and
+ * deschedule some of them while running, and record the order in
+ * which they are serviced.
+ * @param switch_at Number of events after which the queue is switched
+ * to the other backend, or -1 to never switch.
+ */
+vector<int>
+runWorkload(EventQueue::Backend backend, int switch_at)
+{
+    const int num_events = 4096;
+    const Event::Priority pris[] = {
+        Event::Minimum_Pri, Event::Default_Pri, Event::CPU_Tick_Pri
+    };
+
+    vector<int> log;
+    EventQueue queue("test", backend);
+    curEventQueue(&queue);
+
+    Random rng(1);
+    vector<TestEvent *> events;
+    for (int i = 0; i < num_events; ++i) {
+        events.push_back(new TestEvent(&log, i, pris[i % 3]));
+        // Few distinct times, so that many events share a bin, and a
+        // long tail of far away events
+        Tick when = rng.random<uint32_t>(0, 3) ?
+            rng.random<Tick>(1, 64) * 500 :
+            rng.random<Tick>(1, 1000000);
+        queue.schedule(events.back(), when);
+    }
+
+    int serviced = 0;
+    while (!queue.empty()) {
+        if (serviced == switch_at) {
+            queue.setBackend(backend == EventQueue::SortedList ?
+                             EventQueue::Calendar : EventQueue::SortedList);
+        }
+
+        queue.serviceOne();
+        ++serviced;
+
+        TestEvent *other = events[rng.random<uint32_t>(0, num_events - 1)];
+        uint32_t action = rng.random<uint32_t>(0, 9);
+        if (action == 0 && other->scheduled()) {
+            queue.deschedule(other);
+        } else if (action == 1) {
+            Tick when = curTick() + rng.random<Tick>(0, 4) * 500;
+            if (other->scheduled())
+                queue.reschedule(other, when);
+            else
+                queue.schedule(other, when);
+        }
+    }
+
+    for (int i = 0; i < num_events; ++i)
+        delete events[i];
+    curEventQueue(NULL);
+
+    return log;
+}
+
+} // anonymous namespace
+
+int
+main()
+{
+    setCase("same time and priority order");
+    for (int b = 0; b < 2; ++b) {
+        EventQueue::Backend backend =
+            b ? EventQueue::Calendar : EventQueue::SortedList;
+        vector<int> log;
+        EventQueue queue("test", backend);
+        curEventQueue(&queue);
+
+        TestEvent low1(&log, 1, Event::Minimum_Pri);
+        TestEvent low2(&log, 2, Event::Minimum_Pri);
+        TestEvent high(&log, 3, Event::Maximum_Pri);
+        TestEvent late(&log, 4, Event::Minimum_Pri);
+        queue.schedule(&high, 100);
+        queue.schedule(&low1, 100);
+        queue.schedule(&late, 200);
+        queue.schedule(&low2, 100);
+        while (!queue.empty())
+            queue.serviceOne();
+
+        // Lower priority values go first, and events in the same bin
+        // are serviced last in, first out
+        EXPECT_EQ(log.size(), 4);
+        if (log.size() == 4) {
+            EXPECT_EQ(log[0], 2);
+            EXPECT_EQ(log[1], 1);
+            EXPECT_EQ(log[2], 3);
+            EXPECT_EQ(log[3], 4);
+        }
+        curEventQueue(NULL);
+    }
+
+    setCase("calendar queue matches sorted list");
+    vector<int> sorted = runWorkload(EventQueue::SortedList, -1);
+    vector<int> calendar = runWorkload(EventQueue::Calendar, -1);
+    EXPECT_TRUE(sorted.size() > 4096);
+    EXPECT_TRUE(sorted == calendar);
+
+    setCase("switching backends with events pending");
+    EXPECT_TRUE(runWorkload(EventQueue::SortedList, 1000) == sorted);
+    EXPECT_TRUE(runWorkload(EventQueue::Calendar, 1000) == sorted);
+
+    return UnitTest::printResults();
+}
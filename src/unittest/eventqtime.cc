@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Event queue microbenchmark. A number of clocked objects with
+ * different clock periods tick every cycle and issue memory requests
+ * whose responses come back after a latency drawn from a simple
+ * cache hierarchy model. Some responses are rescheduled to model
+ * retries. The same event stream is run on every event queue backend.
+ * Ordering between the backends is checked by eventqtest.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "base/cprintf.hh"
+#include "base/random.hh"
+#include "base/time.hh"
+#include "sim/eventq_impl.hh"
+
+using namespace std;
+
+class Bench;
+
+class ClockedEvent : public Event
+{
+  private:
+    Bench *bench;
+    Tick period;
+
+  public:
+    ClockedEvent(Bench *b, Tick _period)
+        : Event(CPU_Tick_Pri), bench(b), period(_period)
+    { }
+    void process();
+    const char *description() const { return "clocked"; }
+};
+
+class ResponseEvent : public Event
+{
+  private:
+    Bench *bench;
+
+  public:
+    ResponseEvent(Bench *b) : bench(b) { }
+    void process();
+    const char *description() const { return "response"; }
+};
+
+class Bench
+{
+  public:
+    EventQueue queue;
+    Random rng;
+    vector<ClockedEvent *> clocks;
+    vector<ResponseEvent *> responses;
+    vector<ResponseEvent *> freeResponses;
+    uint64_t serviced;
+
+    Bench(EventQueue::Backend backend, int num_clocks, int num_responses)
+        : queue("bench", backend), rng(1), serviced(0)
+    {
+        // Typical clock periods in ticks (ps): 2GHz, 1GHz, 3GHz and
+        // 800MHz domains
+        static const Tick periods[] = { 500, 1000, 333, 1250 };
+
+        curEventQueue(&queue);
+        for (int i = 0; i < num_clocks; ++i) {
+            clocks.push_back(new ClockedEvent(this, periods[i % 4]));
+            queue.schedule(clocks.back(), periods[i % 4]);
+        }
+
+        for (int i = 0; i < num_responses; ++i) {
+            responses.push_back(new ResponseEvent(this));
+            freeResponses.push_back(responses.back());
+        }
+    }
+
+    ~Bench()
+    {
+        for (int i = 0; i < clocks.size(); ++i) {
+            if (clocks[i]->scheduled())
+                queue.deschedule(clocks[i]);
+            delete clocks[i];
+        }
+        for (int i = 0; i < responses.size(); ++i) {
+            if (responses[i]->scheduled())
+                queue.deschedule(responses[i]);
+            delete responses[i];
+        }
+    }
+
+    void record() { ++serviced; }
+
+    void
+    tick(Tick period)
+    {
+        Tick now = curTick();
+
+        // Roughly every third cycle an access goes out, hitting in L1
+        // (2 cycles), L2 (20 cycles) or missing to memory (~80ns).
+        uint32_t r = rng.random<uint32_t>(0, 99);
+        if (r < 33 && !freeResponses.empty()) {
+            ResponseEvent *resp = freeResponses.back();
+            freeResponses.pop_back();
+
+            Tick latency;
+            if (r < 23)
+                latency = 2 * period;
+            else if (r < 30)
+                latency = 20 * period;
+            else
+                latency = 80000 + rng.random<Tick>(0, 20000);
+            queue.schedule(resp, now + latency);
+        }
+
+        // Occasionally a busy resource pushes a response back
+        if (r == 99) {
+            ResponseEvent *resp =
+                responses[rng.random<uint32_t>(0, responses.size() - 1)];
+            if (resp->scheduled())
+                queue.reschedule(resp, resp->when() + 10 * period);
+        }
+    }
+
+    void release(ResponseEvent *resp) { freeResponses.push_back(resp); }
+
+    void
+    run(uint64_t num_events)
+    {
+        while (serviced < num_events)
+            queue.serviceOne();
+    }
+};
+
+void
+ClockedEvent::process()
+{
+    bench->record();
+    bench->tick(period);
+    bench->queue.schedule(this, curTick() + period);
+}
+
+void
+ResponseEvent::process()
+{
+    bench->record();
+    bench->release(this);
+}
+
+int
+main(int argc, char *argv[])
+{
+    uint64_t num_events = argc > 1 ? strtoull(argv[1], NULL, 0) : 10000000;
+
+    const int num_backends = 2;
+    const EventQueue::Backend backends[num_backends] = {
+        EventQueue::SortedList, EventQueue::Calendar
+    };
+    const char *names[num_backends] = { "sorted_list", "calendar" };
+    const int configs[][2] = { { 16, 64 }, { 64, 1024 }, { 256, 8192 } };
+
+    for (int c = 0; c < sizeof(configs) / sizeof(configs[0]); ++c) {
+        for (int b = 0; b < num_backends; ++b) {
+            Bench bench(backends[b], configs[c][0], configs[c][1]);
+
+            Time start, end;
+            start.setTimer();
+            bench.run(num_events);
+            end.setTimer();
+
+            double secs = end - start;
+            cprintf("%-12s %4d clocks %5d responses: %d events in %.3fs, "
+                    "%.0f events/s\n", names[b], configs[c][0],
+                    configs[c][1], bench.serviced, secs,
+                    bench.serviced / secs);
+        }
+    }
+
+    return 0;
+}
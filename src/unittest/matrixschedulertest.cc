@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*
+ * Checks the selection of the matrix scheduler against a reference
+ * model that picks the candidate with the smallest sequence number.
+ * Sequence numbers are inserted out of order, as with several
+ * threads, and queue sizes on both sides of a word boundary.
+ */
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "base/random.hh"
+#include "cpu/o3/matrix_scheduler.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+using UnitTest::setCase;
+
+namespace {
+
+const unsigned numClasses = 4;
+
+struct Model
+{
+    map<int, InstSeqNum> seqNum;
+    map<int, OpClass> opClass;
+    set<int> ready;
+};
+
+int
+oldest(const Model &model, const set<int> &cand)
+{
+    int best = -1;
+    for (set<int>::const_iterator i = cand.begin(); i != cand.end(); ++i) {
+        if (best < 0 ||
+            model.seqNum.find(*i)->second < model.seqNum.find(best)->second)
+            best = *i;
+    }
+    return best;
+}
+
+int
+pick(Random &rng, const map<int, InstSeqNum> &entries)
+{
+    map<int, InstSeqNum>::const_iterator i = entries.begin();
+    for (int n = rng.random<int>(0, entries.size() - 1); n; --n)
+        ++i;
+    return i->first;
+}
+
+/**
+ * Run random inserts, removes, wakeups and selections on a scheduler
+ * of num_entries entries, returning false on the first selection
+ * that differs from the model.
+ */
+bool
+randomRun(Random &rng, unsigned num_entries, unsigned num_ops)
+{
+    MatrixScheduler matrix;
+    matrix.resize(num_entries, 8);
+    Model model;
+    set<InstSeqNum> used;
+    InstSeqNum next_seq = 1000;
+
+    for (unsigned op = 0; op < num_ops; ++op) {
+        switch (rng.random<int>(0, 3)) {
+          case 0:
+            if (model.seqNum.size() < num_entries) {
+                // mostly in program order, sometimes older than
+                // what is already in the queue; sequence numbers are
+                // unique, so they step by two to leave room for these
+                next_seq += 2;
+                InstSeqNum seq_num = rng.random<int>(0, 3) ?
+                    next_seq : next_seq - 2 * rng.random<int>(1, 450) + 1;
+                if (used.count(seq_num))
+                    break;
+                used.insert(seq_num);
+                OpClass op_class =
+                    (OpClass)rng.random<unsigned>(0, numClasses - 1);
+                int entry = matrix.insert(op_class, seq_num);
+                if (model.seqNum.count(entry))
+                    return false;
+                model.seqNum[entry] = seq_num;
+                model.opClass[entry] = op_class;
+            }
+            break;
+
+          case 1:
+            if (!model.seqNum.empty()) {
+                int entry = pick(rng, model.seqNum);
+                matrix.remove(entry);
+                model.seqNum.erase(entry);
+                model.opClass.erase(entry);
+                model.ready.erase(entry);
+            }
+            break;
+
+          case 2:
+            if (!model.seqNum.empty()) {
+                int entry = pick(rng, model.seqNum);
+                matrix.setReady(entry);
+                model.ready.insert(entry);
+            }
+            break;
+
+          default:
+            {
+                matrix.startSelect();
+                set<int> cand = model.ready;
+                for (int k = 0; k < 4; ++k) {
+                    int entry = matrix.selectOldest();
+                    if (entry != oldest(model, cand))
+                        return false;
+                    if (entry < 0)
+                        break;
+
+                    if (rng.random<int>(0, 1)) {
+                        OpClass op_class = model.opClass[entry];
+                        matrix.blockClass(op_class);
+                        set<int>::iterator i = cand.begin();
+                        while (i != cand.end()) {
+                            if (model.opClass[*i] == op_class)
+                                cand.erase(i++);
+                            else
+                                ++i;
+                        }
+                    } else {
+                        matrix.clearReady(entry);
+                        model.ready.erase(entry);
+                        cand.erase(entry);
+                    }
+                }
+            }
+            break;
+        }
+
+        if (matrix.numReady() != model.ready.size())
+            return false;
+    }
+
+    return true;
+}
+
+} // anonymous namespace
+
+int
+main()
+{
+    setCase("oldest by sequence number, not insertion order");
+    {
+        MatrixScheduler matrix;
+        matrix.resize(8, 4);
+        int a = matrix.insert(IntAluOp, 20);
+        int b = matrix.insert(IntAluOp, 10);
+        int c = matrix.insert(IntMultOp, 30);
+        matrix.setReady(a);
+        matrix.setReady(b);
+        matrix.setReady(c);
+
+        matrix.startSelect();
+        EXPECT_EQ(matrix.selectOldest(), b);
+        matrix.blockClass(IntAluOp);
+        EXPECT_EQ(matrix.selectOldest(), c);
+        matrix.blockClass(IntMultOp);
+        EXPECT_EQ(matrix.selectOldest(), -1);
+
+        // a freed entry is reused and ordered again
+        matrix.remove(b);
+        int d = matrix.insert(IntAluOp, 25);
+        EXPECT_EQ(d, b);
+        matrix.setReady(d);
+        matrix.startSelect();
+        EXPECT_EQ(matrix.selectOldest(), a);
+        matrix.clearReady(a);
+        EXPECT_EQ(matrix.selectOldest(), d);
+    }
+
+    setCase("wakeup");
+    {
+        MatrixScheduler matrix;
+        matrix.resize(100, 4);
+        int first = matrix.insert(IntAluOp, 1);
+        for (int i = 2; i < 100; ++i)
+            matrix.insert(IntAluOp, i);
+
+        vector<int> woken;
+        matrix.addWaiter(3, first);
+        matrix.addWaiter(3, 99);
+        matrix.addWaiter(2, 70);
+        matrix.removeWaiter(2, 70);
+        matrix.wake(3, woken);
+        EXPECT_EQ(woken.size(), 2);
+        matrix.wake(3, woken);
+        EXPECT_TRUE(woken.empty());
+        matrix.wake(2, woken);
+        EXPECT_TRUE(woken.empty());
+    }
+
+    setCase("random operations against a model");
+    {
+        Random rng(1);
+        unsigned sizes[] = { 7, 64, 100, 192 };
+        for (int i = 0; i < 4; ++i)
+            EXPECT_TRUE(randomRun(rng, sizes[i], 100000));
+    }
+
+    return UnitTest::printResults();
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Packet allocation microbenchmark. Requests, packets and cache line
+ * sized data buffers are created and freed the way a memory system
+ * does, with a fixed number of accesses in flight that are retired in
+ * a scrambled order.
+ */
+
+#include <cstdlib>
+
+#include "base/cprintf.hh"
+#include "base/time.hh"
+#include "mem/packet.hh"
+#include "mem/request.hh"
+#include "sim/eventq.hh"
+
+using namespace std;
+
+int
+main(int argc, char *argv[])
+{
+    uint64_t num_accesses =
+        argc > 1 ? strtoull(argv[1], NULL, 0) : 20000000;
+    const int max_in_flight = 64;
+
+    EventQueue queue("queue");
+    curEventQueue(&queue);
+
+    Packet *in_flight[max_in_flight] = {};
+
+    Time start, end;
+    start.setTimer();
+    for (uint64_t i = 0; i < num_accesses; ++i) {
+        Packet *&slot = in_flight[(i * 37) % max_in_flight];
+        if (slot) {
+            delete slot->req;
+            delete slot;
+        }
+
+        Request *req = new Request(i * 64, 64, 0, 0);
+        Packet *pkt = new Packet(req, MemCmd::ReadReq);
+        pkt->allocate();
+        pkt->getPtr<uint8_t>()[0] = i;
+        slot = pkt;
+    }
+    end.setTimer();
+
+    for (int i = 0; i < max_in_flight; ++i) {
+        if (in_flight[i]) {
+            delete in_flight[i]->req;
+            delete in_flight[i];
+        }
+    }
+
+    double secs = end - start;
+    cprintf("%d accesses in %.3fs, %.0f accesses/s\n", num_accesses, secs,
+            num_accesses / secs);
+
+    return 0;
+}
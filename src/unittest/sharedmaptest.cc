@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*
+ * Checks DecodeCache::SharedMap, searching it from several threads
+ * while another thread adds to it and grows its table. Build with
+ * ThreadSanitizer to also check the memory ordering.
+ */
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cpu/decode_cache.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+using UnitTest::setCase;
+
+namespace {
+
+typedef DecodeCache::SharedMap<uint64_t, uint64_t *> Map;
+
+const uint64_t numKeys = 200000;
+const int numReaders = 4;
+
+// Keys only differ in their upper bits, like the page addresses the
+// decode caches are searched by
+uint64_t key(uint64_t i) { return i << 12; }
+
+struct Shared
+{
+    Shared() : done(false), bad(0) {}
+
+    Map map;
+    vector<uint64_t *> values;
+    atomic<bool> done;
+    atomic<long> bad;
+};
+
+void
+readerLoop(Shared *shared)
+{
+    while (!shared->done.load()) {
+        for (uint64_t i = 0; i < numKeys; i += 37) {
+            uint64_t *value = shared->map.find(key(i));
+            if (value && *value != i)
+                ++shared->bad;
+        }
+    }
+}
+
+} // anonymous namespace
+
+int
+main()
+{
+    setCase("single thread");
+    {
+        Map map;
+        uint64_t values[100];
+        EXPECT_TRUE(map.find(0) == NULL);
+        for (uint64_t i = 0; i < 100; ++i)
+            map.insert(key(i), &values[i]);
+        EXPECT_EQ(map.size(), 100);
+
+        bool found = true;
+        for (uint64_t i = 0; i < 100; ++i)
+            found = found && map.find(key(i)) == &values[i];
+        EXPECT_TRUE(found);
+        EXPECT_TRUE(map.find(key(100)) == NULL);
+        EXPECT_TRUE(map.find(1) == NULL);
+    }
+
+    setCase("concurrent readers and a writer");
+    {
+        Shared shared;
+        for (uint64_t i = 0; i < numKeys; ++i)
+            shared.values.push_back(new uint64_t(i));
+
+        vector<thread *> readers;
+        for (int i = 0; i < numReaders; ++i)
+            readers.push_back(new thread(readerLoop, &shared));
+
+        // Writers are serialized by the caller, as in SharedInstMap
+        mutex lock;
+        for (uint64_t i = 0; i < numKeys; ++i) {
+            lock_guard<mutex> guard(lock);
+            if (!shared.map.find(key(i)))
+                shared.map.insert(key(i), shared.values[i]);
+        }
+
+        shared.done.store(true);
+        for (int i = 0; i < numReaders; ++i) {
+            readers[i]->join();
+            delete readers[i];
+        }
+        EXPECT_EQ(shared.bad.load(), 0);
+        EXPECT_EQ(shared.map.size(), numKeys);
+
+        bool found = true;
+        for (uint64_t i = 0; i < numKeys; ++i)
+            found = found && shared.map.find(key(i)) == shared.values[i];
+        EXPECT_TRUE(found);
+        EXPECT_TRUE(shared.map.find(12345) == NULL);
+
+        for (uint64_t i = 0; i < numKeys; ++i)
+            delete shared.values[i];
+    }
+
+    return UnitTest::printResults();
+}
@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Checks the tracking of which statistics changed since they were last
+ * dumped or reset: that only the updated stats are reported, that
+ * applying the incremental dumps one after the other gives the same
+ * values as full dumps, and that resetting only the changed stats
+ * leaves every stat as a full reset does.
+ */
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "base/stats/text.hh"
+#include "base/cprintf.hh"
+#include "base/misc.hh"
+#include "base/random.hh"
+#include "base/statistics.hh"
+#include "sim/core.hh"
+#include "sim/eventq.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+using namespace Stats;
+using UnitTest::setCase;
+
+namespace {
+
+struct StatGroup
+{
+    Scalar scalar;
+    Average average;
+    Vector vector;
+    Vector2d vector2d;
+    Distribution dist;
+    Histogram hist;
+    StandardDeviation stdev;
+    AverageDeviation avgdev;
+    VectorDistribution vdist;
+    SparseHistogram sparse;
+    Formula formula;
+
+    StatGroup(int id)
+    {
+        string prefix = csprintf("group%d.", id);
+
+        scalar.name(prefix + "scalar").desc("a scalar");
+        average.name(prefix + "average").desc("an average");
+        vector.init(8).name(prefix + "vector").desc("a vector");
+        vector2d.init(4, 4).name(prefix + "vector2d").desc("a 2d vector");
+        dist.init(0, 99, 10).name(prefix + "dist").desc("a distribution");
+        hist.init(10).name(prefix + "hist").desc("a histogram");
+        stdev.name(prefix + "stdev").desc("a standard deviation");
+        avgdev.name(prefix + "avgdev").desc("an average deviation");
+        vdist.init(4, 0, 99, 10).name(prefix + "vdist")
+            .desc("a vector distribution");
+        sparse.init(0).name(prefix + "sparse").desc("a sparse histogram");
+        formula.name(prefix + "formula").desc("a formula");
+        formula = scalar + sum(vector);
+    }
+
+    void
+    update(Random &rng)
+    {
+        int value = rng.random<int>(0, 99);
+
+        ++scalar;
+        average = value;
+        vector[value % 8]++;
+        vector2d[value % 4][value / 25]++;
+        dist.sample(value);
+        hist.sample(value);
+        stdev.sample(value);
+        avgdev.sample(value);
+        vdist[value % 4].sample(value);
+        sparse.sample(value % 16);
+    }
+};
+
+/** Text of a stat dump, by the name of the stat on every line. */
+typedef map<string, string> DumpLines;
+
+void
+parseDump(const string &text, DumpLines &lines)
+{
+    istringstream in(text);
+    string line;
+    while (getline(in, line)) {
+        if (line.empty() || line[0] == '-')
+            continue;
+        lines[line.substr(0, line.find(' '))] = line;
+    }
+}
+
+/** Dump all stats, or only the changed ones, and return the text. */
+string
+dumpStats(bool changed_only)
+{
+    ostringstream out;
+    Text text(out);
+
+    vector<Info *> stats;
+    list<Info *>::iterator i = statsList().begin();
+    for (; i != statsList().end(); ++i) {
+        if (!changed_only || (*i)->changed())
+            stats.push_back(*i);
+    }
+
+    for (int s = 0; s < stats.size(); ++s)
+        stats[s]->prepare();
+
+    text.begin();
+    for (int s = 0; s < stats.size(); ++s)
+        stats[s]->visit(text);
+    text.end();
+
+    return out.str();
+}
+
+void
+resetAll()
+{
+    list<Info *>::iterator i = statsList().begin();
+    for (; i != statsList().end(); ++i)
+        (*i)->reset();
+}
+
+bool
+changed(const string &name)
+{
+    list<Info *>::iterator i = statsList().begin();
+    for (; i != statsList().end(); ++i) {
+        if ((*i)->name == name)
+            return (*i)->changed();
+    }
+    panic("no stat named '%s'\n", name);
+}
+
+int
+countChanged()
+{
+    int changed = 0;
+    list<Info *>::iterator i = statsList().begin();
+    for (; i != statsList().end(); ++i)
+        changed += (*i)->changed();
+    return changed;
+}
+
+} // anonymous namespace
+
+int
+main()
+{
+    const int num_groups = 16;
+    const int num_intervals = 32;
+    const int stats_per_group = 11;
+    // Average and AverageDeviation move with time, so they always
+    // report a change
+    const int always_changed = 2 * num_groups;
+
+    EventQueue queue("test");
+    curEventQueue(&queue);
+
+    vector<StatGroup *> groups;
+    for (int g = 0; g < num_groups; ++g)
+        groups.push_back(new StatGroup(g));
+
+    list<Info *>::iterator i = statsList().begin();
+    for (; i != statsList().end(); ++i) {
+        EXPECT_TRUE((*i)->check() && (*i)->baseCheck());
+        (*i)->enable();
+    }
+
+    setCase("change tracking");
+    EXPECT_EQ(countChanged(), num_groups * stats_per_group);
+    resetAll();
+    markDumped();
+    EXPECT_EQ(countChanged(), always_changed);
+
+    ++groups[3]->scalar;
+    groups[5]->vdist[2].sample(7);
+    EXPECT_TRUE(changed("group3.scalar"));
+    EXPECT_TRUE(changed("group3.formula"));
+    EXPECT_FALSE(changed("group3.vector"));
+    EXPECT_TRUE(changed("group5.vdist"));
+    EXPECT_EQ(countChanged(), always_changed + 3);
+
+    // A reset only makes a stat differ from its last dump if the stat
+    // was changed since the last reset
+    markDumped();
+    resetChanged();
+    EXPECT_EQ(countChanged(), always_changed + 3);
+    markDumped();
+    resetChanged();
+    EXPECT_EQ(countChanged(), always_changed);
+
+    setCase("incremental dumps match full dumps");
+    Random rng(1);
+    DumpLines changed_lines;
+    resetAll();
+    parseDump(dumpStats(false), changed_lines);
+    markDumped();
+
+    for (int n = 0; n < num_intervals; ++n) {
+        queue.setCurTick(curTick() + 100000);
+
+        for (int u = 0; u < n % 4; ++u)
+            groups[rng.random<int>(0, num_groups - 1)]->update(rng);
+
+        parseDump(dumpStats(true), changed_lines);
+        DumpLines full_lines;
+        parseDump(dumpStats(false), full_lines);
+        markDumped();
+
+        int mismatches = 0;
+        DumpLines::const_iterator l = full_lines.begin();
+        for (; l != full_lines.end(); ++l)
+            mismatches += changed_lines[l->first] != l->second;
+        EXPECT_EQ(mismatches, 0);
+
+        // Resetting the changed stats must leave the same values as
+        // resetting all of them
+        resetChanged();
+        string after_changed = dumpStats(false);
+        resetAll();
+        EXPECT_TRUE(dumpStats(false) == after_changed);
+    }
+
+    for (int g = 0; g < num_groups; ++g)
+        delete groups[g];
+
+    return UnitTest::printResults();
+}
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2014 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Statistics dump and reset microbenchmark. Groups holding a stat of
+ * every type in base/statistics.hh are updated between periodic
+ * dumps, with only some of the groups touched in every interval, as
+ * when sampling a large system at a fine interval. Every interval is
+ * dumped to a text output and reset twice, once visiting every stat
+ * and once only visiting the stats that changed. That both give the
+ * same values is checked by statdumptest.
+ */
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "base/stats/text.hh"
+#include "base/cprintf.hh"
+#include "base/misc.hh"
+#include "base/random.hh"
+#include "base/statistics.hh"
+#include "base/time.hh"
+#include "sim/core.hh"
+#include "sim/eventq.hh"
+
+using namespace std;
+using namespace Stats;
+
+struct StatGroup
+{
+    Scalar scalar;
+    Average average;
+    Vector vector;
+    Vector2d vector2d;
+    Distribution dist;
+    Histogram hist;
+    StandardDeviation stdev;
+    AverageDeviation avgdev;
+    VectorDistribution vdist;
+    SparseHistogram sparse;
+    Formula formula;
+
+    StatGroup(int id)
+    {
+        string prefix = csprintf("group%d.", id);
+
+        scalar.name(prefix + "scalar").desc("a scalar");
+        average.name(prefix + "average").desc("an average");
+        vector.init(8).name(prefix + "vector").desc("a vector");
+        vector2d.init(4, 4).name(prefix + "vector2d").desc("a 2d vector");
+        dist.init(0, 99, 10).name(prefix + "dist").desc("a distribution");
+        hist.init(10).name(prefix + "hist").desc("a histogram");
+        stdev.name(prefix + "stdev").desc("a standard deviation");
+        avgdev.name(prefix + "avgdev").desc("an average deviation");
+        vdist.init(4, 0, 99, 10).name(prefix + "vdist")
+            .desc("a vector distribution");
+        sparse.init(0).name(prefix + "sparse").desc("a sparse histogram");
+        formula.name(prefix + "formula").desc("a formula");
+        formula = scalar + sum(vector);
+    }
+
+    void
+    update(Random &rng)
+    {
+        int value = rng.random<int>(0, 99);
+
+        ++scalar;
+        average = value;
+        vector[value % 8]++;
+        vector2d[value % 4][value / 25]++;
+        dist.sample(value);
+        hist.sample(value);
+        stdev.sample(value);
+        avgdev.sample(value);
+        vdist[value % 4].sample(value);
+        sparse.sample(value % 16);
+    }
+};
+
+void
+dumpStats(Output &output, bool changed_only)
+{
+    vector<Info *> stats;
+    list<Info *>::iterator i = statsList().begin();
+    for (; i != statsList().end(); ++i) {
+        if (!changed_only || (*i)->changed())
+            stats.push_back(*i);
+    }
+
+    for (int s = 0; s < stats.size(); ++s)
+        stats[s]->prepare();
+
+    output.begin();
+    for (int s = 0; s < stats.size(); ++s)
+        stats[s]->visit(output);
+    output.end();
+}
+
+void
+resetAll()
+{
+    list<Info *>::iterator i = statsList().begin();
+    for (; i != statsList().end(); ++i)
+        (*i)->reset();
+}
+
+int
+main(int argc, char *argv[])
+{
+    int num_groups = argc > 1 ? atoi(argv[1]) : 1000;
+    int num_intervals = argc > 2 ? atoi(argv[2]) : 10;
+
+    EventQueue queue("bench");
+    curEventQueue(&queue);
+
+    vector<StatGroup *> groups;
+    for (int g = 0; g < num_groups; ++g)
+        groups.push_back(new StatGroup(g));
+
+    list<Info *>::iterator i = statsList().begin();
+    for (; i != statsList().end(); ++i) {
+        if (!(*i)->check() || !(*i)->baseCheck())
+            panic("stat check failed for '%s'\n", (*i)->name);
+        (*i)->enable();
+    }
+
+    // Percentage of the groups updated in every interval
+    const int touched[] = { 1, 10, 100 };
+
+    for (int t = 0; t < sizeof(touched) / sizeof(touched[0]); ++t) {
+        Random rng(1);
+        ostringstream full_out, changed_out;
+        Text full_text(full_out), changed_text(changed_out);
+        double full_secs = 0, changed_secs = 0;
+        Time start, end;
+
+        resetAll();
+        markDumped();
+
+        for (int n = 0; n < num_intervals; ++n) {
+            queue.setCurTick(curTick() + 100000);
+
+            int updates = num_groups * touched[t] / 100;
+            for (int u = 0; u < updates; ++u)
+                groups[rng.random<int>(0, num_groups - 1)]->update(rng);
+
+            changed_out.str("");
+            start.setTimer();
+            dumpStats(changed_text, true);
+            end.setTimer();
+            changed_secs += end - start;
+
+            full_out.str("");
+            start.setTimer();
+            dumpStats(full_text, false);
+            end.setTimer();
+            full_secs += end - start;
+
+            markDumped();
+
+            start.setTimer();
+            resetChanged();
+            end.setTimer();
+            changed_secs += end - start;
+
+            start.setTimer();
+            resetAll();
+            end.setTimer();
+            full_secs += end - start;
+        }
+
+        cprintf("%3d%% of %d groups touched: full %.3fs, incremental "
+                "%.3fs per %d dumps and resets\n", touched[t], num_groups,
+                full_secs, changed_secs, num_intervals);
+    }
+
+    return 0;
+}
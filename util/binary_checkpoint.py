@@ -0,0 +1,205 @@
+# Copyright (c) 2014 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Reader and writer of binary checkpoints, see
+# src/sim/binary_checkpoint.hh for the layout of the file. A binary
+# checkpoint is read into a ConfigParser holding the text every entry
+# would have in an ini checkpoint, so that it can be handled exactly
+# like one. When writing it back, the entries whose text did not
+# change are written as they were read, and the others are converted
+# back to the type they had where possible. New entries are written
+# as strings, which gem5 parses like the values of an ini file.
+
+import ConfigParser
+import struct
+
+magic = "gem5bcpt"
+version = 1
+
+header = struct.Struct("=8sII")
+entry_header = struct.Struct("=BBHIQQ")
+index_entry = struct.Struct("=QQQ")
+trailer = struct.Struct("=QQ")
+
+type_names = [ "int8", "uint8", "int16", "uint16", "int32", "uint32",
+               "int64", "uint64", "bool", "float", "double", "string" ]
+type_codes = [ "b", "B", "h", "H", "i", "I", "q", "Q", "B", "f", "d", None ]
+Bool = type_names.index("bool")
+Float = type_names.index("float")
+Double = type_names.index("double")
+String = type_names.index("string")
+
+IsArray = 1
+
+class Entry(object):
+    def __init__(self, type, flags, count, data):
+        self.type = type
+        self.flags = flags
+        self.count = count
+        self.data = data
+
+    def values(self):
+        if self.type != String:
+            return struct.unpack("=%d%s" % (self.count, type_codes[self.type]),
+                                 self.data)
+
+        values = []
+        pos = 0
+        for i in xrange(self.count):
+            length, = struct.unpack_from("=I", self.data, pos)
+            pos += 4
+            values.append(self.data[pos:pos + length])
+            pos += length
+        return values
+
+    def text(self):
+        '''The values as gem5 writes them to an ini file.'''
+        if self.type == Bool:
+            return " ".join(v and "true" or "false" for v in self.values())
+        if self.type in (Float, Double):
+            return " ".join("%g" % v for v in self.values())
+        return " ".join(str(v) for v in self.values())
+
+def parse(text, type, flags):
+    '''Convert the text of an entry to an entry of the given type, or
+    return None if the text does not hold values of that type.'''
+    if type == String:
+        if flags & IsArray:
+            values = text.split()
+        else:
+            values = [ text ]
+        data = "".join(struct.pack("=I", len(v)) + v for v in values)
+        return Entry(type, flags, len(values), data)
+
+    values = []
+    try:
+        for token in text.split():
+            if type == Bool:
+                if token.lower() not in ("true", "false"):
+                    return None
+                values.append(token.lower() == "true")
+            elif type in (Float, Double):
+                values.append(float(token))
+            else:
+                values.append(int(token))
+        data = struct.pack("=%d%s" % (len(values), type_codes[type]), *values)
+    except (ValueError, struct.error):
+        return None
+
+    if len(values) != 1:
+        flags |= IsArray
+    return Entry(type, flags, len(values), data)
+
+def is_binary(path):
+    f = open(path, "rb")
+    start = f.read(len(magic))
+    f.close()
+    return start == magic
+
+def read(path, cpt=None):
+    '''Read a binary checkpoint. Returns a ConfigParser holding the
+    text of the entries and a dict mapping (section, name) to the
+    entries as they were read.'''
+    if cpt is None:
+        cpt = ConfigParser.RawConfigParser()
+        cpt.optionxform = str
+
+    f = open(path, "rb")
+    data = f.read()
+    f.close()
+
+    cpt_magic, cpt_version, reserved = header.unpack_from(data)
+    if cpt_magic != magic or cpt_version != version:
+        raise ValueError("%s is not a binary checkpoint of version %d" %
+                         (path, version))
+
+    index_offset, num_sections = \
+        trailer.unpack_from(data, len(data) - trailer.size)
+
+    entries = {}
+    pos = index_offset
+    for i in xrange(num_sections):
+        name_length, = struct.unpack_from("=H", data, pos)
+        pos += 2
+        section = data[pos:pos + name_length]
+        pos += name_length
+        offset, size, num_entries = index_entry.unpack_from(data, pos)
+        pos += index_entry.size
+
+        if not cpt.has_section(section):
+            cpt.add_section(section)
+
+        end = offset + size
+        while offset < end:
+            type, flags, name_length, reserved, count, size = \
+                entry_header.unpack_from(data, offset)
+            offset += entry_header.size
+            name = data[offset:offset + name_length]
+            offset += name_length
+            entry = Entry(type, flags, count, data[offset:offset + size])
+            offset += size
+
+            # bypass the interpolation checks of SafeConfigParser
+            ConfigParser.RawConfigParser.set(cpt, section, name, entry.text())
+            entries[(section, name)] = entry
+
+    return cpt, entries
+
+def write(path, cpt, entries={}):
+    '''Write a ConfigParser as a binary checkpoint, see read() for
+    entries.'''
+    body = [ header.pack(magic, version, 0) ]
+    offset = header.size
+    index = []
+
+    for section in cpt.sections():
+        start = offset
+        num_entries = 0
+        for name in cpt.options(section):
+            text = ConfigParser.RawConfigParser.get(cpt, section, name)
+            entry = entries.get((section, name), None)
+            if entry is None or entry.text() != text:
+                if entry is not None:
+                    entry = parse(text, entry.type, entry.flags)
+                if entry is None:
+                    entry = parse(text, String, 0)
+
+            body.append(entry_header.pack(entry.type, entry.flags, len(name),
+                                          0, entry.count, len(entry.data)))
+            body.append(name)
+            body.append(entry.data)
+            offset += entry_header.size + len(name) + len(entry.data)
+            num_entries += 1
+
+        index.append(struct.pack("=H", len(section)) + section +
+                     index_entry.pack(start, offset - start, num_entries))
+
+    body.extend(index)
+    body.append(trailer.pack(offset, len(index)))
+
+    f = open(path, "wb")
+    f.write("".join(body))
+    f.close()
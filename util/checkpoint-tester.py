@@ -89,7 +89,8 @@ cmd_echo = open(os.path.join(top_dir, 'command'), 'w')
 print >>cmd_echo, ' '.join(sys.argv)
 cmd_echo.close()
 
-m5_binary = args[0]
+# write ini checkpoints, so that the differences are readable
+m5_binary = [ args[0], '--checkpoint-format=ini' ]
 
 options = args[1:]
 
@@ -98,7 +99,7 @@ initial_args = ['--take-checkpoints', '%d,%d' % (interval, interval)]
 cptdir = os.path.join(top_dir, 'm5out')
 
 print '===> Running initial simulation.'
-subprocess.call([m5_binary] + ['-red', cptdir] + options + initial_args)
+subprocess.call(m5_binary + ['-red', cptdir] + options + initial_args)
 
 dirs = os.listdir(cptdir)
 expr = re.compile('cpt\.([0-9]*)')
@@ -117,7 +118,7 @@ cpts.sort()
 for i in range(1, len(cpts)):
     print '===> Running test %d of %d.' % (i, len(cpts)-1)
     mydir = os.path.join(top_dir, 'test.%d' % i)
-    subprocess.call([m5_binary] + ['-red', mydir] + options + initial_args +
+    subprocess.call(m5_binary + ['-red', mydir] + options + initial_args +
                     ['--max-checkpoints' , '1', '--checkpoint-dir', cptdir,
                      '--checkpoint-restore', str(i)])
     cpt_name = 'cpt.%d' % cpts[i]
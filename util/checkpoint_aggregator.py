@@ -31,9 +31,13 @@
 
 from ConfigParser import ConfigParser
 import gzip
+import struct
+import zlib
 
 import sys, re, os
 
+import binary_checkpoint
+
 class myCP(ConfigParser):
     def __init__(self):
         ConfigParser.__init__(self)
@@ -41,6 +45,98 @@ class myCP(ConfigParser):
     def optionxform(self, optionstr):
         return optionstr
 
+class SparseImage(object):
+    '''Sequential reader of a sparse memory image, which only holds
+    the non-zero pages of a store. See PhysicalMemory::unserializeStore()
+    for the layout of the file.'''
+
+    header = struct.Struct("=8sIIQQ")
+
+    def __init__(self, f):
+        self.f = f
+        magic, version, self.page_size, self.range_size, num_pages = \
+            self.header.unpack(f.read(self.header.size))
+        if magic != "gem5pmem" or version != 1:
+            raise ValueError("not a sparse memory image")
+
+        index = struct.unpack("=%dQ" % num_pages, f.read(8 * num_pages))
+        self.pages = dict((page, i) for (i, page) in enumerate(index))
+        index_end = self.header.size + 8 * num_pages
+        self.data_offset = -(-index_end // self.page_size) * self.page_size
+        self.pos = 0
+
+    def read(self, size):
+        data = []
+        end = min(self.pos + size, self.range_size)
+        while self.pos < end:
+            page, offset = divmod(self.pos, self.page_size)
+            length = min(self.page_size - offset, end - self.pos)
+            if page in self.pages:
+                self.f.seek(self.data_offset +
+                            self.pages[page] * self.page_size + offset)
+                data.append(self.f.read(length))
+            else:
+                data.append("\0" * length)
+            self.pos += length
+        return "".join(data)
+
+    def close(self):
+        pass
+
+class ChunkedImage(object):
+    '''Sequential reader of a chunked memory image, made of
+    independently compressed chunks. See src/base/chunked_image.hh
+    for the layout of the file.'''
+
+    header = struct.Struct("=8sIIQQQ")
+
+    def __init__(self, f):
+        self.f = f
+        magic, version, self.chunk_size, self.size, num_chunks, \
+            index_offset = self.header.unpack(f.read(self.header.size))
+        if magic != "gem5zchk" or version != 1:
+            raise ValueError("not a chunked image")
+
+        f.seek(index_offset)
+        index = struct.unpack("=%dQ" % (2 * num_chunks),
+                              f.read(16 * num_chunks))
+        self.chunks = zip(index[0::2], index[1::2])
+        self.pos = 0
+        self.chunk = None
+        self.data = ""
+
+    def read(self, size):
+        data = []
+        end = min(self.pos + size, self.size)
+        while self.pos < end:
+            chunk, offset = divmod(self.pos, self.chunk_size)
+            if chunk != self.chunk:
+                chunk_offset, stored = self.chunks[chunk]
+                if stored:
+                    self.f.seek(chunk_offset)
+                    self.data = zlib.decompress(self.f.read(stored))
+                else:
+                    start = chunk * self.chunk_size
+                    self.data = "\0" * min(self.chunk_size, self.size - start)
+                self.chunk = chunk
+            length = min(len(self.data) - offset, end - self.pos)
+            data.append(self.data[offset:offset + length])
+            self.pos += length
+        return "".join(data)
+
+    def close(self):
+        pass
+
+def open_image(f, config, section):
+    format = "gzip"
+    if config.has_option(section, "format"):
+        format = config.get(section, "format")
+    if format == "sparse":
+        return SparseImage(f)
+    if format == "chunked":
+        return ChunkedImage(f)
+    return gzip.GzipFile(fileobj=f, mode="rb")
+
 def aggregate(output_dir, cpts, no_compress, memory_size):
     merged_config = None
     page_ptr = 0
@@ -62,7 +158,11 @@ def aggregate(output_dir, cpts, no_compress, memory_size):
         print arg
         merged_config = myCP()
         config = myCP()
-        config.readfp(open(cpts[i] + "/m5.cpt"))
+        cpt_file = cpts[i] + "/m5.cpt"
+        if binary_checkpoint.is_binary(cpt_file):
+            binary_checkpoint.read(cpt_file, config)
+        else:
+            config.readfp(open(cpt_file))
 
         for sec in config.sections():
             if re.compile("cpu").search(sec):
@@ -100,7 +200,7 @@ def aggregate(output_dir, cpts, no_compress, memory_size):
         print "pages to be read: ", pages
 
         f = open(cpts[i] + "/system.physmem.store0.pmem", "rb")
-        gf = gzip.GzipFile(fileobj=f, mode="rb")
+        gf = open_image(f, config, "system.physmem.store0")
 
         x = 0
         while x < pages:
@@ -132,6 +232,7 @@ def aggregate(output_dir, cpts, no_compress, memory_size):
     print "Make sure the simulation using this checkpoint has at least ",
     print page_ptr, "x 4K of memory"
     merged_config.set("system.physmem.store0", "range_size", page_ptr * 4 * 1024)
+    merged_config.set("system.physmem.store0", "format", "gzip")
 
     merged_config.add_section("Globals")
     merged_config.set("Globals", "curTick", max_curtick)
@@ -56,11 +56,18 @@
 # file. As these operations can be isa specific the method can verify the isa
 # and use regexes to find the correct sections that need to be updated.
 
+# Both ini and binary checkpoints are handled, the latter being read
+# into the same ConfigParser object, and are written back in the format
+# they were in. The --format option converts a checkpoint to the other
+# format, whether or not it needs any migration.
+
 
 import ConfigParser
 import sys, os
 import os.path as osp
 
+import binary_checkpoint
+
 # An example of a translator
 def from_0(cpt):
     if cpt.get('root','isa') == 'arm':
@@ -583,9 +590,16 @@ def process_file(path, **kwargs):
     cpt.optionxform = str
 
     # Read the current data
-    cpt_file = file(path, 'r')
-    cpt.readfp(cpt_file)
-    cpt_file.close()
+    binary = binary_checkpoint.is_binary(path)
+    if binary:
+        cpt, entries = binary_checkpoint.read(path, cpt)
+    else:
+        cpt_file = file(path, 'r')
+        cpt.readfp(cpt_file)
+        cpt_file.close()
+
+    format = kwargs.get('format', None) or (binary and 'binary' or 'ini')
+    converting = format != (binary and 'binary' or 'ini')
 
     # Make sure we know what we're starting from
     if not cpt.has_option('root','cpt_ver'):
@@ -600,7 +614,7 @@ def process_file(path, **kwargs):
 
     verboseprint("\t...file is at version %#x" % cpt_ver)
 
-    if cpt_ver == len(migrations):
+    if cpt_ver == len(migrations) and not converting:
         verboseprint("\t...nothing to do")
         return
 
@@ -612,7 +626,12 @@ def process_file(path, **kwargs):
 
     # Write the old data back
     verboseprint("\t...completed")
-    cpt.write(file(path, 'w'))
+    if format == 'binary':
+        verboseprint("\t...writing a binary checkpoint")
+        binary_checkpoint.write(path, cpt, binary and entries or {})
+    else:
+        verboseprint("\t...writing an ini checkpoint")
+        cpt.write(file(path, 'w'))
 
 if __name__ == '__main__':
     from optparse import OptionParser
@@ -625,6 +644,9 @@ if __name__ == '__main__':
                       help="Do no backup each checkpoint before modifying it")
     parser.add_option("-v", "--verbose", action="store_true",
                       help="Print out debugging information as")
+    parser.add_option("-f", "--format", choices=["binary", "ini"],
+                      help="Write the checkpoints as binary or ini files, "\
+                           "rather than in the format they are in")
 
     (options, args) = parser.parse_args()
     if len(args) != 1: